@@ -0,0 +1,237 @@
+/*
+ Benchmark + conferência: envelhecimento da fila (anti-inanição).
+
+ Simulação de eventos discretos com relógio virtual (PatientQueue.clock):
+ dias movimentados de 12 h com chegadas Poisson (20% prioridade 1, 30% 2,
+ 50% 3), médicos com atendimento exponencial e carga perto de 100%; depois
+ do expediente só se atende quem ficou. A mesma sequência de chegadas e
+ atendimentos roda com a ordem estrita e com limites de espera por nível, e
+ a tabela mostra p50/p90/p99/máx da espera (minutos) por prioridade.
+
+ Conferência: a cada dequeue com envelhecimento, o escolhido é comparado
+ com uma varredura da fila inteira (o atrasado de prazo mais antigo, ou o
+ primeiro na ordem estrita). No fim, o máximo da prioridade 3 tem de cair.
+ Desfazer: um atrasado promovido, atendido e devolvido pelo undo, volta com
+ a chegada original e é promovido de novo no dequeue seguinte.
+ Também mede o custo do dequeue com a política ligada (relógio real).
+
+ Uso: make bench_aging && ./bench_aging [dias]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+
+#define NS_PER_MIN 60000000000ull
+#define DOCTORS    3
+#define SERVICE_MIN 12.0   /* média do atendimento */
+#define LOAD       0.98    /* chegadas / capacidade no expediente */
+#define DAY_MIN    (12 * 60)
+
+static uint64_t sim_now;
+static uint64_t sim_clock(void) { return sim_now; }
+
+static unsigned long long rng_state;
+
+static double uniform(void) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (double)(rng_state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint64_t exp_ns(double mean_min) {
+    return (uint64_t)(-log(1.0 - uniform()) * mean_min * (double)NS_PER_MIN);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Referência O(n): o que dequeue deveria escolher agora */
+static const Patient* reference_next(const PatientQueue* q) {
+    const QueueNode* best = NULL;
+    uint64_t best_deadline = UINT64_MAX;
+    for (const QueueNode* n = queue_first(q); n; n = queue_next(q, n)) {
+        uint64_t limit = q->aging.max_wait_ns[n->level];
+        if (!limit) continue;
+        uint64_t deadline = n->enqueued_ns + limit;
+        if (deadline <= sim_now && deadline < best_deadline) {
+            best = n;
+            best_deadline = deadline;
+        }
+    }
+    if (!best) best = queue_first(q);
+    return best ? best->patient : NULL;
+}
+
+/* Roda a simulação; devolve 0 se a escolha divergir da referência. */
+static int simulate(PatientQueue* q, const uint64_t* max_wait, Patient* registry,
+                    size_t cap, int days, size_t* served_out) {
+    init_queue(q);
+    q->clock = sim_clock;
+    queue_set_aging(q, max_wait);
+    rng_state = 0x9E3779B97F4A7C15ull; /* mesma sequência nas duas políticas */
+    sim_now = 0;
+    queue_stats_reset(q);
+
+    double arrival_mean = SERVICE_MIN / DOCTORS / LOAD;
+    size_t next_id = 0, served = 0;
+    for (int d = 0; d < days; d++) {
+        uint64_t open = (uint64_t)d * 24 * 60 * NS_PER_MIN;
+        uint64_t close = open + (uint64_t)DAY_MIN * NS_PER_MIN;
+        uint64_t free_at[DOCTORS];
+        for (int k = 0; k < DOCTORS; k++) free_at[k] = open;
+        uint64_t t_arr = open + exp_ns(arrival_mean);
+        sim_now = open;
+
+        for (;;) {
+            int s = 0;
+            for (int k = 1; k < DOCTORS; k++) if (free_at[k] < free_at[s]) s = k;
+            int arrivals_left = t_arr < close && next_id < cap;
+            if (arrivals_left && (t_arr <= free_at[s] || is_queue_empty(q))) {
+                sim_now = t_arr;
+                Patient* p = &registry[next_id++];
+                double r = uniform();
+                p->priority = r < 0.2 ? 1 : r < 0.5 ? 2 : 3;
+                if (!enqueue(q, p)) return 0;
+                t_arr += exp_ns(arrival_mean);
+                continue;
+            }
+            if (is_queue_empty(q)) break;
+            if (free_at[s] > sim_now) sim_now = free_at[s];
+            const Patient* want = q->aging.mask ? reference_next(q) : queue_first(q)->patient;
+            if (dequeue(q) != want) {
+                fprintf(stderr, "FALHA: escolha diferente da referência (dia %d)\n", d);
+                return 0;
+            }
+            served++;
+            free_at[s] = sim_now + exp_ns(SERVICE_MIN);
+        }
+    }
+    *served_out = served;
+    return 1;
+}
+
+/* Atende (como clinic_dequeue) e desfaz: o próximo tem de ser o mesmo */
+static int check_undo(void) {
+    static Patient ps[3];
+    for (int i = 0; i < 3; i++) {
+        ps[i].id = i + 1;
+        ps[i].priority = i ? 1 : 3; /* ps[0] espera na prioridade 3 */
+        snprintf(ps[i].cpf, sizeof ps[i].cpf, "%011d", i + 1);
+    }
+    const uint64_t limit[QUEUE_LEVELS] = { 0, 0, 60 * NS_PER_MIN };
+    PatientQueue q;
+    HistoryStack hist;
+    init_queue(&q);
+    q.clock = sim_clock;
+    queue_set_aging(&q, limit);
+    init_history_stack(&hist);
+
+    int ok = 1;
+    sim_now = 10 * NS_PER_MIN; /* chegada 0 = desconhecida (enqueue_front_at) */
+    ok = ok && enqueue(&q, &ps[0]);
+    sim_now += 90 * NS_PER_MIN; /* ps[0] passou do limite; chegam dois de prioridade 1 */
+    ok = ok && enqueue(&q, &ps[1]) && enqueue(&q, &ps[2]);
+
+    uint64_t arrived;
+    const Patient* p = dequeue_timed(&q, &arrived);
+    ok = ok && p == &ps[0] && arrived == 10 * NS_PER_MIN;
+    HistoryRecord rec = make_history_record(p);
+    rec.enqueued_ns = arrived;
+    ok = ok && push_history(&hist, rec);
+    sim_now += NS_PER_MIN;
+    ok = ok && undo_last_service(&hist, &q, NULL) == UNDO_OK;
+    ok = ok && queue_find_cpf(&q, ps[0].cpf)->enqueued_ns == arrived && dequeue(&q) == &ps[0];
+
+    free_queue(&q);
+    free_history(&hist);
+    if (!ok) fputs("FALHA: undo perdeu a chegada (sem promoção no dequeue seguinte)\n", stderr);
+    return ok;
+}
+
+static void report(const char* name, const PatientQueue* q) {
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        const LatencyHist* h = &q->stats.wait[lv];
+        printf("%-14s %4d %8llu %8llu %9.1f %9.1f %9.1f %9.1f\n", name, lv + 1,
+               (unsigned long long)h->total, (unsigned long long)q->stats.promoted[lv],
+               (double)latency_hist_percentile(h, 0.50) / NS_PER_MIN,
+               (double)latency_hist_percentile(h, 0.90) / NS_PER_MIN,
+               (double)latency_hist_percentile(h, 0.99) / NS_PER_MIN,
+               (double)h->max / NS_PER_MIN);
+    }
+}
+
+int main(int argc, char** argv) {
+    int days = argc > 1 ? atoi(argv[1]) : 60;
+    if (days < 1) days = 1;
+    size_t cap = (size_t)days * (size_t)(DAY_MIN / (SERVICE_MIN / DOCTORS / LOAD) * 1.5) + 1000;
+    Patient* registry = calloc(cap, sizeof *registry);
+    if (!registry) return 2;
+    for (size_t i = 0; i < cap; i++) {
+        registry[i].id = (int)i + 1;
+        snprintf(registry[i].cpf, sizeof registry[i].cpf, "%011u", (unsigned)(i + 1));
+    }
+
+    /* Limites (minutos) 30/60/90. Sem limite na prioridade 1, os atrasados
+       de baixo passariam sempre na frente dela perto de 100% de carga. */
+    const uint64_t aged[QUEUE_LEVELS] = { 30 * NS_PER_MIN, 60 * NS_PER_MIN, 90 * NS_PER_MIN };
+    static PatientQueue strict_q, aged_q;
+    size_t served_strict, served_aged;
+    if (!simulate(&strict_q, NULL, registry, cap, days, &served_strict) ||
+        !simulate(&aged_q, aged, registry, cap, days, &served_aged))
+        return 1;
+    if (served_strict != served_aged) { fputs("FALHA: atendidos diferentes\n", stderr); return 1; }
+
+    printf("%d dias, %d médicos, carga %.2f, %zu atendimentos; limites:", days, DOCTORS, LOAD, served_strict);
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++)
+        printf(" p%d %llu min", lv + 1, (unsigned long long)(aged[lv] / NS_PER_MIN));
+    printf("\n\n");
+    printf("%-14s %4s %8s %8s %9s %9s %9s %9s\n", "política", "prio", "atend.", "promov.",
+           "p50 min", "p90 min", "p99 min", "máx min");
+    report("estrita", &strict_q);
+    report("envelhecida", &aged_q);
+
+    if (aged_q.stats.wait[2].max >= strict_q.stats.wait[2].max) {
+        fputs("FALHA: envelhecimento não reduziu a espera máxima da prioridade 3\n", stderr);
+        return 1;
+    }
+    free_queue(&strict_q);
+    free_queue(&aged_q);
+    if (!check_undo()) return 1;
+
+    /* Custo do dequeue (relógio real): estrito x com limites em todos os níveis */
+    const size_t n = 1000000;
+    Patient* many = realloc(registry, n * sizeof *many);
+    if (!many) { free(registry); return 2; }
+    registry = many;
+    for (size_t i = 0; i < n; i++) {
+        memset(&registry[i], 0, sizeof registry[i]);
+        registry[i].id = (int)i + 1;
+        registry[i].priority = (int)(i % QUEUE_LEVELS) + 1;
+        snprintf(registry[i].cpf, sizeof registry[i].cpf, "%011u", (unsigned)(i + 1));
+    }
+    const uint64_t all[QUEUE_LEVELS] = { NS_PER_MIN, NS_PER_MIN, NS_PER_MIN };
+    double cost[2];
+    for (int pass = 0; pass < 2; pass++) {
+        PatientQueue* q = pass ? &aged_q : &strict_q;
+        init_queue(q);
+        queue_set_aging(q, pass ? all : NULL);
+        for (size_t i = 0; i < n; i++)
+            if (!enqueue(q, &registry[i])) return 2;
+        double t0 = now_sec();
+        for (size_t i = 0; i < n; i++) dequeue(q);
+        cost[pass] = (now_sec() - t0) * 1e9 / (double)n;
+        free_queue(q);
+    }
+    printf("\ndequeue: estrito %.1f ns, com envelhecimento %.1f ns (n = %zu)\n", cost[0], cost[1], n);
+
+    free(registry);
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ Benchmark: alocações da lista, fila e histórico (1M operações).
+
+ Mesma carga executada duas vezes:
+   - "malloc": um malloc/free por Node, QueueNode, cópia de Patient e
+     HistoryNode com o registro antigo (Patient copiado + timestamp texto);
+   - "slab":   as estruturas reais (PatientList e PatientQueue usando os pools
+     de slab_pool, a fila só com handles para o cadastro; HistoryStack em
+     anel com registros compactos).
+
+ Ciclo de 4 operações, repetido até 1M:
+   insert_patient, enqueue, dequeue + push_history, pop_history (ciclos pares)
+   ou enqueue (ciclos ímpares).
+
+ Uso: make bench_alloc && ./bench_alloc
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+
+#define OPS 1000000u
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void fill_patient(Patient* p, size_t i) {
+    memset(p, 0, sizeof *p);
+    p->id = (int)i + 1;
+    snprintf(p->name, sizeof p->name, "Paciente %zu", i);
+    snprintf(p->cpf, sizeof p->cpf, "%011zu", i);
+    p->age = (int)(i % 90);
+    p->gender = (i & 1) ? 'M' : 'F';
+    p->priority = (int)(i % 3) + 1;
+}
+
+/* ---- Contabilidade do modo "malloc" ---- */
+static size_t m_calls, m_bytes, m_live, m_peak;
+
+static void* counted_malloc(size_t n) {
+    m_calls++;
+    m_bytes += n;
+    m_live += n;
+    if (m_live > m_peak) m_peak = m_live;
+    return malloc(n);
+}
+
+static void counted_free(void* p, size_t n) {
+    if (!p) return;
+    m_live -= n;
+    free(p);
+}
+
+/* Réplica mínima das estruturas antigas (um malloc por elemento). */
+typedef struct LNode { Patient data; struct LNode* next; } LNode;
+typedef struct QNode { Patient* patient; struct QNode* next; } QNode;
+typedef struct {
+    char timestamp[20]; HistoryAction action; Patient patient;
+} LegacyHistoryRecord;
+typedef struct HNode { LegacyHistoryRecord data; struct HNode* next; } HNode;
+
+static double run_malloc(void) {
+    LNode* list = NULL;
+    QNode* qfront = NULL; QNode* qrear = NULL;
+    HNode* hist = NULL;
+    Patient p;
+
+    double t0 = now_sec();
+    for (size_t i = 0, cycle = 0; i < OPS; cycle++) {
+        fill_patient(&p, cycle);
+
+        LNode* ln = counted_malloc(sizeof *ln);           /* insert */
+        ln->data = p; ln->next = list; list = ln;
+        i++;
+
+        for (int k = 0; k < ((cycle & 1) ? 2 : 1) && i < OPS; k++, i++) { /* enqueue */
+            QNode* qn = counted_malloc(sizeof *qn);
+            qn->patient = counted_malloc(sizeof(Patient));
+            *qn->patient = p; qn->next = NULL;
+            if (qrear) qrear->next = qn; else qfront = qn;
+            qrear = qn;
+        }
+
+        if (qfront && i < OPS) {                           /* dequeue + push */
+            QNode* qn = qfront;
+            qfront = qn->next; if (!qfront) qrear = NULL;
+            HNode* hn = counted_malloc(sizeof *hn);
+            strcpy(hn->data.timestamp, "2024-01-01 00:00");
+            hn->data.action = QUEUE_OUT;
+            hn->data.patient = *qn->patient;
+            hn->next = hist; hist = hn;
+            counted_free(qn->patient, sizeof(Patient));
+            counted_free(qn, sizeof *qn);
+            i++;
+        }
+
+        if (!(cycle & 1) && hist && i < OPS) {             /* pop */
+            HNode* hn = hist; hist = hn->next;
+            counted_free(hn, sizeof *hn);
+            i++;
+        }
+    }
+    while (list) { LNode* n = list->next; counted_free(list, sizeof *list); list = n; }
+    while (qfront) {
+        QNode* n = qfront->next;
+        counted_free(qfront->patient, sizeof(Patient));
+        counted_free(qfront, sizeof *qfront);
+        qfront = n;
+    }
+    while (hist) { HNode* n = hist->next; counted_free(hist, sizeof *hist); hist = n; }
+    return now_sec() - t0;
+}
+
+static double run_slab(size_t* calls, size_t* bytes) {
+    PatientList list; PatientQueue queue; HistoryStack hist;
+    init_patient_list(&list);
+    init_queue(&queue);
+    init_history_stack(&hist);
+    Patient p;
+
+    double t0 = now_sec();
+    for (size_t i = 0, cycle = 0; i < OPS; cycle++) {
+        fill_patient(&p, cycle);
+        insert_patient(&list, &p);
+        i++;
+
+        for (int k = 0; k < ((cycle & 1) ? 2 : 1) && i < OPS; k++, i++)
+            enqueue(&queue, &list.head->data); /* handle do inserido (cabeça) */
+
+        if (!is_queue_empty(&queue) && i < OPS) {
+            push_history(&hist, make_history_record(dequeue(&queue)));
+            i++;
+        }
+
+        if (!(cycle & 1) && hist.size && i < OPS) {
+            pop_history(&hist, NULL);
+            i++;
+        }
+    }
+
+    const SlabPool* pools[] = {
+        &list.node_pool, &queue.node_pool
+    };
+    *calls = 0; *bytes = 0;
+    for (size_t k = 0; k < sizeof pools / sizeof pools[0]; k++) {
+        *calls += pools[k]->slab_count;
+        *bytes += pools[k]->bytes_reserved;
+    }
+    /* Histórico: um único vetor que dobra a partir de 64 registros */
+    for (size_t c = hist.cap; c >= 64; c >>= 1) (*calls)++;
+    *bytes += hist.cap * sizeof(HistoryRecord);
+    free_list(&list);
+    free_queue(&queue);
+    free_history(&hist);
+    return now_sec() - t0;
+}
+
+int main(void) {
+    double t_malloc = run_malloc();
+    size_t s_calls, s_bytes;
+    double t_slab = run_slab(&s_calls, &s_bytes);
+
+    printf("Carga: %u operações (lista + fila + histórico)\n", OPS);
+    printf("%-8s %14s %16s %16s %10s\n", "modo", "mallocs", "bytes pedidos", "pico vivo", "tempo (s)");
+    printf("%-8s %14zu %16zu %16zu %10.3f\n", "malloc", m_calls, m_bytes, m_peak, t_malloc);
+    printf("%-8s %14zu %16zu %16zu %10.3f\n", "slab", s_calls, s_bytes, s_bytes, t_slab);
+    /* O tempo do modo slab inclui também o índice de CPF da PatientList;
+       o vetor do índice não entra na contagem de mallocs acima. */
+    return 0;
+}
@@ -0,0 +1,381 @@
+/*
+ Benchmark + conferência: API da libclinic (lib/clinic.h) x estruturas diretas.
+
+ Mesma carga nos dois caminhos: cadastra N pacientes, coloca todos na
+ fila, atende metade e desfaz um quarto desses atendimentos. "direto" chama
+ patient_normalize/patient_check, insert_patient, enqueue, dequeue +
+ push_history e undo_last_service como os controllers faziam; "clinic_*"
+ passa pelo handle (sem WAL). Mostra ns/op de cada fase e o custo do handle.
+
+ Conferência:
+   - os dois caminhos terminam com a mesma fila, na mesma ordem;
+   - cada erro devolve o clinic_status esperado (duplicado, inválido, fora
+     do cadastro, fora da fila, fila e histórico vazios);
+   - dois handles não compartilham estado;
+   - com WAL, um handle novo reconstrói o mesmo estado no replay;
+   - WAL gravado por outro processo: o undo depois do replay devolve o
+     paciente com chegada do relógio deste processo (não a do outro);
+   - snapshot ilegível: clinic_create recusa sem tocar no WAL nem no
+     arquivo; O com checkpoint falhando responde CLINIC_ERR_IO e o que vem
+     depois não entra no WAL antigo (a partida seguinte volta ao estado
+     anterior ao O).
+
+ Uso: make bench_clinic && ./bench_clinic [pacientes] [arquivo wal]
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+#include "lib/clinic.h"
+
+enum { PH_REGISTER, PH_ENQUEUE, PH_DEQUEUE, PH_UNDO, PHASES };
+static const char* const phase_name[PHASES] = { "cadastro", "fila", "atender", "desfazer" };
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* CPF válido (dígitos verificadores corretos) derivado de key */
+static void make_cpf(char out[15], size_t key) {
+    int d[11];
+    size_t base = 100000000u + key % 900000000u;
+    for (int i = 8; i >= 0; i--) { d[i] = (int)(base % 10); base /= 10; }
+    for (int k = 9; k <= 10; k++) {
+        int sum = 0;
+        for (int i = 0; i < k; i++) sum += d[i] * (k + 1 - i);
+        d[k] = sum * 10 % 11 % 10;
+    }
+    for (int i = 0; i < 11; i++) out[i] = (char)('0' + d[i]);
+    out[11] = '\0';
+}
+
+static void build(Patient* ps, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        Patient* p = &ps[i];
+        memset(p, 0, sizeof *p);
+        p->id = (int)i + 1;
+        snprintf(p->name, sizeof p->name, "Paciente %zu", i);
+        make_cpf(p->cpf, i * 7919);
+        p->age = (int)(i % 90);
+        p->gender = (i & 1) ? 'm' : 'f';
+        snprintf(p->condition, sizeof p->condition, "consulta %zu", i % 7);
+        p->priority = (int)(i % QUEUE_LEVELS) + 1;
+    }
+}
+
+/* ---------- caminho direto ---------- */
+
+static int run_direct(const Patient* ps, size_t n, double secs[PHASES], int* order) {
+    PatientList list;
+    PatientQueue queue;
+    HistoryStack history;
+    init_patient_list(&list);
+    init_queue(&queue);
+    init_history_stack(&history); // sem limite: todo atendimento pode ser desfeito
+
+    double t = now_sec();
+    for (size_t i = 0; i < n; i++) {
+        Patient p = ps[i];
+        patient_normalize(&p);
+        if (patient_check(&p) != PATIENT_OK || !insert_patient(&list, &p)) return 0;
+    }
+    secs[PH_REGISTER] = now_sec() - t;
+
+    t = now_sec();
+    for (size_t i = 0; i < n; i++) {
+        const Patient* p = search_patient_by_CPF(&list, ps[i].cpf);
+        if (!p || !enqueue(&queue, p)) return 0;
+    }
+    secs[PH_ENQUEUE] = now_sec() - t;
+
+    t = now_sec();
+    for (size_t i = 0; i < n / 2; i++) {
+        uint64_t arrived;
+        const Patient* p = dequeue_timed(&queue, &arrived);
+        if (!p) return 0;
+        HistoryRecord rec = make_history_record(p);
+        rec.level = (unsigned char)p->priority;
+        rec.enqueued_ns = arrived;
+        push_history(&history, rec);
+    }
+    secs[PH_DEQUEUE] = now_sec() - t;
+
+    t = now_sec();
+    HistoryRecord rec;
+    for (size_t i = 0; i < n / 4; i++)
+        if (undo_last_service(&history, &queue, &rec) != UNDO_OK) return 0;
+    secs[PH_UNDO] = now_sec() - t;
+
+    size_t k = 0;
+    for (const QueueNode* node = queue_first(&queue); node; node = queue_next(&queue, node))
+        order[k++] = node->patient->id;
+
+    free_list(&list);
+    free_queue(&queue);
+    free_history(&history);
+    return 1;
+}
+
+/* ---------- caminho clinic_* ---------- */
+
+typedef struct {
+    const int* expected;
+    size_t at;
+    int ok;
+} OrderCheck;
+
+static int check_order(void* user, const Patient* p) {
+    OrderCheck* c = user;
+    if (c->expected[c->at++] != p->id) c->ok = 0;
+    return c->ok;
+}
+
+static int run_clinic(clinic_ctx* c, const Patient* ps, size_t n, double secs[PHASES]) {
+    double t = now_sec();
+    for (size_t i = 0; i < n; i++)
+        if (clinic_register(c, &ps[i], NULL, NULL) != CLINIC_OK) return 0;
+    secs[PH_REGISTER] = now_sec() - t;
+
+    t = now_sec();
+    for (size_t i = 0; i < n; i++)
+        if (clinic_enqueue(c, ps[i].cpf, NULL) != CLINIC_OK) return 0;
+    secs[PH_ENQUEUE] = now_sec() - t;
+
+    t = now_sec();
+    const Patient* p;
+    for (size_t i = 0; i < n / 2; i++)
+        if (clinic_dequeue(c, &p) != CLINIC_OK) return 0;
+    secs[PH_DEQUEUE] = now_sec() - t;
+
+    t = now_sec();
+    for (size_t i = 0; i < n / 4; i++)
+        if (clinic_undo(c, NULL) != CLINIC_OK) return 0;
+    secs[PH_UNDO] = now_sec() - t;
+    return 1;
+}
+
+/* ---------- conferência dos status ---------- */
+
+#define EXPECT(cond, what) do { if (!(cond)) { fprintf(stderr, "FALHA: %s\n", what); return 0; } } while (0)
+
+static int check_status(const Patient* ps) {
+    clinic_ctx *a, *b;
+    EXPECT(clinic_create(NULL, &a) == CLINIC_OK && clinic_create(NULL, &b) == CLINIC_OK, "clinic_create");
+
+    const Patient* out;
+    HistoryRecord rec;
+    EXPECT(clinic_dequeue(a, &out) == CLINIC_ERR_QUEUE_EMPTY, "fila vazia");
+    EXPECT(clinic_undo(a, &rec) == CLINIC_ERR_HISTORY_EMPTY, "histórico vazio");
+    EXPECT(clinic_register(a, &ps[0], &out, NULL) == CLINIC_OK && out->gender == 'F', "cadastro normalizado");
+    EXPECT(clinic_register(a, &ps[0], NULL, NULL) == CLINIC_ERR_DUPLICATE, "CPF duplicado");
+
+    Patient bad = ps[1];
+    bad.id = ps[0].id;
+    EXPECT(clinic_register(a, &bad, NULL, NULL) == CLINIC_ERR_DUPLICATE, "id duplicado");
+    PatientError why = PATIENT_OK;
+    bad = ps[1];
+    bad.cpf[10] = bad.cpf[10] == '9' ? '0' : (char)(bad.cpf[10] + 1);
+    EXPECT(clinic_register(a, &bad, NULL, &why) == CLINIC_ERR_INVALID && why == PATIENT_ERR_CPF_CHECK,
+           "CPF com DV errado");
+
+    EXPECT(clinic_enqueue(a, ps[1].cpf, NULL) == CLINIC_ERR_NOT_FOUND, "enqueue fora do cadastro");
+    EXPECT(clinic_cancel(a, ps[0].cpf, NULL) == CLINIC_ERR_NOT_QUEUED, "cancel fora da fila");
+    EXPECT(clinic_enqueue(a, ps[0].cpf, NULL) == CLINIC_OK && clinic_position(a, ps[0].cpf) == 1, "posição");
+    EXPECT(clinic_save(a, NULL, NULL) == CLINIC_ERR_ARG, "save sem snapshot");
+
+    /* Handles independentes */
+    EXPECT(clinic_find_cpf(b, ps[0].cpf) == NULL && clinic_queue(b)->size == 0, "handles independentes");
+    EXPECT(clinic_register(b, &ps[0], NULL, NULL) == CLINIC_OK, "mesmo paciente no outro handle");
+
+    clinic_destroy(a);
+    clinic_destroy(b);
+    return 1;
+}
+
+/* Replay: o que um handle com WAL fez, um handle novo reconstrói. */
+static int check_wal(const Patient* ps, size_t n, const char* wal_path) {
+    remove(wal_path);
+    clinic_options opt = clinic_default_options();
+    opt.persistence.wal_path = wal_path;
+    opt.history_max = 0;
+    clinic_ctx* c;
+    double secs[PHASES];
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK, "clinic_create com WAL");
+    EXPECT(run_clinic(c, ps, n, secs), "carga com WAL");
+    const Patient* p;
+    EXPECT(clinic_cancel(c, ps[n - 1].cpf, &p) == CLINIC_OK, "cancel com WAL");
+    size_t patients = clinic_patients(c)->size, queued = clinic_queue(c)->size;
+    size_t served = clinic_history(c)->size;
+    int* order = malloc(queued * sizeof *order);
+    EXPECT(order, "memória");
+    size_t k = 0;
+    for (const QueueNode* node = queue_first(clinic_queue(c)); node; node = queue_next(clinic_queue(c), node))
+        order[k++] = node->patient->id;
+    clinic_destroy(c);
+
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK, "replay do WAL");
+    EXPECT(clinic_persistence(c)->report.wal_applied > 0, "WAL reaplicado");
+    EXPECT(clinic_patients(c)->size == patients && clinic_queue(c)->size == queued &&
+           clinic_history(c)->size == served, "tamanhos após o replay");
+    OrderCheck chk = { order, 0, 1 };
+    EXPECT(clinic_each_queued(c, check_order, &chk) == queued && chk.ok, "fila após o replay");
+    clinic_destroy(c);
+    free(order);
+    remove(wal_path);
+    return 1;
+}
+
+/* Processo que grava: prioridade 3 entra e é atendida, prioridade 1 entra */
+static int write_served(const clinic_options* opt, const Patient* low, const Patient* high) {
+    clinic_ctx* c;
+    const Patient* p;
+    if (clinic_create(opt, &c) != CLINIC_OK) return 0;
+    int ok = clinic_register(c, low, NULL, NULL) == CLINIC_OK &&
+             clinic_register(c, high, NULL, NULL) == CLINIC_OK &&
+             clinic_enqueue(c, low->cpf, NULL) == CLINIC_OK &&
+             clinic_dequeue(c, &p) == CLINIC_OK &&
+             clinic_enqueue(c, high->cpf, NULL) == CLINIC_OK;
+    clinic_destroy(c);
+    return ok;
+}
+
+/* Replay em outro processo e undo: a chegada é a deste processo (agora),
+   então o limite de espera não promove o paciente de volta na hora. */
+static int check_wal_undo(const Patient* ps, const char* wal_path) {
+    Patient low = ps[2], high = ps[0];
+    low.priority = 3;
+    high.priority = 1;
+    remove(wal_path);
+    clinic_options opt = clinic_default_options();
+    opt.persistence.wal_path = wal_path;
+    opt.max_wait_ns[2] = 60ull * 1000000000ull; /* 1 min na prioridade 3 */
+#if !defined(_WIN32)
+    pid_t pid = fork();
+    EXPECT(pid >= 0, "fork");
+    if (pid == 0) _exit(write_served(&opt, &low, &high) ? 0 : 1);
+    int wstatus;
+    EXPECT(waitpid(pid, &wstatus, 0) == pid && WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0,
+           "WAL gravado pelo outro processo");
+#else
+    EXPECT(write_served(&opt, &low, &high), "WAL gravado");
+#endif
+    uint64_t before = latency_now_ns();
+    clinic_ctx* c;
+    HistoryRecord rec;
+    const Patient* p;
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK, "replay do WAL de outro processo");
+    EXPECT(clinic_undo(c, &rec) == CLINIC_OK, "undo depois do replay");
+    const QueueNode* node = queue_find_cpf(clinic_queue(c), low.cpf);
+    EXPECT(node && node->enqueued_ns >= before, "chegada do relógio deste processo");
+    EXPECT(clinic_dequeue(c, &p) == CLINIC_OK && strcmp(p->cpf, high.cpf) == 0,
+           "desfeito não promovido na hora");
+    clinic_destroy(c);
+    remove(wal_path);
+    return 1;
+}
+
+/* Partida e O que não podem seguir sem estragar snapshot ou WAL. */
+static int check_refuse(const Patient* ps, const char* wal_path) {
+    char snap[512], good[512];
+    snprintf(snap, sizeof snap, "%s.snap", wal_path);
+    snprintf(good, sizeof good, "%s.good.snap", wal_path);
+    remove(wal_path);
+    clinic_options opt = clinic_default_options();
+    opt.persistence.wal_path = wal_path;
+    clinic_ctx* c;
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK &&
+           clinic_register(c, &ps[0], NULL, NULL) == CLINIC_OK, "WAL com um cadastro");
+    clinic_destroy(c);
+
+    /* Snapshot que existe e não carrega: nada de replay num estado vazio */
+    FILE* f = fopen(snap, "wb");
+    EXPECT(f && fputs("lixo", f) >= 0 && fclose(f) == 0, "snapshot ilegível");
+    opt.persistence.snapshot_path = snap;
+    EXPECT(clinic_create(&opt, &c) == CLINIC_ERR_SNAPSHOT && c, "partida recusada");
+    EXPECT(clinic_patients(c)->size == 0 && clinic_persistence(c)->report.wal_applied == 0,
+           "WAL não reaplicado");
+    clinic_destroy(c);
+    char buf[8] = { 0 };
+    f = fopen(snap, "rb");
+    EXPECT(f && fread(buf, 1, sizeof buf, f) == 4 && strcmp(buf, "lixo") == 0 && fclose(f) == 0,
+           "snapshot intacto");
+    remove(snap);
+
+    /* Checkpoint do O impossível (diretório não existe) */
+    EXPECT(clinic_create(NULL, &c) == CLINIC_OK && clinic_register(c, &ps[1], NULL, NULL) == CLINIC_OK &&
+           clinic_save(c, good, NULL) == CLINIC_OK, "snapshot para o O");
+    clinic_destroy(c);
+    snprintf(snap, sizeof snap, "%s.sem-diretorio/x.snap", wal_path);
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK && clinic_find_cpf(c, ps[0].cpf), "partida sem snapshot");
+    EXPECT(clinic_load(c, good, NULL) == CLINIC_ERR_IO && clinic_find_cpf(c, ps[1].cpf), "O sem checkpoint");
+    EXPECT(clinic_register(c, &ps[3], NULL, NULL) == CLINIC_ERR_IO, "WAL recusa depois do O");
+    clinic_destroy(c);
+    EXPECT(clinic_create(&opt, &c) == CLINIC_OK && clinic_find_cpf(c, ps[0].cpf) &&
+           !clinic_find_cpf(c, ps[1].cpf) && !clinic_find_cpf(c, ps[3].cpf), "estado anterior ao O");
+    clinic_destroy(c);
+    remove(good);
+    remove(wal_path);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 200000;
+    const char* wal_path = argc > 2 ? argv[2] : "bench_clinic.wal";
+    if (n < 100) n = 100;
+
+    Patient* ps = malloc(n * sizeof *ps);
+    int* order = malloc(n * sizeof *order);
+    if (!ps || !order) return 2;
+    build(ps, n);
+
+    if (!check_status(ps)) return 1;
+
+    double direct[PHASES], api[PHASES];
+    if (!run_direct(ps, n, direct, order)) {
+        fprintf(stderr, "FALHA: caminho direto\n");
+        return 1;
+    }
+    clinic_options opt = clinic_default_options();
+    opt.history_max = 0;
+    clinic_ctx* c;
+    if (clinic_create(&opt, &c) != CLINIC_OK || !run_clinic(c, ps, n, api)) {
+        fprintf(stderr, "FALHA: caminho clinic_*\n");
+        return 1;
+    }
+    OrderCheck chk = { order, 0, 1 };
+    size_t queued = clinic_queue(c)->size;
+    if (clinic_each_queued(c, check_order, &chk) != queued || !chk.ok || queued != n - n / 2 + n / 4) {
+        fprintf(stderr, "FALHA: fila do handle difere do caminho direto\n");
+        return 1;
+    }
+    clinic_destroy(c);
+
+    if (!check_wal(ps, n < 20000 ? n : 20000, wal_path)) return 1;
+    if (!check_wal_undo(ps, wal_path)) return 1;
+    if (!check_refuse(ps, wal_path)) return 1;
+
+    printf("%zu pacientes (atender n/2, desfazer n/4)\n\n", n);
+    printf("%-10s %12s %12s %9s\n", "fase", "direto ns", "clinic ns", "custo");
+    const size_t ops[PHASES] = { n, n, n / 2, n / 4 };
+    for (int ph = 0; ph < PHASES; ph++) {
+        double d = direct[ph] * 1e9 / (double)ops[ph];
+        double a = api[ph] * 1e9 / (double)ops[ph];
+        printf("%-10s %12.1f %12.1f %8.1f%%\n", phase_name[ph], d, a, d > 0 ? (a / d - 1.0) * 100.0 : 0.0);
+    }
+
+    free(ps);
+    free(order);
+    puts("conferência: OK");
+    return 0;
+}
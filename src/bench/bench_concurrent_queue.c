@@ -0,0 +1,221 @@
+/*
+ Benchmark + conferência: fila concorrente (vários balcões e médicos).
+
+ 1) Ordem (1 thread): 4000 chegadas com prioridades sorteadas saem
+    agrupadas por prioridade e, dentro dela, na ordem de chegada.
+ 2) Carga: P balcões e C médicos (P = C = 1, 2, 4, 8, 16) passam N pacientes
+    pela fila. Compara a ConcurrentQueue com a PatientQueue atrás de um
+    mutex: pacientes/s e latência chegada -> atendimento (p50/p99/p99.9/máx).
+    Confere que cada paciente sai uma vez só e que, para cada médico, os
+    pacientes de um mesmo balcão e prioridade saem na ordem de chegada.
+
+ Uso: make bench_concurrent_queue && ./bench_concurrent_queue [N]
+*/
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "ds/concurrent_queue.h"
+#include "util/latency_hist.h"
+
+#define MAX_THREADS 16
+
+typedef enum { MODE_CQ, MODE_MUTEX } Mode;
+
+typedef struct {
+    Mode mode;
+    ConcurrentQueue cq;
+    PatientQueue locked;             // MODE_MUTEX
+    pthread_mutex_t mu;
+    Patient* registry;
+    size_t n;
+    unsigned producers;
+    atomic_size_t consumed;
+    atomic_uchar* seen;              // vezes que cada paciente saiu
+    atomic_int failed;
+} Bench;
+
+typedef struct {
+    Bench* b;
+    unsigned index;
+    LatencyHist hist;
+    long last_seq[MAX_THREADS][QUEUE_LEVELS]; // por balcão e nível
+} Worker;
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x853C49E6748FEA9Bull;
+
+static unsigned rnd(void) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state >> 32);
+}
+
+/* ---------- operações nos dois modos ---------- */
+
+static int put(Bench* b, const Patient* p) {
+    if (b->mode == MODE_CQ) return cq_enqueue(&b->cq, p);
+    pthread_mutex_lock(&b->mu);
+    int ok = enqueue(&b->locked, p);
+    pthread_mutex_unlock(&b->mu);
+    return ok;
+}
+
+static const Patient* take(Bench* b, uint64_t* enqueued_ns) {
+    if (b->mode == MODE_CQ) return cq_dequeue(&b->cq, enqueued_ns);
+    pthread_mutex_lock(&b->mu);
+    const QueueNode* first = queue_first(&b->locked);
+    const Patient* p = NULL;
+    if (first) {
+        *enqueued_ns = first->enqueued_ns;
+        p = dequeue(&b->locked);
+    }
+    pthread_mutex_unlock(&b->mu);
+    return p;
+}
+
+/* ---------- threads ---------- */
+
+static void* producer(void* arg) {
+    Worker* w = arg;
+    Bench* b = w->b;
+    for (size_t i = w->index; i < b->n; i += b->producers)
+        while (!put(b, &b->registry[i])) sched_yield(); // cheio: espera os médicos
+    return NULL;
+}
+
+static void* consumer(void* arg) {
+    Worker* w = arg;
+    Bench* b = w->b;
+    for (;;) {
+        uint64_t t0;
+        const Patient* p = take(b, &t0);
+        if (!p) {
+            if (atomic_load(&b->consumed) >= b->n) break;
+            sched_yield();
+            continue;
+        }
+        latency_hist_record(&w->hist, latency_now_ns() - t0);
+        size_t i = (size_t)p->id - 1;
+        if (atomic_fetch_add(&b->seen[i], 1) != 0) atomic_store(&b->failed, 1);
+        long seq = (long)(i / b->producers);
+        long* last = &w->last_seq[i % b->producers][p->priority - 1];
+        if (seq <= *last) atomic_store(&b->failed, 1);
+        *last = seq;
+        atomic_fetch_add(&b->consumed, 1);
+    }
+    return NULL;
+}
+
+static int run(Bench* b, Mode mode, unsigned threads, LatencyHist* all, double* secs) {
+    b->mode = mode;
+    b->producers = threads;
+    atomic_store(&b->consumed, 0);
+    atomic_store(&b->failed, 0);
+    for (size_t i = 0; i < b->n; i++) atomic_store(&b->seen[i], 0);
+    if (mode == MODE_CQ) {
+        if (!cq_init(&b->cq, 0, 0)) return 0;
+    } else {
+        init_queue(&b->locked);
+    }
+
+    static Worker prod[MAX_THREADS], cons[MAX_THREADS];
+    pthread_t tp[MAX_THREADS], tc[MAX_THREADS];
+    for (unsigned i = 0; i < threads; i++) {
+        prod[i].b = cons[i].b = b;
+        prod[i].index = cons[i].index = i;
+        latency_hist_reset(&cons[i].hist);
+        for (unsigned k = 0; k < MAX_THREADS; k++)
+            for (int lv = 0; lv < QUEUE_LEVELS; lv++) cons[i].last_seq[k][lv] = -1;
+    }
+    double t0 = now_sec();
+    for (unsigned i = 0; i < threads; i++) {
+        pthread_create(&tc[i], NULL, consumer, &cons[i]);
+        pthread_create(&tp[i], NULL, producer, &prod[i]);
+    }
+    for (unsigned i = 0; i < threads; i++) pthread_join(tp[i], NULL);
+    for (unsigned i = 0; i < threads; i++) pthread_join(tc[i], NULL);
+    *secs = now_sec() - t0;
+
+    latency_hist_reset(all);
+    for (unsigned i = 0; i < threads; i++) latency_hist_merge(all, &cons[i].hist);
+    if (mode == MODE_CQ) cq_destroy(&b->cq);
+    else                 free_queue(&b->locked);
+    return !atomic_load(&b->failed) && all->total == b->n;
+}
+
+/* Com uma thread a saída é exatamente (prioridade, ordem de chegada). */
+static int check_order(Patient* registry, size_t n) {
+    ConcurrentQueue cq;
+    if (!cq_init(&cq, n, 0)) return 0;
+    for (size_t i = 0; i < n; i++)
+        if (!cq_enqueue(&cq, &registry[i])) return 0;
+    int last_prio = 0, last_id = 0, ok = 1;
+    size_t out = 0;
+    for (const Patient* p; (p = cq_dequeue(&cq, NULL)) != NULL; out++) {
+        if (p->priority < last_prio || (p->priority == last_prio && p->id <= last_id)) ok = 0;
+        last_prio = p->priority;
+        last_id = p->id;
+    }
+    uint64_t arrivals = 0;
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) arrivals += cq.backlog.stats.arrivals[lv];
+    cq_destroy(&cq);
+    return ok && out == n && arrivals == n;
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 400000;
+    if (n < 4000) n = 4000;
+    Bench b;
+    b.n = n;
+    b.registry = calloc(n, sizeof *b.registry);
+    b.seen = malloc(n * sizeof *b.seen);
+    if (!b.registry || !b.seen) return 2;
+    for (size_t i = 0; i < n; i++) {
+        b.registry[i].id = (int)i + 1;
+        b.registry[i].priority = (int)(rnd() % QUEUE_LEVELS) + 1;
+        snprintf(b.registry[i].cpf, sizeof b.registry[i].cpf, "%011u", (unsigned)(i + 1));
+    }
+    pthread_mutex_init(&b.mu, NULL);
+
+    if (!check_order(b.registry, 4000)) { fputs("FALHA: ordem com uma thread\n", stderr); return 1; }
+    puts("ordem (1 thread): OK\n");
+
+    printf("%-10s %7s %14s %10s %10s %10s %10s\n", "fila", "P = C", "pacientes/s",
+           "p50 µs", "p99 µs", "p99.9 µs", "máx µs");
+    static LatencyHist all;
+    for (unsigned threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        for (int m = 0; m < 2; m++) {
+            double secs;
+            if (!run(&b, m ? MODE_MUTEX : MODE_CQ, threads, &all, &secs)) {
+                fprintf(stderr, "FALHA: %s com %u threads (perdido, repetido ou fora de ordem)\n",
+                        m ? "mutex" : "concorrente", threads);
+                return 1;
+            }
+            printf("%-10s %7u %14.0f %10.1f %10.1f %10.1f %10.1f\n", m ? "mutex" : "concorrente",
+                   threads, (double)n / secs,
+                   (double)latency_hist_percentile(&all, 0.50) / 1e3,
+                   (double)latency_hist_percentile(&all, 0.99) / 1e3,
+                   (double)latency_hist_percentile(&all, 0.999) / 1e3,
+                   (double)all.max / 1e3);
+        }
+    }
+
+    pthread_mutex_destroy(&b.mu);
+    free(b.registry);
+    free(b.seen);
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ Benchmark + conferência: cadastro com leitura sem lock (RCU/épocas).
+
+ R leitores (R = 1, 2, 4, 8, 16) fazem buscas por CPF sorteadas durante um
+ tempo fixo e, a cada 1024 buscas, listam uma página de 64 linhas. Um
+ escritor roda junto, com ritmo fixo (uma escrita a cada ~50 µs):
+   - ConcurrentRegistry: alterna insert de pacientes novos e update de
+     pacientes existentes;
+   - PatientList atrás de um pthread_rwlock: só insert (a lista não tem
+     update), com o lock de escrita.
+ Saída: buscas/s somando os leitores e o ganho sobre 1 leitor.
+
+ Conferências:
+   - toda busca de um CPF da carga inicial acha o paciente;
+   - leitura rasgada: o update grava a mesma versão em age e nos 4
+     primeiros bytes de condition; o leitor confere que batem;
+   - no fim, a listagem completa tem size linhas e, sem leitores, o lixo
+     das épocas é todo liberado.
+
+ Com 1 CPU os leitores se revezam no mesmo núcleo e o ganho fica perto de
+ 1x nos dois modos; a diferença aparece em máquinas com vários núcleos.
+
+ Uso: make bench_concurrent_registry && ./bench_concurrent_registry [N] [ms]
+*/
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include "ds/concurrent_registry.h"
+#include "ds/patient_list.h"
+
+#define MAX_READERS 16
+#define PAGE_EVERY 1024
+#define PAGE_LINES 64
+
+typedef enum { MODE_CREG, MODE_RWLOCK } Mode;
+
+typedef struct {
+    Mode mode;
+    ConcurrentRegistry reg;
+    PatientList list;                // MODE_RWLOCK
+    pthread_rwlock_t rw;
+    char (*cpfs)[15];                // n carga inicial + extra para inserts
+    size_t n, extra;
+    size_t next_insert;
+    atomic_int stop;
+    atomic_int failed;
+    int null_fd;
+} Bench;
+
+typedef struct {
+    Bench* b;
+    unsigned seed;
+    unsigned long long lookups;
+} Reader;
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned rnd(unsigned* s) {
+    *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+    return *s;
+}
+
+static void make_patient(Patient* p, const Bench* b, size_t i, int version) {
+    memset(p, 0, sizeof *p);
+    p->id = (int)i + 1;
+    snprintf(p->name, sizeof p->name, "Paciente %zu", i);
+    memcpy(p->cpf, b->cpfs[i], sizeof p->cpf);
+    p->age = version;
+    memcpy(p->condition, &version, sizeof version);
+    p->gender = 'F';
+    p->priority = (int)(i % 3) + 1;
+}
+
+/* ---------- leitores ---------- */
+
+static int consistent(const Patient* p) {
+    int v;
+    memcpy(&v, p->condition, sizeof v);
+    return v == p->age;
+}
+
+static void* reader(void* arg) {
+    Reader* r = arg;
+    Bench* b = r->b;
+    OutBuffer out;
+    if (!out_open(&out, b->null_fd, 1u << 16)) { atomic_store(&b->failed, 1); return NULL; }
+    CregReader* slot = b->mode == MODE_CREG ? creg_reader_join(&b->reg) : NULL;
+    if (b->mode == MODE_CREG && !slot) { atomic_store(&b->failed, 1); out_close(&out); return NULL; }
+
+    unsigned long long count = 0;
+    while (!atomic_load_explicit(&b->stop, memory_order_relaxed)) {
+        const char* cpf = b->cpfs[rnd(&r->seed) % b->n];
+        int ok;
+        if (b->mode == MODE_CREG) {
+            creg_enter(&b->reg, slot);
+            const Patient* p = creg_find_cpf(&b->reg, cpf);
+            ok = p && consistent(p);
+            if (++count % PAGE_EVERY == 0) creg_print_page(&b->reg, &out, 0, PAGE_LINES);
+            creg_exit(slot);
+        } else {
+            pthread_rwlock_rdlock(&b->rw);
+            const Patient* p = search_patient_by_CPF(&b->list, cpf);
+            ok = p && consistent(p);
+            if (++count % PAGE_EVERY == 0) print_patient_page(&b->list, &out, 0, PAGE_LINES);
+            pthread_rwlock_unlock(&b->rw);
+        }
+        if (!ok) atomic_store(&b->failed, 1);
+        if (count % PAGE_EVERY == 0) out_flush(&out);
+    }
+    r->lookups = count;
+    if (slot) creg_reader_leave(slot);
+    out_close(&out);
+    return NULL;
+}
+
+/* ---------- escritor ---------- */
+
+static void* writer(void* arg) {
+    Bench* b = arg;
+    struct timespec pause = { 0, 50000 };
+    unsigned seed = 0x2545F491u;
+    int version = 1;
+    Patient p;
+    for (unsigned long ops = 0; !atomic_load(&b->stop); ops++) {
+        if (b->mode == MODE_CREG && (ops & 1)) {
+            make_patient(&p, b, rnd(&seed) % b->n, ++version);
+            if (!creg_update(&b->reg, &p)) atomic_store(&b->failed, 1);
+        } else if (b->next_insert < b->n + b->extra) {
+            make_patient(&p, b, b->next_insert++, 0);
+            int ok;
+            if (b->mode == MODE_CREG) {
+                ok = creg_insert(&b->reg, &p);
+            } else {
+                pthread_rwlock_wrlock(&b->rw);
+                ok = insert_patient(&b->list, &p);
+                pthread_rwlock_unlock(&b->rw);
+            }
+            if (!ok) atomic_store(&b->failed, 1);
+        }
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+/* ---------- rodada ---------- */
+
+static int load(Bench* b, Mode mode) {
+    Patient p;
+    b->mode = mode;
+    b->next_insert = b->n;
+    if (mode == MODE_CREG) {
+        if (!creg_init(&b->reg)) return 0;
+        for (size_t i = 0; i < b->n; i++) {
+            make_patient(&p, b, i, 0);
+            if (!creg_insert(&b->reg, &p)) return 0;
+        }
+    } else {
+        init_patient_list(&b->list);
+        if (!reserve_patient_list(&b->list, b->n + b->extra)) return 0;
+        for (size_t i = 0; i < b->n; i++) {
+            make_patient(&p, b, i, 0);
+            if (!insert_patient(&b->list, &p)) return 0;
+        }
+    }
+    return 1;
+}
+
+static double run(Bench* b, unsigned readers, double secs) {
+    static Reader rs[MAX_READERS];
+    pthread_t tr[MAX_READERS], tw;
+    atomic_store(&b->stop, 0);
+    for (unsigned i = 0; i < readers; i++) {
+        rs[i].b = b;
+        rs[i].seed = 0x9E3779B9u * (i + 1);
+        rs[i].lookups = 0;
+    }
+    pthread_create(&tw, NULL, writer, b);
+    for (unsigned i = 0; i < readers; i++) pthread_create(&tr[i], NULL, reader, &rs[i]);
+    struct timespec span = { (time_t)secs, (long)((secs - (double)(time_t)secs) * 1e9) };
+    double t0 = now_sec();
+    nanosleep(&span, NULL);
+    atomic_store(&b->stop, 1);
+    for (unsigned i = 0; i < readers; i++) pthread_join(tr[i], NULL);
+    double elapsed = now_sec() - t0;
+    pthread_join(tw, NULL);
+    unsigned long long total = 0;
+    for (unsigned i = 0; i < readers; i++) total += rs[i].lookups;
+    return (double)total / elapsed;
+}
+
+/* Listagem completa = size linhas; sem leitores, o lixo sai em 2 épocas. */
+static int check_final(Bench* b) {
+    OutBuffer out;
+    if (!out_open(&out, b->null_fd, 0)) return 0;
+    CregReader* slot = creg_reader_join(&b->reg);
+    if (!slot) { out_close(&out); return 0; }
+    creg_enter(&b->reg, slot);
+    size_t lines = creg_print_page(&b->reg, &out, 0, OUT_ALL);
+    creg_exit(slot);
+    creg_reader_leave(slot);
+    out_close(&out);
+    size_t left = 0;
+    for (int i = 0; i < 3; i++) left = creg_reclaim(&b->reg);
+    return lines == atomic_load(&b->reg.size) && lines == b->next_insert && left == 0;
+}
+
+int main(int argc, char** argv) {
+    Bench b;
+    b.n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000;
+    double secs = (argc > 2 ? (double)strtoul(argv[2], NULL, 10) : 500.0) / 1e3;
+    if (b.n < 1000) b.n = 1000;
+    b.extra = 200000;
+    b.cpfs = malloc((b.n + b.extra) * sizeof *b.cpfs);
+    b.null_fd = open("/dev/null", O_WRONLY);
+    if (!b.cpfs || b.null_fd < 0) return 2;
+    for (size_t i = 0; i < b.n + b.extra; i++)
+        snprintf(b.cpfs[i], sizeof b.cpfs[i], "%011u", (unsigned)(i * 7919u % 1000000007u + 1));
+    pthread_rwlock_init(&b.rw, NULL);
+
+    printf("%zu pacientes, %.0f ms por rodada, escritor a cada ~50 µs\n\n", b.n, secs * 1e3);
+    printf("%-10s %8s %14s %8s\n", "cadastro", "leitores", "buscas/s", "ganho");
+    for (int m = 0; m < 2; m++) {
+        Mode mode = m ? MODE_RWLOCK : MODE_CREG;
+        const char* name = m ? "rwlock" : "rcu";
+        double base = 0;
+        for (unsigned readers = 1; readers <= MAX_READERS; readers *= 2) {
+            if (!load(&b, mode)) { fputs("FALHA: carga (sem memória)\n", stderr); return 2; }
+            atomic_store(&b.failed, 0);
+            double rate = run(&b, readers, secs);
+            int ok = !atomic_load(&b.failed) && (mode == MODE_RWLOCK || check_final(&b));
+            if (mode == MODE_CREG) creg_destroy(&b.reg);
+            else                   free_list(&b.list);
+            if (!ok) {
+                fprintf(stderr, "FALHA: %s com %u leitores (busca perdida ou leitura rasgada)\n",
+                        name, readers);
+                return 1;
+            }
+            if (readers == 1) base = rate;
+            printf("%-10s %8u %14.0f %7.2fx\n", name, readers, rate, rate / base);
+        }
+    }
+
+    pthread_rwlock_destroy(&b.rw);
+    close(b.null_fd);
+    free(b.cpfs);
+    puts("\nconferência: OK");
+    return 0;
+}
@@ -0,0 +1,179 @@
+/*
+ Benchmark + conferência: CPF compacto de 64 bits e o núcleo SIMD.
+
+ Mede, para cada nível do núcleo (escalar, SSE2, AVX2 — os que a CPU tiver):
+   - varredura linear de um vetor de chaves compactas (cpf_key_scan),
+     em chaves comparadas por ns, x strcmp sobre char[15] (o formato antigo);
+   - busca no índice da PatientList (search_patient_by_CPF) com 10^6 pacientes.
+ Mede também cpf_canonicalize (texto com e sem pontuação) e confere CPFs
+ válidos/inválidos conhecidos e que todos os níveis dão a mesma resposta.
+
+ Uso: make bench_cpf && ./bench_cpf
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "ds/cpf_scan.h"
+#include "model/cpf.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static size_t rnd(size_t n) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (size_t)(rng_state % n);
+}
+
+/* CPF válido derivado de i ("ddd.ddd.ddd-dd" ou só dígitos) */
+static void make_cpf(char out[15], size_t i, int punct) {
+    int d[11];
+    size_t base = 100000000u + i % 900000000u;
+    for (int k = 8; k >= 0; k--) { d[k] = (int)(base % 10); base /= 10; }
+    for (int k = 9; k <= 10; k++) {
+        int sum = 0;
+        for (int j = 0; j < k; j++) sum += d[j] * (k + 1 - j);
+        d[k] = sum * 10 % 11 % 10;
+    }
+    size_t n = 0;
+    for (int k = 0; k < 11; k++) {
+        if (punct && (k == 3 || k == 6)) out[n++] = '.';
+        if (punct && k == 9) out[n++] = '-';
+        out[n++] = (char)('0' + d[k]);
+    }
+    out[n] = '\0';
+}
+
+static int check_known(void) {
+    static const struct { const char* cpf; CpfStatus st; } cases[] = {
+        {"529.982.247-25", CPF_OK},      {"52998224725", CPF_OK},
+        {" 111.444.777-35 ", CPF_OK},    {"111.444.777-36", CPF_ERR_CHECK},
+        {"111.111.111-11", CPF_ERR_CHECK}, {"000.000.000-00", CPF_ERR_CHECK},
+        {"1234567890", CPF_ERR_FORMAT},  {"529.982.247-2a", CPF_ERR_FORMAT},
+        {"", CPF_ERR_FORMAT},            {"529982247250", CPF_ERR_FORMAT},
+    };
+    for (size_t i = 0; i < sizeof cases / sizeof cases[0]; i++) {
+        uint64_t k = 0;
+        if (cpf_canonicalize(cases[i].cpf, &k) != cases[i].st) {
+            fprintf(stderr, "FALHA: cpf_canonicalize(\"%s\")\n", cases[i].cpf);
+            return 0;
+        }
+    }
+    uint64_t a, b;
+    char back[CPF_KEY_CAP];
+    if (cpf_canonicalize("529.982.247-25", &a) || cpf_canonicalize("52998224725", &b) || a != b) {
+        fputs("FALHA: formatos diferentes deram chaves diferentes\n", stderr);
+        return 0;
+    }
+    cpf_unpack_key(a, back);
+    if (strcmp(back, "52998224725") != 0) { fputs("FALHA: cpf_unpack_key\n", stderr); return 0; }
+    return 1;
+}
+
+int main(void) {
+    if (!check_known()) return 1;
+    const CpfScanLevel best = cpf_scan_level();
+    printf("núcleo disponível: %s\n\n", cpf_scan_level_name(best));
+
+    /* Canonicalização */
+    const size_t ncanon = 1000000;
+    char (*texts)[15] = malloc(ncanon * sizeof *texts);
+    if (!texts) return 2;
+    for (size_t i = 0; i < ncanon; i++) make_cpf(texts[i], i * 7919, (int)(i & 1));
+    volatile uint64_t sink = 0;
+    double t0 = now_sec();
+    for (size_t i = 0; i < ncanon; i++) {
+        uint64_t k;
+        if (cpf_canonicalize(texts[i], &k) != CPF_OK) { fputs("FALHA: CPF gerado inválido\n", stderr); return 1; }
+        sink += k;
+    }
+    printf("cpf_canonicalize: %.1f ns/CPF\n\n", (now_sec() - t0) * 1e9 / (double)ncanon);
+
+    /* Varredura linear de chaves: 64 MiB de chaves no maior caso */
+    const size_t sizes[] = {1000, 100000, 1000000};
+    printf("%10s %10s %16s %16s\n", "n", "núcleo", "chaves/ns", "strcmp chaves/ns");
+    for (size_t s = 0; s < sizeof sizes / sizeof sizes[0]; s++) {
+        size_t n = sizes[s];
+        uint64_t* keys = malloc(n * sizeof *keys);
+        char (*strs)[15] = malloc(n * sizeof *strs);
+        if (!keys || !strs) return 2;
+        for (size_t i = 0; i < n; i++) {
+            make_cpf(strs[i], i, 0);
+            cpf_pack_key(strs[i], &keys[i]);
+        }
+        size_t queries = 20000000 / n + 1;
+        size_t* targets = malloc(queries * sizeof *targets);
+        if (!targets) return 2;
+        for (size_t q = 0; q < queries; q++) targets[q] = rnd(n);
+
+        t0 = now_sec();
+        size_t visited = 0;
+        for (size_t q = 0; q < queries; q++) {
+            const char* want = strs[targets[q]];
+            size_t i = 0;
+            while (strcmp(strs[i], want) != 0) i++;
+            visited += i + 1;
+        }
+        double rate_str = (double)visited / ((now_sec() - t0) * 1e9);
+
+        for (int lv = CPF_SCAN_SCALAR; lv <= (int)best; lv++) {
+            cpf_scan_set_level((CpfScanLevel)lv);
+            visited = 0;
+            t0 = now_sec();
+            for (size_t q = 0; q < queries; q++) {
+                size_t at = cpf_key_scan(keys, n, keys[targets[q]]);
+                if (at != targets[q]) { fprintf(stderr, "FALHA: cpf_key_scan (%s)\n", cpf_scan_level_name((CpfScanLevel)lv)); return 1; }
+                visited += at + 1;
+            }
+            double rate = (double)visited / ((now_sec() - t0) * 1e9);
+            printf("%10zu %10s %16.2f %16.2f\n", n, cpf_scan_level_name((CpfScanLevel)lv), rate, rate_str);
+        }
+        if (cpf_key_scan(keys, n, 1) != n) { fputs("FALHA: chave ausente encontrada\n", stderr); return 1; }
+        free(targets);
+        free(keys);
+        free(strs);
+    }
+
+    /* Índice da PatientList (grupos de 8 slots comparados pelo núcleo) */
+    const size_t n = 1000000, lookups = 2000000;
+    PatientList list;
+    init_patient_list(&list);
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.age = 30; p.gender = 'F'; p.priority = 2;
+    strcpy(p.name, "Paciente");
+    for (size_t i = 0; i < n; i++) {
+        p.id = (int)i + 1;
+        make_cpf(p.cpf, i * 7919, 1);
+        insert_patient(&list, &p);
+    }
+    char (*qs)[15] = malloc(lookups * sizeof *qs);
+    if (!qs) return 2;
+    for (size_t i = 0; i < lookups; i++) make_cpf(qs[i], rnd(n) * 7919, (int)(i & 1));
+
+    printf("\n%10s %10s %16s\n", "n", "núcleo", "busca ns");
+    for (int lv = CPF_SCAN_SCALAR; lv <= (int)best; lv++) {
+        cpf_scan_set_level((CpfScanLevel)lv);
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) {
+            const Patient* hit = search_patient_by_CPF(&list, qs[i]);
+            if (!hit) { fputs("FALHA: CPF cadastrado não encontrado\n", stderr); return 1; }
+            sink += (uint64_t)hit->id;
+        }
+        printf("%10zu %10s %16.1f\n", n, cpf_scan_level_name((CpfScanLevel)lv),
+               (now_sec() - t0) * 1e9 / (double)lookups);
+    }
+    (void)sink;
+    free(qs);
+    free(texts);
+    free_list(&list);
+    puts("conferência: OK");
+    return 0;
+}
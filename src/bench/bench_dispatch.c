@@ -0,0 +1,256 @@
+/*
+ Simulação + conferência: salas com filas próprias e roubo de trabalho.
+
+ Eventos discretos com relógio virtual (PatientQueue.clock). Quatro salas:
+ cardiologia, ortopedia, pediatria e clínico geral. Chegadas Poisson (uma
+ a cada ~7,7 min; 20% prioridade 1, 30% 2, 50% 3) com queixas desiguais:
+ 35% cardio, 25% orto, 15% pediatria, 25% gerais. O atendimento é
+ exponencial com média de 20 min quando a sala é a da queixa (ou clínico
+ geral para queixa geral) e 30 min nos outros casos.
+
+ A mesma sequência de chegadas e durações (sorteadas uma vez por paciente)
+ roda em cinco arranjos:
+   uma fila          - PatientQueue única; sala livre pega o próximo;
+   menor carga       - rota para a sala menos carregada, sem roubo;
+   menor + roubo     - idem, sala ociosa rouba;
+   especialidade     - rota pela queixa, sem roubo;
+   espec. + roubo    - rota pela queixa, sala ociosa rouba.
+ Colunas: espera p50/p90/p99 (min), p99 da prioridade 1, duração média do
+ atendimento, utilização das salas, tempo de sala ociosa com paciente
+ esperando em outra fila e roubos.
+
+ Conferência: todo paciente é atendido exatamente uma vez, e com roubo
+ nenhuma sala fica ociosa enquanto alguém espera. Com envelhecimento, o
+ roubo leva o atrasado de outra sala, como o dequeue faria, e não o de
+ nível mais alto.
+
+ Uso: make bench_dispatch && ./bench_dispatch [pacientes]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ds/room_dispatch.h"
+
+#define NS_PER_MIN   60000000000ull
+#define ROOMS        4
+#define MATCH_MIN    20.0   /* atendimento na sala da queixa */
+#define OTHER_MIN    30.0   /* atendimento fora da especialidade */
+#define ARRIVAL_MIN  7.7    /* intervalo médio entre chegadas */
+
+static const char* const specialties[ROOMS] = { "cardio", "orto", "pediatr", "" };
+
+static uint64_t sim_now;
+static uint64_t sim_clock(void) { return sim_now; }
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static double uniform(void) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (double)(rng_state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+typedef enum { ARR_SHARED, ARR_LEAST, ARR_LEAST_STEAL, ARR_SPECIALTY, ARR_SPECIALTY_STEAL } Arrangement;
+
+static const char* const arrangement_name[] = {
+    "uma fila", "menor carga", "menor + roubo", "especialidade", "espec. + roubo"
+};
+
+typedef struct {
+    Patient* registry;
+    uint64_t* arrival_ns;
+    double* unit_service;      // exponencial de média 1 (mesma em todos os arranjos)
+    unsigned char* seen;
+    size_t n;
+} Workload;
+
+typedef struct {
+    LatencyHist all, high;
+    double service_min, utilization, idle_waiting;
+    uint64_t stolen;
+} Result;
+
+/* A sala é a "certa" para a queixa? */
+static int matched(size_t room, const Patient* p) {
+    if (specialties[room][0]) return strstr(p->condition, specialties[room]) != NULL;
+    for (size_t r = 0; r < ROOMS; r++)
+        if (specialties[r][0] && strstr(p->condition, specialties[r])) return 0;
+    return 1;
+}
+
+static void build(Workload* w) {
+    static const char* const conditions[] = {
+        "cardio: dor no peito", "orto: entorse", "pediatria: febre", "gripe"
+    };
+    uint64_t t = 0;
+    for (size_t i = 0; i < w->n; i++) {
+        Patient* p = &w->registry[i];
+        p->id = (int)i + 1;
+        snprintf(p->cpf, sizeof p->cpf, "%011u", (unsigned)(i + 1));
+        double u = uniform();
+        p->priority = u < 0.2 ? 1 : u < 0.5 ? 2 : 3;
+        u = uniform();
+        size_t c = u < 0.35 ? 0 : u < 0.60 ? 1 : u < 0.75 ? 2 : 3;
+        snprintf(p->condition, sizeof p->condition, "%s", conditions[c]);
+        t += (uint64_t)(-log(1.0 - uniform()) * ARRIVAL_MIN * (double)NS_PER_MIN);
+        w->arrival_ns[i] = t;
+        w->unit_service[i] = -log(1.0 - uniform());
+    }
+}
+
+static int simulate(const Workload* w, Arrangement arr, Result* res) {
+    PatientQueue shared;
+    RoomDispatch d;
+    int per_room = arr != ARR_SHARED;
+    sim_now = 0;
+    if (per_room) {
+        DispatchPolicy policy = (arr == ARR_SPECIALTY || arr == ARR_SPECIALTY_STEAL)
+                              ? DISPATCH_SPECIALTY : DISPATCH_LEAST_LOADED;
+        if (!dispatch_init(&d, ROOMS, policy)) return 0;
+        d.stealing = arr == ARR_LEAST_STEAL || arr == ARR_SPECIALTY_STEAL;
+        for (size_t r = 0; r < ROOMS; r++) dispatch_set_specialty(&d, r, specialties[r]);
+        dispatch_set_clock(&d, sim_clock);
+    } else {
+        init_queue(&shared);
+        shared.clock = sim_clock;
+        queue_stats_reset(&shared);
+    }
+    memset(w->seen, 0, w->n);
+
+    uint64_t finish[ROOMS] = { 0 };
+    int busy[ROOMS] = { 0 };
+    double busy_ns = 0, idle_waiting_ns = 0, service_total = 0;
+    size_t next = 0, served = 0;
+    int ok = 1;
+
+    while (served < w->n && ok) {
+        uint64_t t_arrival = next < w->n ? w->arrival_ns[next] : UINT64_MAX;
+        size_t done = ROOMS;
+        for (size_t r = 0; r < ROOMS; r++)
+            if (busy[r] && (done == ROOMS || finish[r] < finish[done])) done = r;
+        uint64_t t = done < ROOMS && finish[done] <= t_arrival ? finish[done] : t_arrival;
+
+        size_t waiting = 0;
+        if (per_room) for (size_t r = 0; r < ROOMS; r++) waiting += d.rooms[r].queue.size;
+        else          waiting = shared.size;
+        for (size_t r = 0; r < ROOMS; r++) {
+            if (busy[r])      busy_ns += (double)(t - sim_now);
+            else if (waiting) idle_waiting_ns += (double)(t - sim_now);
+        }
+        sim_now = t;
+
+        if (done < ROOMS && finish[done] == t) {
+            busy[done] = 0;
+            served++;
+            if (per_room) dispatch_finish(&d, done);
+        } else {
+            const Patient* p = &w->registry[next++];
+            ok = per_room ? dispatch_enqueue(&d, p) >= 0 : enqueue(&shared, p);
+        }
+
+        for (size_t r = 0; r < ROOMS && ok; r++) {
+            if (busy[r]) continue;
+            const Patient* p = per_room ? dispatch_next(&d, r, NULL) : dequeue(&shared);
+            if (!p) continue;
+            size_t i = (size_t)p->id - 1;
+            if (w->seen[i]++) ok = 0;
+            double minutes = w->unit_service[i] * (matched(r, p) ? MATCH_MIN : OTHER_MIN);
+            service_total += minutes;
+            finish[r] = sim_now + (uint64_t)(minutes * (double)NS_PER_MIN);
+            busy[r] = 1;
+        }
+    }
+
+    latency_hist_reset(&res->all);
+    latency_hist_reset(&res->high);
+    res->stolen = 0;
+    size_t nq = per_room ? ROOMS : 1;
+    for (size_t r = 0; r < nq; r++) {
+        const PatientQueue* q = per_room ? &d.rooms[r].queue : &shared;
+        for (int lv = 0; lv < QUEUE_LEVELS; lv++) latency_hist_merge(&res->all, &q->stats.wait[lv]);
+        latency_hist_merge(&res->high, &q->stats.wait[0]);
+        if (per_room) res->stolen += d.rooms[r].stolen;
+    }
+    double span = (double)ROOMS * (double)sim_now;
+    res->service_min = service_total / (double)w->n;
+    res->utilization = busy_ns / span;
+    res->idle_waiting = idle_waiting_ns / span;
+    if (per_room) dispatch_free(&d);
+    else          free_queue(&shared);
+
+    for (size_t i = 0; i < w->n && ok; i++) if (w->seen[i] != 1) ok = 0;
+    return ok && res->all.total == w->n;
+}
+
+/* Sala 0 vazia rouba: p3 atrasado na sala 1 x p2 recém-chegado na sala 2 */
+static int check_steal_aging(void) {
+    static Patient ps[2];
+    ps[0].id = 1; ps[0].priority = 3; snprintf(ps[0].cpf, sizeof ps[0].cpf, "%011d", 1);
+    ps[1].id = 2; ps[1].priority = 2; snprintf(ps[1].cpf, sizeof ps[1].cpf, "%011d", 2);
+    const uint64_t limit[QUEUE_LEVELS] = { 0, 0, 60 * NS_PER_MIN };
+    int ok = 1;
+    for (int aging = 0; aging < 2 && ok; aging++) {
+        RoomDispatch d;
+        if (!dispatch_init(&d, 3, DISPATCH_LEAST_LOADED)) return 0;
+        dispatch_set_clock(&d, sim_clock);
+        for (size_t r = 0; r < d.count; r++) queue_set_aging(&d.rooms[r].queue, aging ? limit : NULL);
+        sim_now = 10 * NS_PER_MIN;
+        ok = ok && enqueue(&d.rooms[1].queue, &ps[0]);
+        sim_now = 95 * NS_PER_MIN;
+        ok = ok && enqueue(&d.rooms[2].queue, &ps[1]);
+        sim_now = 100 * NS_PER_MIN;
+        size_t from = d.count;
+        const Patient* p = dispatch_next(&d, 0, &from);
+        ok = ok && p == (aging ? &ps[0] : &ps[1]) && from == (aging ? 1u : 2u);
+        dispatch_free(&d);
+    }
+    if (!ok) fputs("FALHA: roubo ignorou o envelhecimento da fila vítima\n", stderr);
+    return ok;
+}
+
+static double minutes(uint64_t ns) { return (double)ns / (double)NS_PER_MIN; }
+
+int main(int argc, char** argv) {
+    Workload w;
+    w.n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 200000;
+    if (w.n < 1000) w.n = 1000;
+    w.registry = calloc(w.n, sizeof *w.registry);
+    w.arrival_ns = malloc(w.n * sizeof *w.arrival_ns);
+    w.unit_service = malloc(w.n * sizeof *w.unit_service);
+    w.seen = malloc(w.n);
+    if (!w.registry || !w.arrival_ns || !w.unit_service || !w.seen) return 2;
+    build(&w);
+
+    printf("%zu pacientes, %d salas (cardio, orto, pediatria, geral)\n\n", w.n, ROOMS);
+    printf("%-15s %8s %8s %8s %10s %9s %7s %9s %9s\n", "arranjo", "p50 min", "p90 min",
+           "p99 min", "p99 prio1", "atend.", "uso", "ociosa*", "roubos");
+    static Result res;
+    for (int a = ARR_SHARED; a <= ARR_SPECIALTY_STEAL; a++) {
+        if (!simulate(&w, (Arrangement)a, &res)) {
+            fprintf(stderr, "FALHA: %s (paciente perdido ou atendido duas vezes)\n", arrangement_name[a]);
+            return 1;
+        }
+        int stealing = a == ARR_LEAST_STEAL || a == ARR_SPECIALTY_STEAL;
+        if (stealing && res.idle_waiting > 0) {
+            fprintf(stderr, "FALHA: %s deixou sala ociosa com paciente esperando\n", arrangement_name[a]);
+            return 1;
+        }
+        printf("%-15s %8.1f %8.1f %8.1f %10.1f %8.1fm %6.1f%% %8.1f%% %9llu\n", arrangement_name[a],
+               minutes(latency_hist_percentile(&res.all, 0.50)),
+               minutes(latency_hist_percentile(&res.all, 0.90)),
+               minutes(latency_hist_percentile(&res.all, 0.99)),
+               minutes(latency_hist_percentile(&res.high, 0.99)),
+               res.service_min, res.utilization * 100.0, res.idle_waiting * 100.0,
+               (unsigned long long)res.stolen);
+    }
+    puts("\n* ociosa = tempo de sala livre com paciente esperando em alguma fila");
+    if (!check_steal_aging()) return 1;
+
+    free(w.registry);
+    free(w.arrival_ns);
+    free(w.unit_service);
+    free(w.seen);
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+ Benchmark: layout hot/cold (PatientStore) x Node da PatientList.
+
+ Para n = 10^3..10^6 pacientes mede:
+   - varredura: contagem por prioridade + maior id (só campos quentes),
+     percorrendo a lista de Node x os vetores id[]/priority[] do store;
+   - busca por CPF (texto com pontuação) devolvendo a prioridade:
+     search_patient_by_CPF x store_find_cpf;
+   - busca pela chave compacta já pronta (store_find_cpf_key), o caso de
+     quem guarda o CPF de 64 bits em vez do texto.
+ Confere que os dois layouts devolvem os mesmos resultados.
+
+ Uso: make bench_hotcold && ./bench_hotcold
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "patient_store.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static size_t rnd(size_t n) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (size_t)(rng_state % n);
+}
+
+static void make_cpf(char out[15], size_t i) {
+    snprintf(out, 15, "%03u.%03u.%03u-%02u",
+             (unsigned)(i / 100000000 % 1000), (unsigned)(i / 100000 % 1000),
+             (unsigned)(i / 100 % 1000), (unsigned)(i % 100));
+}
+
+int main(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t lookups = 1000000;
+
+    printf("%10s %14s %14s %14s %14s %14s\n", "n", "scan node ns", "scan soa ns",
+           "cpf node ns", "cpf soa ns", "chave64 ns");
+
+    for (size_t k = 0; k < sizeof sizes / sizeof sizes[0]; k++) {
+        size_t n = sizes[k];
+        PatientList list;
+        PatientStore store;
+        init_patient_list(&list);
+        init_patient_store(&store);
+        Patient p;
+        memset(&p, 0, sizeof p);
+        p.age = 40; p.gender = 'M';
+        strcpy(p.name, "Paciente");
+        strcpy(p.condition, "Consulta de rotina");
+        for (size_t i = 0; i < n; i++) {
+            p.id = (int)i + 1;
+            p.priority = (int)(i % 3) + 1;
+            make_cpf(p.cpf, i * 7919 % 1000000007u);
+            if (!insert_patient(&list, &p) || !store_insert_patient(&store, &p)) {
+                fprintf(stderr, "falha ao inserir %zu\n", i);
+                return 1;
+            }
+        }
+
+        /* Varredura dos campos quentes: repete até somar >= 10^7 visitas */
+        size_t rounds = 10000000 / n;
+        size_t cnt_a[4] = {0}, cnt_b[4] = {0};
+        int max_a = 0, max_b = 0;
+        double t0 = now_sec();
+        for (size_t r = 0; r < rounds; r++)
+            for (const Node* cur = list.head; cur; cur = cur->next) {
+                cnt_a[cur->data.priority & 3]++;
+                if (cur->data.id > max_a) max_a = cur->data.id;
+            }
+        double t_scan_node = now_sec() - t0;
+
+        t0 = now_sec();
+        for (size_t r = 0; r < rounds; r++)
+            for (size_t i = 0; i < store.count; i++) {
+                cnt_b[store.priority[i] & 3]++;
+                if (store.id[i] > max_b) max_b = store.id[i];
+            }
+        double t_scan_soa = now_sec() - t0;
+        if (max_a != max_b || memcmp(cnt_a, cnt_b, sizeof cnt_a) != 0) {
+            fprintf(stderr, "FALHA (n=%zu): varreduras diferem\n", n);
+            return 1;
+        }
+
+        /* Buscas aleatórias por CPF */
+        char (*cpfs)[15] = malloc(lookups * sizeof *cpfs);
+        uint64_t* keys = malloc(lookups * sizeof *keys);
+        if (!cpfs || !keys) return 2;
+        for (size_t i = 0; i < lookups; i++) {
+            make_cpf(cpfs[i], rnd(n) * 7919 % 1000000007u);
+            cpf_pack_key(cpfs[i], &keys[i]);
+        }
+
+        volatile unsigned sink = 0;
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) sink += (unsigned)search_patient_by_CPF(&list, cpfs[i])->priority;
+        double t_cpf_node = now_sec() - t0;
+
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) sink += store.priority[store_find_cpf(&store, cpfs[i])];
+        double t_cpf_soa = now_sec() - t0;
+
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) sink += store.priority[store_find_cpf_key(&store, keys[i])];
+        double t_key = now_sec() - t0;
+        (void)sink;
+
+        /* Conferência: mesmo paciente pelos dois caminhos */
+        for (size_t i = 0; i < 1000; i++) {
+            const Patient* a = search_patient_by_CPF(&list, cpfs[i]);
+            Patient b;
+            store_get_patient(&store, store_find_cpf(&store, cpfs[i]), &b);
+            if (a->id != b.id || a->priority != b.priority || strcmp(a->name, b.name) != 0 ||
+                store_find_id(&store, a->id) == STORE_NONE) {
+                fprintf(stderr, "FALHA (n=%zu): buscas diferem\n", n);
+                return 1;
+            }
+        }
+
+        double visits = (double)rounds * (double)n;
+        printf("%10zu %14.2f %14.2f %14.1f %14.1f %14.1f\n", n,
+               t_scan_node * 1e9 / visits, t_scan_soa * 1e9 / visits,
+               t_cpf_node * 1e9 / (double)lookups, t_cpf_soa * 1e9 / (double)lookups,
+               t_key * 1e9 / (double)lookups);
+
+        free(cpfs);
+        free(keys);
+        free_patient_store(&store);
+        free_list(&list);
+    }
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,133 @@
+/*
+ Benchmark + conferência: índice ordenado de id na PatientList.
+
+ Cadastra n pacientes com ids embaralhados (só ímpares, para haver ids
+ ausentes) e compara:
+   - search_patient_by_id (árvore B+) x varredura da lista (o antigo id_exists);
+   - faixa de 100 ids por cursor x varredura filtrando a lista inteira.
+ Confere também que cada busca acerta/erra como deve, que ids repetidos
+ são recusados e que as faixas saem completas e em ordem crescente.
+
+ Uso: make bench_id_index && ./bench_id_index
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static size_t rnd(size_t n) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (size_t)(rng_state % n);
+}
+
+static const Patient* linear_by_id(const PatientList* list, int id) {
+    for (const Node* cur = list->head; cur; cur = cur->next)
+        if (cur->data.id == id) return &cur->data;
+    return NULL;
+}
+
+static int fail(const char* what, size_t n) {
+    fprintf(stderr, "FALHA (n=%zu): %s\n", n, what);
+    return 1;
+}
+
+int main(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t lookups = 100000, linear_lookups = 200, ranges = 10000, span = 100;
+
+    printf("%10s %12s %12s %14s %14s %14s\n", "n", "insert ns", "btree ns", "linear ns",
+           "faixa100 us", "faixa lin us");
+
+    for (size_t k = 0; k < sizeof sizes / sizeof sizes[0]; k++) {
+        size_t n = sizes[k];
+        int* ids = malloc(n * sizeof *ids);
+        if (!ids) return 2;
+        for (size_t i = 0; i < n; i++) ids[i] = (int)(2 * i + 1);
+        for (size_t i = n - 1; i > 0; i--) { /* Fisher-Yates */
+            size_t j = rnd(i + 1);
+            int t = ids[i]; ids[i] = ids[j]; ids[j] = t;
+        }
+
+        PatientList list;
+        init_patient_list(&list);
+        Patient p;
+        memset(&p, 0, sizeof p);
+        p.age = 30; p.gender = 'F'; p.priority = 2;
+        strcpy(p.name, "Paciente");
+
+        double t0 = now_sec();
+        for (size_t i = 0; i < n; i++) {
+            p.id = ids[i];
+            snprintf(p.cpf, sizeof p.cpf, "%011u", (unsigned)i);
+            insert_patient(&list, &p);
+        }
+        double t_insert = now_sec() - t0;
+
+        /* Unicidade: mesmo id com outro CPF é recusado */
+        p.id = ids[0];
+        strcpy(p.cpf, "99999999999");
+        if (insert_patient(&list, &p) || list.size != n) return fail("id repetido aceito", n);
+
+        volatile size_t sink = 0;
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) {
+            int id = (int)rnd(2 * n + 2);
+            const Patient* hit = search_patient_by_id(&list, id);
+            if ((hit != NULL) != (id % 2 == 1 && id < (int)(2 * n)) || (hit && hit->id != id))
+                return fail("busca por id", n);
+            sink += hit != NULL;
+        }
+        double t_btree = now_sec() - t0;
+
+        t0 = now_sec();
+        for (size_t i = 0; i < linear_lookups; i++)
+            sink += linear_by_id(&list, (int)(2 * rnd(n) + 1)) != NULL;
+        double t_linear = now_sec() - t0;
+
+        double t_range = 0, t_range_lin = 0;
+        for (size_t i = 0; i < ranges; i++) {
+            int lo = (int)rnd(2 * n), hi = lo + (int)span - 1;
+            t0 = now_sec();
+            IdCursor cur = patient_id_range(&list, lo, hi);
+            int last = lo - 1;
+            size_t got = 0;
+            for (const Patient* q; (q = id_cursor_next(&cur)) != NULL; got++) {
+                if (q->id <= last || q->id > hi) return fail("faixa fora de ordem", n);
+                last = q->id;
+            }
+            t_range += now_sec() - t0;
+
+            size_t expected = 0;
+            for (int id = lo; id <= hi; id++) expected += id % 2 == 1 && id < (int)(2 * n);
+            if (got != expected) return fail("faixa incompleta", n);
+
+            if (i < linear_lookups) { /* amostra: a varredura é O(n) por faixa */
+                t0 = now_sec();
+                for (const Node* cur2 = list.head; cur2; cur2 = cur2->next)
+                    sink += cur2->data.id >= lo && cur2->data.id <= hi;
+                t_range_lin += now_sec() - t0;
+            }
+        }
+        (void)sink;
+
+        printf("%10zu %12.1f %12.1f %14.1f %14.2f %14.2f\n", n,
+               t_insert * 1e9 / (double)n, t_btree * 1e9 / (double)lookups,
+               t_linear * 1e9 / (double)linear_lookups,
+               t_range * 1e6 / (double)ranges, t_range_lin * 1e6 / (double)linear_lookups);
+
+        free_list(&list);
+        free(ids);
+    }
+    puts("conferência: OK");
+    return 0;
+}
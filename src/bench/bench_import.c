@@ -0,0 +1,121 @@
+/*
+ Benchmark: vazão da importação em massa (CSV e JSONL).
+
+ Gera um arquivo com N pacientes (1% de CPFs repetidos e 1% de linhas
+ inválidas, para exercitar o caminho de erro) e mede import_patients
+ numa PatientList vazia: MB/s, linhas/s e contagem de rejeitados.
+
+ Uso: make bench_import && ./bench_import [N] [prefixo_dos_arquivos]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "util/patient_import.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static const char* const conditions[] = {
+    "Retorno", "Dor \"aguda\" no peito", "Febre, tosse", "Consulta de rotina"
+};
+
+/* CPF válido (dígitos verificadores corretos) derivado de key */
+static void make_cpf(char out[15], size_t key, int punct) {
+    int d[11];
+    size_t base = 100000000u + key % 900000000u;
+    for (int i = 8; i >= 0; i--) { d[i] = (int)(base % 10); base /= 10; }
+    for (int k = 9; k <= 10; k++) {
+        int sum = 0;
+        for (int i = 0; i < k; i++) sum += d[i] * (k + 1 - i);
+        d[k] = sum * 10 % 11 % 10;
+    }
+    size_t n = 0;
+    for (int i = 0; i < 11; i++) {
+        if (punct && (i == 3 || i == 6)) out[n++] = '.';
+        if (punct && i == 9) out[n++] = '-';
+        out[n++] = (char)('0' + d[i]);
+    }
+    out[n] = '\0';
+}
+
+static int write_input(const char* path, ImportFormat fmt, size_t n) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return 0;
+    if (fmt == IMPORT_CSV) fputs("id,nome,cpf,idade,sexo,condicao,prioridade\n", f);
+    for (size_t i = 0; i < n; i++) {
+        size_t key = (i % 100 == 99) ? i - 1 : i;    /* 1% duplicados */
+        int age = (i % 100 == 42) ? 500 : (int)(i % 90); /* 1% inválidos */
+        const char* cond = conditions[i % 4];
+        char cpf[15];
+        if (fmt == IMPORT_CSV) {
+            /* Campo com vírgula/aspas vai entre aspas, com "" */
+            make_cpf(cpf, key, 1);
+            fprintf(f, "%zu,Paciente %zu,%s,%d,%c,", i + 1, i, cpf, age, (i & 1) ? 'M' : 'F');
+            if (strpbrk(cond, ",\"")) {
+                fputc('"', f);
+                for (const char* c = cond; *c; c++) {
+                    if (*c == '"') fputc('"', f);
+                    fputc(*c, f);
+                }
+                fputc('"', f);
+            } else {
+                fputs(cond, f);
+            }
+            fprintf(f, ",%zu\n", i % 3 + 1);
+        } else {
+            make_cpf(cpf, key, 0);
+            fprintf(f, "{\"id\": %zu, \"name\": \"Paciente %zu\", \"cpf\": \"%s\", "
+                       "\"age\": %d, \"gender\": \"%c\", \"condition\": \"",
+                    i + 1, i, cpf, age, (i & 1) ? 'M' : 'F');
+            for (const char* c = cond; *c; c++) {
+                if (*c == '"') fputc('\\', f);
+                fputc(*c, f);
+            }
+            fprintf(f, "\", \"priority\": %zu}\n", i % 3 + 1);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+static void run(const char* label, const char* path, ImportFormat fmt, size_t n) {
+    if (!write_input(path, fmt, n)) { fprintf(stderr, "falha ao gerar '%s'\n", path); return; }
+
+    PatientList list;
+    init_patient_list(&list);
+    FILE* f = fopen(path, "rb");
+    if (!f) return;
+    ImportOptions opt = import_default_options();
+    opt.format = fmt;
+    ImportStats st;
+
+    double t0 = now_sec();
+    int ok = import_patients(f, &list, &opt, NULL, &st);
+    double secs = now_sec() - t0;
+    fclose(f);
+
+    double mb = (double)st.bytes / 1e6;
+    printf("%-6s %10zu %10.1f %10.3f %10.1f %12.0f %10zu %10zu%s\n", label, st.rows, mb, secs,
+           mb / secs, (double)st.rows / secs, st.imported, st.rejected, ok ? "" : " (falhou)");
+    free_list(&list);
+    remove(path);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000u;
+    const char* prefix = argc > 2 ? argv[2] : "bench_import";
+    char csv[256], jsonl[256];
+    snprintf(csv, sizeof csv, "%s.csv", prefix);
+    snprintf(jsonl, sizeof jsonl, "%s.jsonl", prefix);
+
+    printf("%-6s %10s %10s %10s %10s %12s %10s %10s\n",
+           "fmt", "linhas", "MB", "tempo (s)", "MB/s", "linhas/s", "importados", "rejeitados");
+    run("csv", csv, IMPORT_CSV, n);
+    run("jsonl", jsonl, IMPORT_JSONL, n);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ Benchmark + conferência: busca por prefixo de nome (trie de nomes dobrados).
+
+ Cadastra n pacientes com nomes compostos (acentuados, maiúsculas e
+ minúsculas misturadas) e compara, para prefixos sorteados:
+   - primeira página (20) pelo cursor do índice x varredura da lista
+     dobrando cada nome (o que seria preciso sem índice);
+   - contagem completa de resultados pelos dois caminhos (conferência).
+ Confere também que os resultados saem em ordem alfabética, sem repetir
+ paciente, e que remover tira o paciente das buscas.
+
+ Uso: make bench_name_index && ./bench_name_index
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static size_t rnd(size_t n) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (size_t)(rng_state % n);
+}
+
+static const char* const first[] = {
+    "José", "JOÃO", "Maria", "Ana", "Antônio", "Francisco", "Luíza", "Márcia",
+    "Conceição", "Sebastião", "Inês", "Raimundo", "Cecília", "Fábio", "Tânia", "Lúcio"
+};
+static const char* const last[] = {
+    "Silva", "Santos", "Oliveira", "Souza", "Conceição", "Gonçalves", "Araújo", "Lima",
+    "Ribeiro", "Simões", "Magalhães", "Brandão", "Assunção", "Guimarães", "Pereira", "Lopes"
+};
+#define COUNT(a) (sizeof a / sizeof a[0])
+
+/* Consultas: prefixos de nomes e sobrenomes, com e sem acento/caixa */
+static const char* const queries[] = {
+    "jose", "JOAO si", "mar", "conceicao", "Conceição sa", "ana lu", "guim", "seb",
+    "silva", "tania 1", "ines ara", "lucio lopes 99", "zzz"
+};
+
+/* Sem índice: dobra o nome e testa o início de cada palavra */
+static int linear_match(const Patient* p, const char* q, size_t qlen) {
+    char key[NAME_KEY_CAP];
+    size_t len = name_fold(p->name, key, sizeof key);
+    for (size_t i = 0; i < len || i == 0; i++)
+        if ((i == 0 || key[i - 1] == ' ') && strncmp(key + i, q, qlen) == 0) return 1;
+    return 0;
+}
+
+static int fail(const char* what, size_t n, const char* q) {
+    fprintf(stderr, "FALHA (n=%zu, \"%s\"): %s\n", n, q, what);
+    return 1;
+}
+
+int main(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t page = 20, reps = 2000;
+
+    printf("%10s %12s %14s %14s %14s\n", "n", "insert ns", "1a pag us", "varredura us",
+           "resultados");
+
+    for (size_t k = 0; k < COUNT(sizes); k++) {
+        size_t n = sizes[k];
+        PatientList list;
+        init_patient_list(&list);
+        Patient p;
+        memset(&p, 0, sizeof p);
+        p.age = 30; p.gender = 'F'; p.priority = 2;
+
+        double t0 = now_sec();
+        for (size_t i = 0; i < n; i++) {
+            p.id = (int)i + 1;
+            snprintf(p.cpf, sizeof p.cpf, "%011u", (unsigned)i);
+            snprintf(p.name, sizeof p.name, "%s %s %s %u", first[rnd(COUNT(first))],
+                     last[rnd(COUNT(last))], last[rnd(COUNT(last))], (unsigned)(i % 1000));
+            insert_patient(&list, &p);
+        }
+        double t_insert = now_sec() - t0;
+
+        double t_page = 0, t_scan = 0;
+        size_t total = 0, scans = 0;
+        for (size_t r = 0; r < reps; r++) {
+            const char* qraw = queries[r % COUNT(queries)];
+            NameCursor cur;
+            t0 = now_sec();
+            patient_name_search(&list, qraw, &cur);
+            size_t got = 0;
+            while (got < page && name_cursor_next(&cur)) got++;
+            t_page += now_sec() - t0;
+
+            if (r >= COUNT(queries)) continue;
+
+            /* Conferência completa (uma vez por consulta) */
+            char q[NAME_KEY_CAP];
+            size_t qlen = name_fold(qraw, q, sizeof q);
+            patient_name_search(&list, qraw, &cur);
+            got = 0;
+            char prev[NAME_KEY_CAP] = "";
+            for (const Patient* m; (m = name_cursor_next(&cur)) != NULL; got++) {
+                if (!linear_match(m, q, qlen)) return fail("resultado não casa", n, qraw);
+                /* Ordem: a parte casada (a partir da palavra) não diminui */
+                char key[NAME_KEY_CAP];
+                size_t len = name_fold(m->name, key, sizeof key);
+                const char* part = NULL;
+                for (size_t i = 0; i < len && !part; i++)
+                    if ((i == 0 || key[i - 1] == ' ') && strncmp(key + i, q, qlen) == 0) part = key + i;
+                if (part && strcmp(part, prev) < 0)
+                    return fail("fora de ordem", n, qraw);
+                if (part) strcpy(prev, part);
+            }
+
+            t0 = now_sec();
+            size_t expected = 0;
+            for (const Node* cur2 = list.head; cur2; cur2 = cur2->next)
+                expected += (size_t)linear_match(&cur2->data, q, qlen);
+            t_scan += now_sec() - t0;
+            scans++;
+            if (got != expected) return fail("contagem diferente da varredura", n, qraw);
+            total += got;
+        }
+
+        /* Remoção: o primeiro "jose" some da busca */
+        NameCursor cur;
+        patient_name_search(&list, "jose", &cur);
+        const Patient* victim = name_cursor_next(&cur);
+        if (victim) {
+            name_index_remove(&list.name_index, victim);
+            patient_name_search(&list, "jose", &cur);
+            for (const Patient* m; (m = name_cursor_next(&cur)) != NULL;)
+                if (m == victim) return fail("removido ainda aparece", n, "jose");
+        }
+
+        printf("%10zu %12.1f %14.2f %14.1f %14zu\n", n, t_insert * 1e9 / (double)n,
+               t_page * 1e6 / (double)reps, t_scan * 1e6 / (double)scans, total);
+        free_list(&list);
+    }
+    puts("conferência: OK");
+    return 0;
+}
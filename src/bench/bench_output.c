@@ -0,0 +1,110 @@
+/*
+ Benchmark: listagem de 10^6 pacientes num arquivo.
+
+ Compara o jeito antigo de print_all_patient (um fprintf por paciente,
+ copiando o Patient por valor) com print_patient_page + OutBuffer (campos
+ copiados direto no buffer, inteiros formatados à mão, um write(2) por MiB).
+ Também mede uma página pequena no fim da lista (offset alto).
+
+ Uso: make bench_output && ./bench_output [arquivo]
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#define open _open
+#define close _close
+#else
+#include <unistd.h>
+#endif
+#include "ds/patient_list.h"
+#include "util/out_buffer.h"
+
+#define N_PATIENTS 1000000u
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long file_size(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fclose(f);
+    return n;
+}
+
+static void report(const char* mode, const char* path, double secs, size_t writes) {
+    double mb = (double)file_size(path) / (1024.0 * 1024.0);
+    printf("%-16s %10.3f %10.1f %12.1f %10zu\n", mode, secs, mb, mb / secs, writes);
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_output.txt";
+
+    PatientList list;
+    init_patient_list(&list);
+    reserve_patient_list(&list, N_PATIENTS);
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.gender = 'M';
+    for (unsigned i = 0; i < N_PATIENTS; i++) {
+        p.id = (int)i + 1;
+        p.age = (int)(i % 100);
+        p.priority = (int)(i % 3) + 1;
+        snprintf(p.name, sizeof p.name, "Paciente %u", i);
+        snprintf(p.cpf, sizeof p.cpf, "%011u", i);
+        insert_patient(&list, &p);
+    }
+
+    printf("%-16s %10s %10s %12s %10s\n", "modo", "tempo (s)", "MiB", "MiB/s", "writes");
+
+    /* Antes: fprintf por linha */
+    FILE* f = fopen(path, "wb");
+    if (!f) { fprintf(stderr, "não foi possível criar '%s'\n", path); return 1; }
+    double t0 = now_sec();
+    for (Node* cur = list.head; cur; cur = cur->next) {
+        Patient row = cur->data;
+        fprintf(f, "ID: %d | Nome: %s | CPF: %s | Idade: %d | Prioridade: %d\n",
+                row.id, row.name, row.cpf, row.age, row.priority);
+    }
+    fclose(f);
+    report("fprintf/linha", path, now_sec() - t0, 0);
+
+    /* Agora: OutBuffer */
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    OutBuffer out;
+    if (fd < 0 || !out_open(&out, fd, 0)) { fprintf(stderr, "falha ao abrir saída\n"); return 1; }
+    t0 = now_sec();
+    print_patient_page(&list, &out, 0, OUT_ALL);
+    out_flush(&out);
+    double secs = now_sec() - t0;
+    close(fd);
+    report("out_buffer", path, secs, out.flushes);
+
+    /* Página: 100 linhas a partir da 900000 */
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    out.fd = fd;
+    out.flushes = 0;
+    t0 = now_sec();
+    print_patient_page(&list, &out, 900000, 100);
+    out_flush(&out);
+    secs = now_sec() - t0;
+    close(fd);
+    report("pagina 100", path, secs, out.flushes);
+
+    out_close(&out);
+    free_list(&list);
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ Benchmark: busca/unicidade de CPF na PatientList.
+
+ Compara o índice hash (search_patient_by_CPF atual) com a varredura linear
+ que a lista fazia antes (strcmp nó a nó), para 10^3..10^6 pacientes.
+
+ A varredura linear em cada inserção custa O(N^2) no total; para não levar
+ horas em 10^6, medimos o custo por busca linear em uma amostra e
+ extrapolamos o custo de carga (N^2/2 visitas).
+
+ Uso: make bench_patient_list && ./bench_patient_list
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void make_cpf(char out[15], size_t i) {
+    snprintf(out, 15, "%03u.%03u.%03u-%02u",
+             (unsigned)(i / 100000000 % 1000), (unsigned)(i / 100000 % 1000),
+             (unsigned)(i / 100 % 1000), (unsigned)(i % 100));
+}
+
+/* A busca antiga: percorre todos os nós comparando o CPF exato. */
+static const Patient* linear_search(const PatientList* list, const char* cpf) {
+    for (Node* cur = list->head; cur; cur = cur->next)
+        if (strcmp(cur->data.cpf, cpf) == 0) return &cur->data;
+    return NULL;
+}
+
+int main(void) {
+    const size_t sizes[] = {1000, 10000, 100000, 1000000};
+    const size_t lookups = 200000;
+    volatile size_t sink = 0;
+
+    printf("%10s %14s %14s %14s %16s\n",
+           "n", "insert ns/op", "hash ns/look", "linear ns/look", "linear load (s)");
+
+    for (size_t k = 0; k < sizeof sizes / sizeof sizes[0]; k++) {
+        size_t n = sizes[k];
+        PatientList list;
+        init_patient_list(&list);
+
+        Patient p;
+        memset(&p, 0, sizeof p);
+        p.age = 30; p.gender = 'F'; p.priority = 2;
+        strcpy(p.name, "Paciente");
+
+        double t0 = now_sec();
+        for (size_t i = 0; i < n; i++) {
+            p.id = (int)i + 1;
+            make_cpf(p.cpf, i);
+            insert_patient(&list, &p);
+        }
+        double t_insert = now_sec() - t0;
+
+        char cpf[15];
+        srand(42);
+        t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++) {
+            make_cpf(cpf, (size_t)rand() % n);
+            sink += search_patient_by_CPF(&list, cpf) != NULL;
+        }
+        double t_hash = now_sec() - t0;
+
+        /* Limita o trabalho linear a ~2e8 visitas de nó */
+        size_t lin = 200000000 / n;
+        if (lin > lookups) lin = lookups;
+        if (lin < 20) lin = 20;
+        t0 = now_sec();
+        for (size_t i = 0; i < lin; i++) {
+            make_cpf(cpf, (size_t)rand() % n);
+            sink += linear_search(&list, cpf) != NULL;
+        }
+        double t_lin = now_sec() - t0;
+        double lin_per_look = t_lin / (double)lin;
+        /* Carga antiga: a i-ésima inserção varre i nós => ~N/2 por busca média */
+        double lin_load = lin_per_look * (double)n;
+
+        printf("%10zu %14.1f %14.1f %14.1f %16.2f\n", n,
+               t_insert * 1e9 / (double)n,
+               t_hash * 1e9 / (double)lookups,
+               lin_per_look * 1e9,
+               lin_load);
+
+        free_list(&list);
+    }
+    (void)sink;
+    return 0;
+}
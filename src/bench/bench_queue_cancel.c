@@ -0,0 +1,173 @@
+/*
+ Benchmark + conferência: desistência (queue_remove_cpf) e posição na fila
+ (queue_position).
+
+ 1) Estresse contra um modelo: operações aleatórias (enqueue, enqueue_front,
+    dequeue, remoção por CPF, posição) numa fila pequena; depois de cada
+    passo a posição de um CPF sorteado é comparada com a contagem linear
+    na ordem de atendimento (queue_first/queue_next), e a fila inteira com
+    o modelo de vez em quando.
+ 2) Tempo com 10^6 pacientes na fila: remoção por CPF e posição pelo mapa
+    + Fenwick, x a busca linear que a remoção ingênua faria.
+
+ Uso: make bench_queue_cancel && ./bench_queue_cancel [semente]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_queue.h"
+
+#define MODEL_CAP 256
+#define STRESS_IDS 400   /* poucos CPFs: repetidos na fila acontecem */
+
+static unsigned long long rng_state = 42;
+
+static unsigned rnd(void) {
+    rng_state = rng_state * 6364136223846793005ull + 1442695040888963407ull;
+    return (unsigned)(rng_state >> 33);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void make_patient(Patient* p, int id) {
+    memset(p, 0, sizeof p[0]);
+    p->id = id;
+    snprintf(p->name, sizeof p->name, "Paciente %d", id);
+    snprintf(p->cpf, sizeof p->cpf, "%011d", id); /* chave compacta não confere DV */
+    p->age = 30;
+    p->gender = 'F';
+    p->priority = (int)(rnd() % QUEUE_LEVELS) + 1;
+}
+
+/* Modelo: ids por nível, na ordem de atendimento */
+static int model[QUEUE_LEVELS][MODEL_CAP];
+static size_t model_len[QUEUE_LEVELS];
+
+/* Posição pela contagem linear (1-based; 0 se ausente) */
+static size_t linear_position(const PatientQueue* q, const char* cpf) {
+    size_t pos = 1;
+    for (const QueueNode* n = queue_first(q); n; n = queue_next(q, n), pos++)
+        if (strcmp(n->patient->cpf, cpf) == 0) return pos;
+    return 0;
+}
+
+static int model_matches(const PatientQueue* q) {
+    const QueueNode* node = queue_first(q);
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++)
+        for (size_t i = 0; i < model_len[lv]; i++, node = queue_next(q, node))
+            if (!node || node->patient->id != model[lv][i]) return 0;
+    return node == NULL;
+}
+
+static void model_remove(int lv, size_t i) {
+    memmove(&model[lv][i], &model[lv][i + 1], (model_len[lv] - i - 1) * sizeof model[lv][0]);
+    model_len[lv]--;
+}
+
+static int stress(size_t ops) {
+    /* "Cadastro": a fila guarda handles, então os pacientes ficam parados aqui */
+    static Patient registry[STRESS_IDS];
+    for (int i = 0; i < STRESS_IDS; i++) make_patient(&registry[i], i + 1);
+
+    PatientQueue q;
+    init_queue(&q);
+    for (size_t step = 0; step < ops; step++) {
+        unsigned op = rnd() % 10;
+        int id = (int)(rnd() % STRESS_IDS) + 1;
+        const Patient* p = &registry[id - 1];
+        int lv = p->priority - 1;
+        const char* cpf = p->cpf;
+
+        if (op < 4 && model_len[lv] < MODEL_CAP) {
+            if (!enqueue(&q, p)) return 0;
+            model[lv][model_len[lv]++] = id;
+        } else if (op == 4 && model_len[lv] < MODEL_CAP) {
+            if (!enqueue_front(&q, p)) return 0;
+            memmove(&model[lv][1], &model[lv][0], model_len[lv] * sizeof model[lv][0]);
+            model[lv][0] = id;
+            model_len[lv]++;
+        } else if (op == 5) {
+            const Patient* out = dequeue(&q);
+            for (int l = 0; l < QUEUE_LEVELS; l++) {
+                if (!model_len[l]) continue;
+                if (out != &registry[model[l][0] - 1]) return 0;
+                model_remove(l, 0);
+                break;
+            }
+        } else if (op <= 8) {
+            /* Remove a PRIMEIRA ocorrência do CPF na ordem de atendimento */
+            const Patient* out = queue_remove_cpf(&q, cpf);
+            int found = 0;
+            for (int l = 0; l < QUEUE_LEVELS && !found; l++)
+                for (size_t i = 0; i < model_len[l] && !found; i++)
+                    if (model[l][i] == id) { model_remove(l, i); found = 1; }
+            if (found != (out != NULL) || (out && out != p)) return 0;
+        }
+
+        if (queue_position(&q, cpf) != linear_position(&q, cpf)) {
+            fprintf(stderr, "FALHA: posição de %s no passo %zu\n", cpf, step);
+            return 0;
+        }
+        if (step % 64 == 0 && !model_matches(&q)) {
+            fprintf(stderr, "FALHA: fila diverge do modelo no passo %zu\n", step);
+            return 0;
+        }
+    }
+    free_queue(&q);
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) rng_state = strtoull(argv[1], NULL, 10);
+    if (!stress(200000)) { fputs("FALHA: estresse\n", stderr); return 1; }
+    puts("estresse (200000 operações): OK");
+
+    const size_t n = 1000000, queries = 2000;
+    Patient* registry = malloc(n * sizeof *registry);
+    if (!registry) return 2;
+    for (size_t i = 0; i < n; i++) make_patient(&registry[i], (int)i + 1);
+    PatientQueue q;
+    init_queue(&q);
+    double t0 = now_sec();
+    for (size_t i = 0; i < n; i++)
+        if (!enqueue(&q, &registry[i])) return 2;
+    printf("enqueue: %.1f ns/op (n = %zu)\n", (now_sec() - t0) * 1e9 / (double)n, n);
+
+    char (*cpfs)[15] = malloc(queries * sizeof *cpfs);
+    if (!cpfs) return 2;
+    for (size_t i = 0; i < queries; i++)
+        snprintf(cpfs[i], sizeof cpfs[i], "%011d", (int)(rnd() % n) + 1);
+
+    /* Linear: o que a remoção/posição sem índice faria */
+    volatile size_t sink = 0;
+    t0 = now_sec();
+    for (size_t i = 0; i < queries / 10; i++) sink += linear_position(&q, cpfs[i]);
+    double linear_ns = (now_sec() - t0) * 1e9 / (double)(queries / 10);
+
+    t0 = now_sec();
+    for (size_t i = 0; i < queries; i++) sink += queue_position(&q, cpfs[i]);
+    double pos_ns = (now_sec() - t0) * 1e9 / (double)queries;
+
+    t0 = now_sec();
+    size_t removed = 0;
+    for (size_t i = 0; i < queries; i++) removed += queue_remove_cpf(&q, cpfs[i]) != NULL;
+    double rm_ns = (now_sec() - t0) * 1e9 / (double)queries;
+    (void)sink;
+
+    if (q.size != n - removed) { fputs("FALHA: tamanho após remoções\n", stderr); return 1; }
+    printf("%-28s %12.1f ns\n", "busca linear (ingênua)", linear_ns);
+    printf("%-28s %12.1f ns\n", "queue_position", pos_ns);
+    printf("%-28s %12.1f ns  (%zu removidos)\n", "queue_remove_cpf", rm_ns, removed);
+
+    free(cpfs);
+    free_queue(&q);
+    free(registry);
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,329 @@
+/*
+ Gerador de carga + conferência: modo servidor (socket Unix, epoll).
+
+ Sem --socket, sobe o servidor (run_server) numa thread deste processo,
+ num socket temporário; com --socket, usa um servidor já rodando
+ (./clinic --server caminho).
+
+ Cada cliente é uma thread com uma conexão: cadastra os seus pacientes e
+ depois manda uma mistura de comandos mantendo até P em voo (pipeline):
+ 45% L, 20% E, 15% D, 10% R, 5% U, 5% T. Para C clientes e profundidade P
+ (C = 1, 4, 16, 64; P = 1, 16) mostra comandos/s e a latência envio ->
+ resposta (p50/p99, µs).
+
+ Conferência: toda busca L devolve o paciente do CPF pedido, todo R novo
+ responde OK e cada comando recebe exatamente uma resposta, na ordem.
+
+ Uso: make bench_server && ./bench_server [--socket caminho] [--requests N]
+*/
+
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "controller/server_controller.h"
+#include "util/latency_hist.h"
+
+#define MAX_CLIENTS   64
+#define MAX_DEPTH     16
+#define PRELOAD       200     /* pacientes cadastrados por cliente antes da medição */
+#define IO_CAP        (64u * 1024u)
+
+typedef struct {
+    const char* socket_path;
+    unsigned clients, depth;
+    size_t requests;          // comandos medidos por cliente
+    atomic_int failed;
+    atomic_uint round;        // separa os CPFs de cada rodada
+} Bench;
+
+typedef struct {
+    Bench* b;
+    unsigned index;
+    unsigned seed;
+    LatencyHist hist;
+    size_t registered;        // pacientes deste cliente no servidor
+} Client;
+
+typedef struct {
+    char op;
+    size_t key;               // L: paciente esperado
+    uint64_t sent_ns;
+} InFlight;
+
+typedef struct {
+    int fd;
+    char in[IO_CAP];
+    size_t in_start, in_len;
+} Conn;
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned rnd(unsigned* s) {
+    *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+    return *s;
+}
+
+/* CPF válido (dígitos verificadores corretos) derivado de key */
+static void make_cpf(char out[15], size_t key) {
+    int d[11];
+    size_t base = 100000000u + key % 900000000u;
+    for (int i = 8; i >= 0; i--) { d[i] = (int)(base % 10); base /= 10; }
+    for (int k = 9; k <= 10; k++) {
+        int sum = 0;
+        for (int i = 0; i < k; i++) sum += d[i] * (k + 1 - i);
+        d[k] = sum * 10 % 11 % 10;
+    }
+    for (int i = 0; i < 11; i++) out[i] = (char)('0' + d[i]);
+    out[11] = '\0';
+}
+
+#define KEYS_PER_CLIENT 1111u   /* i < 1111: os 9 primeiros dígitos nunca são iguais */
+#define KEY_SLOTS       90000u  /* faixas de KEYS_PER_CLIENT chaves (< 9 * 10^8) */
+
+static size_t key_base;         /* faixa inicial, sorteada por execução */
+
+/* Chave do i-ésimo paciente do cliente na rodada: faixas distintas por
+   rodada e cliente, a partir de key_base (servidor externo pode já ter
+   pacientes de outras execuções) */
+static size_t patient_key(const Client* c, unsigned round, size_t i) {
+    size_t slot = (key_base + (size_t)round * MAX_CLIENTS + c->index) % KEY_SLOTS;
+    return slot * KEYS_PER_CLIENT + i;
+}
+
+/* ---------- conexão ---------- */
+
+static int connect_unix(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof addr.sun_path, "%s", path);
+    for (int attempt = 0; attempt < 500; attempt++) {  /* servidor ainda subindo */
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*)&addr, sizeof addr) == 0) return fd;
+        close(fd);
+        struct timespec pause = { 0, 10000000 };
+        nanosleep(&pause, NULL);
+    }
+    return -1;
+}
+
+static int send_all(int fd, const char* p, size_t n) {
+    while (n) {
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return 0;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    return 1;
+}
+
+/* Próxima linha de resposta (sem '\n'), ou NULL se o servidor fechou. */
+static char* next_line(Conn* c) {
+    for (;;) {
+        char* start = c->in + c->in_start;
+        char* nl = memchr(start, '\n', c->in_len - c->in_start);
+        if (nl) {
+            *nl = '\0';
+            c->in_start = (size_t)(nl - c->in) + 1;
+            return start;
+        }
+        size_t rest = c->in_len - c->in_start;
+        memmove(c->in, start, rest);
+        c->in_start = 0;
+        c->in_len = rest;
+        if (rest == IO_CAP) return NULL;
+        ssize_t r = recv(c->fd, c->in + rest, IO_CAP - rest, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return NULL;
+        c->in_len += (size_t)r;
+    }
+}
+
+/* ---------- comandos ---------- */
+
+static size_t format_command(Client* cl, unsigned round, char op, size_t key, char* out, size_t cap) {
+    char cpf[15];
+    switch (op) {
+        case 'R':
+            make_cpf(cpf, patient_key(cl, round, key));
+            return (size_t)snprintf(out, cap, "R %zu|Paciente %u %zu|%s|%u|%c|gripe|%u\n",
+                                    patient_key(cl, round, key) + 1, cl->index, key, cpf,
+                                    (unsigned)(key % 90), (key & 1) ? 'M' : 'F', (unsigned)(key % 3) + 1);
+        case 'L':
+        case 'E':
+            make_cpf(cpf, patient_key(cl, round, key));
+            return (size_t)snprintf(out, cap, "%c %s\n", op, cpf);
+        default:
+            return (size_t)snprintf(out, cap, "%c\n", op);
+    }
+}
+
+/* Lê a resposta inteira do comando e confere o que dá para conferir. */
+static int read_response(Conn* conn, Client* cl, unsigned round, const InFlight* f) {
+    char* line = next_line(conn);
+    if (!line) return 0;
+    if (f->op == 'T') {  /* uma linha por prioridade e "OK <linhas>" */
+        while (strncmp(line, "OK", 2) != 0)
+            if (strncmp(line, "ERR", 3) == 0 || !(line = next_line(conn))) return 0;
+        return 1;
+    }
+    if (f->op == 'R') return strcmp(line, "OK") == 0;
+    if (f->op == 'L') {
+        char cpf[15];
+        make_cpf(cpf, patient_key(cl, round, f->key));
+        return line[0] == 'P' && strstr(line, cpf) != NULL;
+    }
+    /* E/D/U: OK, "P ..." ou ERR esperado (fila ou histórico vazio) */
+    return line[0] == 'O' || line[0] == 'P' || line[0] == 'E';
+}
+
+static char pick_op(unsigned* seed) {
+    unsigned r = rnd(seed) % 100;
+    return r < 45 ? 'L' : r < 65 ? 'E' : r < 80 ? 'D' : r < 90 ? 'R' : r < 95 ? 'U' : 'T';
+}
+
+/* Manda total comandos com até depth em voo; mede só se measure. */
+static int drive(Conn* conn, Client* cl, unsigned round, size_t total, unsigned depth,
+                 int preload, int measure) {
+    InFlight ring[MAX_DEPTH];
+    size_t head = 0, sent = 0, done = 0;
+    char buf[MAX_DEPTH * 320];
+    while (done < total) {
+        size_t len = 0;
+        uint64_t t = latency_now_ns();
+        while (sent < total && sent - done < depth) {
+            InFlight* f = &ring[sent % MAX_DEPTH];
+            f->op = preload ? 'R' : pick_op(&cl->seed);
+            if (f->op == 'R' && cl->registered == KEYS_PER_CLIENT) f->op = 'L';
+            if (f->op == 'R')      f->key = cl->registered++;
+            else if (cl->registered) f->key = rnd(&cl->seed) % cl->registered;
+            else                   f->key = 0;
+            f->sent_ns = t;
+            len += format_command(cl, round, f->op, f->key, buf + len, sizeof buf - len);
+            sent++;
+        }
+        if (len && !send_all(conn->fd, buf, len)) return 0;
+        const InFlight* f = &ring[head % MAX_DEPTH];
+        if (!read_response(conn, cl, round, f)) return 0;
+        if (measure) latency_hist_record(&cl->hist, latency_now_ns() - f->sent_ns);
+        head++;
+        done++;
+    }
+    return 1;
+}
+
+static void* client_main(void* arg) {
+    Client* cl = arg;
+    Bench* b = cl->b;
+    unsigned round = atomic_load(&b->round);
+    static _Thread_local Conn conn;
+    conn.fd = connect_unix(b->socket_path);
+    conn.in_start = conn.in_len = 0;
+    if (conn.fd < 0) { atomic_store(&b->failed, 1); return NULL; }
+    cl->registered = 0;
+    int ok = drive(&conn, cl, round, PRELOAD, b->depth, 1, 0) &&
+             drive(&conn, cl, round, b->requests, b->depth, 0, 1);
+    if (!ok) atomic_store(&b->failed, 1);
+    close(conn.fd);
+    return NULL;
+}
+
+/* ---------- servidor embutido ---------- */
+
+static AppOptions server_opt;
+
+static void* server_main(void* arg) {
+    (void)arg;
+    run_server(&server_opt);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    Bench b;
+    b.socket_path = NULL;
+    b.requests = 20000;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) b.socket_path = argv[++i];
+        else if (strcmp(argv[i], "--requests") == 0 && i + 1 < argc) b.requests = (size_t)strtoull(argv[++i], NULL, 10);
+        else { fprintf(stderr, "Uso: %s [--socket caminho] [--requests N]\n", argv[0]); return 2; }
+    }
+    if (b.requests < 100) b.requests = 100;
+    atomic_init(&b.round, 0);
+    key_base = 1 + ((size_t)getpid() * 2654435761u + (size_t)time(NULL)) % (KEY_SLOTS - 1);
+
+    pthread_t server;
+    char path[64];
+    int embedded = b.socket_path == NULL;
+    if (embedded) {
+        snprintf(path, sizeof path, "/tmp/bench_server_%ld.sock", (long)getpid());
+        memset(&server_opt, 0, sizeof server_opt);
+        server_opt.persistence = persistence_default_options();
+        server_opt.history_max = APP_DEFAULT_HISTORY_MAX;
+        server_opt.server_socket = path;
+        b.socket_path = path;
+        if (pthread_create(&server, NULL, server_main, NULL) != 0) return 2;
+    }
+
+    static Client clients[MAX_CLIENTS];
+    static LatencyHist all;
+    printf("%-8s %6s %14s %10s %10s\n", "clientes", "P", "comandos/s", "p50 µs", "p99 µs");
+    static const unsigned depths[] = { 1, MAX_DEPTH };
+    for (unsigned nc = 1; nc <= MAX_CLIENTS; nc *= 4) {
+        for (size_t di = 0; di < sizeof depths / sizeof depths[0]; di++) {
+            b.clients = nc;
+            b.depth = depths[di];
+            atomic_store(&b.failed, 0);
+            pthread_t tid[MAX_CLIENTS];
+            for (unsigned i = 0; i < nc; i++) {
+                clients[i].b = &b;
+                clients[i].index = i;
+                clients[i].seed = 0x9E3779B9u * (i + 1);
+                latency_hist_reset(&clients[i].hist);
+            }
+            double t0 = now_sec();
+            for (unsigned i = 0; i < nc; i++) pthread_create(&tid[i], NULL, client_main, &clients[i]);
+            for (unsigned i = 0; i < nc; i++) pthread_join(tid[i], NULL);
+            double secs = now_sec() - t0;
+            atomic_fetch_add(&b.round, 1);
+
+            latency_hist_reset(&all);
+            for (unsigned i = 0; i < nc; i++) latency_hist_merge(&all, &clients[i].hist);
+            if (atomic_load(&b.failed) || all.total != (uint64_t)nc * b.requests) {
+                fprintf(stderr, "FALHA: %u clientes, P = %u (resposta errada, faltando ou fora de ordem)\n",
+                        nc, b.depth);
+                if (embedded) { server_stop(); pthread_join(server, NULL); }
+                return 1;
+            }
+            printf("%-8u %6u %14.0f %10.1f %10.1f\n", nc, b.depth,
+                   (double)(nc * (b.requests + PRELOAD)) / secs,
+                   (double)latency_hist_percentile(&all, 0.50) / 1e3,
+                   (double)latency_hist_percentile(&all, 0.99) / 1e3);
+        }
+    }
+
+    if (embedded) {
+        server_stop();
+        pthread_join(server, NULL);
+    }
+    puts("conferência: OK");
+    return 0;
+}
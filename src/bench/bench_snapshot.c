@@ -0,0 +1,125 @@
+/*
+ Benchmark: partida a frio via snapshot (mmap) com 10^6 pacientes.
+
+ Monta cadastro + fila + histórico, grava com snapshot_save e mede
+ snapshot_load (mapeamento + reconstrução da lista, índice de CPF, fila
+ e pilha). O índice de nomes fica para a primeira busca por nome, medida
+ à parte. Conferência: tamanhos; fila e histórico restaurados com os
+ mesmos CPFs, na mesma ordem do que foi gravado; a primeira busca por
+ nome acha tanto um paciente do snapshot quanto um cadastrado depois.
+
+ Uso: make bench_snapshot && ./bench_snapshot [arquivo]
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+#include "util/snapshot.h"
+
+#define N_PATIENTS 1000000u
+#define N_QUEUE    100000u
+#define N_HISTORY  10000u
+
+static int cpf_is(const Patient* p, size_t i) {
+    char cpf[15];
+    snprintf(cpf, sizeof cpf, "%011u", (unsigned)i);
+    return p && strcmp(p->cpf, cpf) == 0;
+}
+
+/* Fila dos N_QUEUE primeiros: prioridade 1 (i % 3 == 0), depois 2 e 3,
+   cada nível na ordem de chegada */
+static int queue_ok(const PatientQueue* q) {
+    const QueueNode* n = queue_first(q);
+    for (size_t lv = 0; lv < QUEUE_LEVELS; lv++)
+        for (size_t i = lv; i < N_QUEUE; i += QUEUE_LEVELS, n = queue_next(q, n))
+            if (!n || !cpf_is(n->patient, i)) return 0;
+    return n == NULL;
+}
+
+/* Histórico dos N_HISTORY primeiros: o último empilhado no topo */
+static int history_ok(const HistoryStack* h) {
+    if (h->size != N_HISTORY) return 0;
+    for (size_t i = 0; i < N_HISTORY; i++)
+        if (!cpf_is(history_at(h, i)->patient, N_HISTORY - 1 - i)) return 0;
+    return 1;
+}
+
+/* Busca por nome: exatamente o paciente de cpf (nomes são únicos aqui) */
+static int finds_one(PatientList* list, const char* name, const char* cpf) {
+    NameCursor cur;
+    patient_name_search(list, name, &cur);
+    const Patient* p = name_cursor_next(&cur);
+    return p && strcmp(p->cpf, cpf) == 0 && name_cursor_next(&cur) == NULL;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_snapshot.snap";
+    PatientList list; PatientQueue queue; HistoryStack hist;
+    init_patient_list(&list);
+    init_queue(&queue);
+    init_history_stack(&hist);
+
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.age = 40; p.gender = 'M';
+    strcpy(p.condition, "Consulta de rotina");
+    for (size_t i = 0; i < N_PATIENTS; i++) {
+        p.id = (int)i + 1;
+        p.priority = (int)(i % 3) + 1;
+        snprintf(p.name, sizeof p.name, "Paciente %zu", i);
+        snprintf(p.cpf, sizeof p.cpf, "%011u", (unsigned)i);
+        insert_patient(&list, &p);
+        /* A fila e o histórico guardam o handle do cadastro, não o p local */
+        const Patient* saved = search_patient_by_CPF(&list, p.cpf);
+        if (i < N_QUEUE) enqueue(&queue, saved);
+        if (i < N_HISTORY) push_history(&hist, make_history_record(saved));
+    }
+
+    double t0 = now_sec();
+    SnapshotStatus st = snapshot_save(path, &list, &queue, &hist, 0);
+    double t_save = now_sec() - t0;
+    if (st != SNAP_OK) { fprintf(stderr, "save: %s\n", snapshot_strerror(st)); return 1; }
+
+    PatientList l2; PatientQueue q2; HistoryStack h2;
+    init_patient_list(&l2);
+    init_queue(&q2);
+    init_history_stack(&h2);
+
+    t0 = now_sec();
+    st = snapshot_load(path, &l2, &q2, &h2, NULL);
+    double t_load = now_sec() - t0;
+    if (st != SNAP_OK) { fprintf(stderr, "load: %s\n", snapshot_strerror(st)); return 1; }
+
+    /* Cadastro depois da carga, antes de qualquer busca por nome */
+    snprintf(p.name, sizeof p.name, "Zuleica Depois");
+    snprintf(p.cpf, sizeof p.cpf, "%011u", (unsigned)N_PATIENTS);
+    p.id = (int)N_PATIENTS + 1;
+    int late = insert_patient(&l2, &p);
+
+    t0 = now_sec();
+    int named = finds_one(&l2, "paciente 123456", "00000123456");
+    double t_names = now_sec() - t0;
+    named = named && late && finds_one(&l2, "zuleica", p.cpf);
+
+    int ok = named && l2.size == list.size + 1 && q2.size == queue.size && h2.size == hist.size &&
+             search_patient_by_CPF(&l2, "00000123456") != NULL &&
+             queue_ok(&queue) && queue_ok(&q2) && history_ok(&hist) && history_ok(&h2);
+
+    printf("pacientes=%zu fila=%zu historico=%zu\n", list.size, q2.size, h2.size);
+    printf("save: %.3f s   load (cold start): %.3f s   1a busca por nome: %.3f s   %s\n",
+           t_save, t_load, t_names, ok ? "conteúdo OK" : "CONTEÚDO DIVERGENTE");
+
+    free_list(&list); free_queue(&queue); free_history(&hist);
+    free_list(&l2); free_queue(&q2); free_history(&h2);
+    remove(path);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,365 @@
+/*
+ Driver de benchmarks: todas as estruturas, 10^3..10^7 elementos.
+
+ Para cada tamanho n mede:
+   insert_patient, search_patient_by_CPF (acertos em ordem aleatória),
+   enqueue, dequeue, push_history, pop_history e as listagens em modo
+   página (cadastro, fila, histórico) escrevendo em /dev/null.
+
+ Cada linha traz ns/op, alocações (malloc/calloc/realloc contados via
+ -Wl,--wrap, ver Makefile), bytes pedidos e o pico de RSS do processo que
+ rodou aquele tamanho (cada n roda num processo filho, então o pico de um
+ tamanho não contamina o próximo).
+
+ Saída CSV (padrão) ou JSON, para comparar commits. Com --baseline, compara
+ com um CSV anterior e sai com código 1 se algum caso ficou mais lento que
+ o limite (--threshold, em %) ou passou a alocar mais.
+
+ Uso: make bench && ./bench_suite [--max N] [--json] [--out arquivo]
+                                  [--baseline base.csv] [--threshold 15]
+      make bench-check BASELINE=base.csv
+
+ --max: maior n (padrão 10^6). 10^7 pacientes pedem ~7 GiB (cadastro +
+ cópias da fila); use --max 10000000 em máquinas com memória para isso.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#define NULL_DEVICE "NUL"
+#else
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#define NULL_DEVICE "/dev/null"
+#endif
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+#include "util/out_buffer.h"
+
+#define MAX_ROWS 256
+#define MAX_LOOKUPS 1000000u
+
+typedef struct {
+    char name[24];      // caso medido
+    size_t n;           // tamanho da estrutura
+    size_t ops;         // operações cronometradas
+    double ns_per_op;
+    size_t allocs;      // chamadas malloc/calloc/realloc durante o caso
+    size_t alloc_bytes; // bytes pedidos nessas chamadas
+    long peak_rss_kb;   // pico de RSS do processo até o fim do caso
+} BenchRow;
+
+/* ---------- contagem de alocações (-Wl,--wrap=malloc,...) ---------- */
+
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* p, size_t n);
+
+static size_t g_allocs, g_alloc_bytes;
+
+void* __wrap_malloc(size_t n) {
+    g_allocs++;
+    g_alloc_bytes += n;
+    return __real_malloc(n);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    g_allocs++;
+    g_alloc_bytes += n * size;
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* p, size_t n) {
+    g_allocs++;
+    g_alloc_bytes += n;
+    return __real_realloc(p, n);
+}
+
+/* ---------- medição ---------- */
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static long peak_rss_kb(void) {
+#if defined(_WIN32)
+    return 0;
+#else
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return ru.ru_maxrss; /* KiB no Linux */
+#endif
+}
+
+typedef struct {
+    double t0;
+    size_t allocs0, bytes0;
+} Probe;
+
+static Probe probe_start(void) {
+    Probe p;
+    p.allocs0 = g_allocs;
+    p.bytes0 = g_alloc_bytes;
+    p.t0 = now_sec();
+    return p;
+}
+
+static void probe_end(const Probe* p, BenchRow* rows, size_t* count,
+                      const char* name, size_t n, size_t ops) {
+    double secs = now_sec() - p->t0;
+    if (*count >= MAX_ROWS) return;
+    BenchRow* r = &rows[(*count)++];
+    memset(r, 0, sizeof *r);
+    snprintf(r->name, sizeof r->name, "%s", name);
+    r->n = n;
+    r->ops = ops;
+    r->ns_per_op = ops ? secs * 1e9 / (double)ops : 0.0;
+    r->allocs = g_allocs - p->allocs0;
+    r->alloc_bytes = g_alloc_bytes - p->bytes0;
+    r->peak_rss_kb = peak_rss_kb();
+}
+
+static void make_cpf(char out[15], size_t i) {
+    snprintf(out, 15, "%011zu", i);
+}
+
+/* Roda todos os casos para um tamanho n. Returns: linhas geradas. */
+static size_t run_size(size_t n, BenchRow* rows) {
+    size_t count = 0;
+    PatientList list; PatientQueue queue; HistoryStack hist;
+    init_patient_list(&list);
+    init_queue(&queue);
+    init_history_stack(&hist);
+
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.age = 40; p.gender = 'F';
+    strcpy(p.condition, "Retorno");
+
+    Probe pr = probe_start();
+    for (size_t i = 0; i < n; i++) {
+        p.id = (int)i + 1;
+        p.priority = (int)(i % 3) + 1;
+        snprintf(p.name, sizeof p.name, "Paciente %zu", i);
+        make_cpf(p.cpf, i);
+        insert_patient(&list, &p);
+    }
+    probe_end(&pr, rows, &count, "insert_patient", n, n);
+
+    /* Chaves prontas antes de cronometrar (formatar não é busca) */
+    size_t lookups = n < MAX_LOOKUPS ? n : MAX_LOOKUPS;
+    char (*keys)[15] = malloc(lookups * sizeof *keys);
+    const Patient** handles = malloc(n * sizeof *handles);
+    if (!keys || !handles) { free(keys); free(handles); return count; }
+    unsigned long long rng = 88172645463325252ull;
+    for (size_t i = 0; i < lookups; i++) {
+        rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+        make_cpf(keys[i], (size_t)(rng % n));
+    }
+    volatile size_t hits = 0;
+    pr = probe_start();
+    for (size_t i = 0; i < lookups; i++)
+        hits += search_patient_by_CPF(&list, keys[i]) != NULL;
+    probe_end(&pr, rows, &count, "search_patient_by_CPF", n, lookups);
+    (void)hits;
+
+    size_t i = 0;
+    for (const Node* cur = list.head; cur; cur = cur->next) handles[i++] = &cur->data;
+
+    pr = probe_start();
+    for (i = 0; i < n; i++) enqueue(&queue, handles[i]);
+    probe_end(&pr, rows, &count, "enqueue", n, n);
+
+    OutBuffer out;
+    int fd = open(NULL_DEVICE, O_WRONLY);
+    int have_out = fd >= 0 && out_open(&out, fd, 0);
+
+    if (have_out) {
+        pr = probe_start();
+        print_patient_page(&list, &out, 0, OUT_ALL);
+        out_flush(&out);
+        probe_end(&pr, rows, &count, "print_patient_page", n, n);
+
+        pr = probe_start();
+        print_queue_page(&queue, &out, 0, OUT_ALL);
+        out_flush(&out);
+        probe_end(&pr, rows, &count, "print_queue_page", n, n);
+    }
+
+    pr = probe_start();
+    for (i = 0; i < n; i++) dequeue(&queue);
+    probe_end(&pr, rows, &count, "dequeue", n, n);
+
+    pr = probe_start();
+    for (i = 0; i < n; i++) push_history(&hist, make_history_record(handles[i]));
+    probe_end(&pr, rows, &count, "push_history", n, n);
+
+    if (have_out) {
+        pr = probe_start();
+        print_history_page(&hist, &out, 0, OUT_ALL);
+        out_flush(&out);
+        probe_end(&pr, rows, &count, "print_history_page", n, n);
+        out_close(&out);
+    }
+    if (fd >= 0) close(fd);
+
+    pr = probe_start();
+    for (i = 0; i < n; i++) pop_history(&hist, NULL);
+    probe_end(&pr, rows, &count, "pop_history", n, n);
+
+    free(keys);
+    free(handles);
+    free_history(&hist);
+    free_queue(&queue);
+    free_list(&list);
+    return count;
+}
+
+/* Cada tamanho num processo filho: pico de RSS isolado por n. */
+static size_t run_isolated(size_t n, BenchRow* rows) {
+#if defined(_WIN32)
+    return run_size(n, rows);
+#else
+    int fds[2];
+    if (pipe(fds) != 0) return run_size(n, rows);
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]); close(fds[1]);
+        return run_size(n, rows);
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        size_t count = run_size(n, rows);
+        size_t bytes = count * sizeof(BenchRow), done = 0;
+        while (done < bytes) {
+            ssize_t w = write(fds[1], (const char*)rows + done, bytes - done);
+            if (w <= 0) _exit(1);
+            done += (size_t)w;
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+    size_t got = 0;
+    for (;;) {
+        ssize_t r = read(fds[0], (char*)rows + got, MAX_ROWS * sizeof(BenchRow) - got);
+        if (r <= 0) break;
+        got += (size_t)r;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        fprintf(stderr, "bench_suite: n=%zu terminou com erro (memória?)\n", n);
+    return got / sizeof(BenchRow);
+#endif
+}
+
+/* ---------- saída ---------- */
+
+static void write_csv(FILE* f, const BenchRow* rows, size_t count) {
+    fprintf(f, "case,n,ops,ns_per_op,allocs,alloc_bytes,peak_rss_kb\n");
+    for (size_t i = 0; i < count; i++)
+        fprintf(f, "%s,%zu,%zu,%.2f,%zu,%zu,%ld\n", rows[i].name, rows[i].n, rows[i].ops,
+                rows[i].ns_per_op, rows[i].allocs, rows[i].alloc_bytes, rows[i].peak_rss_kb);
+}
+
+static void write_json(FILE* f, const BenchRow* rows, size_t count) {
+    fprintf(f, "[\n");
+    for (size_t i = 0; i < count; i++)
+        fprintf(f, "  {\"case\": \"%s\", \"n\": %zu, \"ops\": %zu, \"ns_per_op\": %.2f, "
+                   "\"allocs\": %zu, \"alloc_bytes\": %zu, \"peak_rss_kb\": %ld}%s\n",
+                rows[i].name, rows[i].n, rows[i].ops, rows[i].ns_per_op, rows[i].allocs,
+                rows[i].alloc_bytes, rows[i].peak_rss_kb, i + 1 < count ? "," : "");
+    fprintf(f, "]\n");
+}
+
+/* ---------- comparação com a linha de base ---------- */
+
+/* Compara com um CSV anterior. Returns: número de regressões. */
+static size_t check_baseline(const char* path, double threshold_pct,
+                             const BenchRow* rows, size_t count) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "bench_suite: não foi possível abrir a base '%s'\n", path);
+        return 1;
+    }
+    size_t regressions = 0, compared = 0;
+    char line[256];
+    while (fgets(line, sizeof line, f)) {
+        BenchRow base;
+        memset(&base, 0, sizeof base);
+        if (sscanf(line, "%23[^,],%zu,%zu,%lf,%zu", base.name, &base.n, &base.ops,
+                   &base.ns_per_op, &base.allocs) != 5)
+            continue; /* cabeçalho ou linha estranha */
+        for (size_t i = 0; i < count; i++) {
+            const BenchRow* r = &rows[i];
+            if (r->n != base.n || strcmp(r->name, base.name) != 0) continue;
+            compared++;
+            double limit = base.ns_per_op * (1.0 + threshold_pct / 100.0);
+            if (r->ns_per_op > limit) {
+                fprintf(stderr, "REGRESSÃO %s n=%zu: %.2f ns/op (base %.2f, limite +%.0f%%)\n",
+                        r->name, r->n, r->ns_per_op, base.ns_per_op, threshold_pct);
+                regressions++;
+            }
+            if (r->allocs > base.allocs) {
+                fprintf(stderr, "REGRESSÃO %s n=%zu: %zu alocações (base %zu)\n",
+                        r->name, r->n, r->allocs, base.allocs);
+                regressions++;
+            }
+        }
+    }
+    fclose(f);
+    fprintf(stderr, "bench_suite: %zu casos comparados com '%s', %zu regressões\n",
+            compared, path, regressions);
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    size_t max_n = 1000000;
+    int json = 0;
+    const char* out_path = NULL;
+    const char* baseline = NULL;
+    double threshold = 15.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--max") == 0 && i + 1 < argc)            max_n = (size_t)strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--json") == 0)                      json = 1;
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)       out_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)  baseline = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = strtod(argv[++i], NULL);
+        else {
+            fprintf(stderr, "uso: %s [--max N] [--json] [--out arquivo] "
+                            "[--baseline base.csv] [--threshold pct]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static BenchRow rows[MAX_ROWS * 8];
+    size_t count = 0;
+    for (size_t n = 1000; n <= max_n && n <= 10000000u; n *= 10) {
+        fprintf(stderr, "bench_suite: n=%zu...\n", n);
+        count += run_isolated(n, rows + count);
+    }
+
+    FILE* f = out_path ? fopen(out_path, "w") : stdout;
+    if (!f) { fprintf(stderr, "bench_suite: não foi possível criar '%s'\n", out_path); return 2; }
+    if (json) write_json(f, rows, count);
+    else      write_csv(f, rows, count);
+    if (f != stdout) fclose(f);
+
+    if (baseline && check_baseline(baseline, threshold, rows, count)) return 1;
+    return 0;
+}
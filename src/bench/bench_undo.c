@@ -0,0 +1,152 @@
+/*
+ Teste de estresse: atender / desfazer atendimento.
+
+ 10^6 operações aleatórias (dequeue + push_history, undo_last_service e,
+ de vez em quando, enqueue de um paciente do cadastro). Depois de CADA
+ passo a fila real é comparada, nó a nó, com um modelo simples (um vetor
+ por nível de prioridade) e o topo do histórico com uma pilha de ids.
+
+ Sai com código 1 na primeira divergência.
+
+ Uso: make bench_undo && ./bench_undo [operações] [semente]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+
+#define N_PATIENTS 1000
+#define MODEL_CAP  128    /* enqueue só abaixo disso: cada conferência é O(tamanho) */
+
+/* Modelo: ids por nível, do próximo a ser atendido ao último */
+/* Desfazer devolve à fila quem saiu, então ela pode passar de MODEL_CAP;
+   acima de 2 * MODEL_CAP o passo vira atendimento */
+static int model[QUEUE_LEVELS][2 * MODEL_CAP];
+static size_t model_len[QUEUE_LEVELS];
+/* Histórico do modelo: id e nível de cada atendimento */
+static int* hist_id;
+static int* hist_level;
+static size_t hist_len;
+
+static unsigned long long rng_state;
+
+static unsigned rnd(void) {
+    rng_state = rng_state * 6364136223846793005ull + 1442695040888963407ull;
+    return (unsigned)(rng_state >> 33);
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static size_t model_size(void) {
+    return model_len[0] + model_len[1] + model_len[2];
+}
+
+/* Compara a fila real com o modelo. Returns: 1 igual, 0 divergente. */
+static int check(const PatientQueue* q, const HistoryStack* h) {
+    if (q->size != model_size() || h->size != hist_len) return 0;
+    const QueueNode* node = queue_first(q);
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        for (size_t i = 0; i < model_len[lv]; i++) {
+            if (!node || node->patient->id != model[lv][i] ||
+                node->patient->priority != lv + 1)
+                return 0;
+            node = queue_next(q, node);
+        }
+    }
+    if (node) return 0;
+    if (hist_len) {
+        const HistoryRecord* top = history_at(h, 0);
+        if (!top->patient || top->patient->id != hist_id[hist_len - 1] ||
+            top->level != hist_level[hist_len - 1])
+            return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    size_t ops = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 1000000u;
+    rng_state = argc > 2 ? strtoull(argv[2], NULL, 10) : 42u;
+
+    PatientList list; PatientQueue queue; HistoryStack hist;
+    init_patient_list(&list);
+    init_queue(&queue);
+    init_history_stack(&hist);
+    hist_id = malloc(ops * sizeof *hist_id);
+    hist_level = malloc(ops * sizeof *hist_level);
+    if (!hist_id || !hist_level) { fprintf(stderr, "sem memória\n"); return 2; }
+
+    const Patient* registry[N_PATIENTS];
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.age = 30; p.gender = 'F';
+    for (int i = 0; i < N_PATIENTS; i++) {
+        p.id = i + 1;
+        p.priority = i % QUEUE_LEVELS + 1;
+        snprintf(p.name, sizeof p.name, "Paciente %d", i);
+        snprintf(p.cpf, sizeof p.cpf, "%011d", i);
+        insert_patient(&list, &p);
+        registry[i] = search_patient_by_CPF(&list, p.cpf);
+    }
+
+    size_t n_deq = 0, n_undo = 0, n_enq = 0;
+    double t0 = now_sec();
+    for (size_t step = 0; step < ops; step++) {
+        unsigned r = rnd() % 100;
+        if (r < 20 && model_size() < MODEL_CAP) {           /* enqueue */
+            const Patient* pp = registry[rnd() % N_PATIENTS];
+            int lv = pp->priority - 1;
+            enqueue(&queue, pp);
+            model[lv][model_len[lv]++] = pp->id;
+            n_enq++;
+        } else if (r < 60 || model_size() >= 2 * MODEL_CAP) { /* atender */
+            const Patient* out = dequeue(&queue);
+            if (out) {
+                HistoryRecord rec = make_history_record(out);
+                rec.level = (unsigned char)out->priority;
+                push_history(&hist, rec);
+
+                int lv = 0;
+                while (model_len[lv] == 0) lv++;
+                hist_id[hist_len] = model[lv][0];
+                hist_level[hist_len++] = lv + 1;
+                memmove(model[lv], model[lv] + 1, --model_len[lv] * sizeof(int));
+                n_deq++;
+            }
+        } else {                                             /* desfazer */
+            UndoStatus st = undo_last_service(&hist, &queue, NULL);
+            if (st == UNDO_OK) {
+                int lv = hist_level[--hist_len] - 1;
+                memmove(model[lv] + 1, model[lv], model_len[lv]++ * sizeof(int));
+                model[lv][0] = hist_id[hist_len];
+                n_undo++;
+            } else if (st != UNDO_EMPTY || hist_len) {
+                fprintf(stderr, "passo %zu: undo falhou (%d)\n", step, (int)st);
+                return 1;
+            }
+        }
+
+        if (!check(&queue, &hist)) {
+            fprintf(stderr, "passo %zu: fila/histórico divergem do modelo\n", step);
+            return 1;
+        }
+    }
+    double secs = now_sec() - t0;
+
+    printf("operações=%zu atendimentos=%zu desfeitos=%zu enfileirados=%zu fila_final=%zu\n",
+           ops, n_deq, n_undo, n_enq, queue.size);
+    printf("ordem conferida a cada passo: OK (%.3f s, incluindo as conferências)\n", secs);
+
+    free(hist_id); free(hist_level);
+    free_list(&list);
+    free_queue(&queue);
+    free_history(&hist);
+    return 0;
+}
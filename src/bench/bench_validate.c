@@ -0,0 +1,168 @@
+/*
+ Benchmark + conferência: validação/normalização em lote (importação).
+
+ Gera 10^6 registros (~1 em 8 inválido, com todos os motivos de recusa) e
+ mede, em registros por µs:
+   - um a um com mensagem (patient_normalize + patient_validate, o caminho
+     antigo do importador);
+   - um a um só com código (patient_check, sem snprintf);
+   - em lote (patient_normalize_batch + patient_validate_batch) no pool
+     padrão, que divide o vetor entre as threads.
+ Confere que os códigos do lote são os de patient_check e que o motivo é o
+ mesmo de uma validação de referência escrita com os ifs originais.
+
+ Uso: make bench_validate && ./bench_validate
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "model/patient.h"
+#include "model/cpf.h"
+#include "util/thread_pool.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long rng_state = 0x9E3779B97F4A7C15ull;
+
+static size_t rnd(size_t n) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return (size_t)(rng_state % n);
+}
+
+/* CPF válido derivado de i ("ddd.ddd.ddd-dd" ou só dígitos) */
+static void make_cpf(char out[15], size_t i, int punct) {
+    int d[11];
+    size_t base = 100000000u + i % 900000000u;
+    for (int k = 8; k >= 0; k--) { d[k] = (int)(base % 10); base /= 10; }
+    for (int k = 9; k <= 10; k++) {
+        int sum = 0;
+        for (int j = 0; j < k; j++) sum += d[j] * (k + 1 - j);
+        d[k] = sum * 10 % 11 % 10;
+    }
+    size_t n = 0;
+    for (int k = 0; k < 11; k++) {
+        if (punct && (k == 3 || k == 6)) out[n++] = '.';
+        if (punct && k == 9) out[n++] = '-';
+        out[n++] = (char)('0' + d[k]);
+    }
+    out[n] = '\0';
+}
+
+static void make_patient(Patient* p, size_t i) {
+    memset(p, 0, sizeof *p);
+    p->id = (int)i + 1;
+    snprintf(p->name, sizeof p->name, "Paciente Numero %zu da Silva", i);
+    make_cpf(p->cpf, i * 7919, (int)(i & 1));
+    p->age = (int)(i % 100);
+    p->gender = (i & 2) ? 'm' : 'F';
+    p->priority = (int)(i % 3) + 1;
+    strcpy(p->condition, "Consulta de rotina");
+
+    if (rnd(8) != 0) return;
+    switch (rnd(10)) {
+        case 0: p->id = 0; break;
+        case 1: strcpy(p->name, " \t  "); break;
+        case 2: memset(p->name, ' ', sizeof p->name - 1); p->name[sizeof p->name - 1] = '\0'; break;
+        case 3: p->age = 131; break;
+        case 4: p->gender = 'X'; break;
+        case 5: p->priority = 4; break;
+        case 6: p->cpf[0] = '\0'; break;
+        case 7: strcpy(p->cpf, "123.456"); break;
+        case 8: p->cpf[strlen(p->cpf) - 1] ^= 1; break; /* DV errado */
+        default: p->id = -1; p->age = -1; break;     /* vale a primeira regra */
+    }
+}
+
+/* Referência: as regras como eram escritas antes (um if por regra). */
+static int ref_blank(const char* s) {
+    if (!*s) return 1;
+    for (; *s; s++) if (!isspace((unsigned char)*s)) return 0;
+    return 1;
+}
+
+static PatientError ref_check(const Patient* p) {
+    if (p->id <= 0) return PATIENT_ERR_ID;
+    if (ref_blank(p->name)) return PATIENT_ERR_NAME;
+    if (p->age < 0 || p->age > 130) return PATIENT_ERR_AGE;
+    if (p->gender != 'M' && p->gender != 'F') return PATIENT_ERR_GENDER;
+    if (p->priority < 1 || p->priority > 3) return PATIENT_ERR_PRIORITY;
+    if (ref_blank(p->cpf)) return PATIENT_ERR_CPF_BLANK;
+    CpfStatus st = cpf_canonicalize(p->cpf, NULL);
+    if (st == CPF_ERR_FORMAT) return PATIENT_ERR_CPF_FORMAT;
+    if (st == CPF_ERR_CHECK) return PATIENT_ERR_CPF_CHECK;
+    return PATIENT_OK;
+}
+
+int main(void) {
+    const size_t n = 1000000;
+    Patient* src = malloc(n * sizeof *src);
+    Patient* work = malloc(n * sizeof *work);
+    uint8_t* codes = malloc(n);
+    if (!src || !work || !codes) return 2;
+    for (size_t i = 0; i < n; i++) make_patient(&src[i], i);
+
+    printf("registros: %zu, threads no pool: %u\n\n", n, thread_pool_width(thread_pool_default()));
+    printf("%-28s %12s %10s\n", "caminho", "reg/µs", "recusados");
+
+    /* Um a um, com mensagem */
+    memcpy(work, src, n * sizeof *work);
+    size_t bad_single = 0;
+    char msg[64];
+    double t0 = now_sec();
+    for (size_t i = 0; i < n; i++) {
+        patient_normalize(&work[i]);
+        bad_single += !patient_validate(&work[i], msg, sizeof msg);
+    }
+    printf("%-28s %12.2f %10zu\n", "um a um (validate+msg)", (double)n / ((now_sec() - t0) * 1e6), bad_single);
+
+    /* Um a um, só código */
+    memcpy(work, src, n * sizeof *work);
+    size_t bad_check = 0;
+    t0 = now_sec();
+    for (size_t i = 0; i < n; i++) {
+        patient_normalize(&work[i]);
+        bad_check += patient_check(&work[i]) != PATIENT_OK;
+    }
+    printf("%-28s %12.2f %10zu\n", "um a um (check)", (double)n / ((now_sec() - t0) * 1e6), bad_check);
+
+    /* Em lote, no pool */
+    memcpy(work, src, n * sizeof *work);
+    t0 = now_sec();
+    patient_normalize_batch(work, n);
+    size_t bad_batch = patient_validate_batch(work, n, codes);
+    printf("%-28s %12.2f %10zu\n", "lote (pool)", (double)n / ((now_sec() - t0) * 1e6), bad_batch);
+
+    /* Conferência */
+    if (bad_single != bad_batch || bad_check != bad_batch) {
+        fputs("FALHA: contagens de recusados diferentes\n", stderr);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        Patient ref = src[i];
+        patient_normalize(&ref);
+        if (memcmp(&ref, &work[i], sizeof ref) != 0) {
+            fprintf(stderr, "FALHA: normalização em lote diferente (registro %zu)\n", i);
+            return 1;
+        }
+        PatientError want = ref_check(&ref);
+        if (codes[i] != want || patient_check(&ref) != want) {
+            fprintf(stderr, "FALHA: registro %zu: lote=%s referência=%s\n", i,
+                    patient_strerror((PatientError)codes[i]), patient_strerror(want));
+            return 1;
+        }
+    }
+    if (patient_check(NULL) != PATIENT_ERR_NULL) { fputs("FALHA: NULL\n", stderr); return 1; }
+
+    free(src);
+    free(work);
+    free(codes);
+    puts("conferência: OK");
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ Benchmark + conferência: histogramas de espera da fila (latency_hist).
+
+ 1) Precisão: 10^6 durações log-uniformes (1 ns .. ~3 h); p50/p90/p99/p99.9
+    do histograma x os valores exatos (vetor ordenado). O histograma nunca
+    fica abaixo do exato e erra menos de 1/16 para cima; o máximo é exato.
+ 2) Custo: latency_hist_record, latency_now_ns e enqueue/dequeue com a
+    medição da espera ligada (10^6 pacientes).
+ 3) Contagem: chegadas, atendidos e desistências por nível batem com o que
+    foi feito na fila; o desfazer (enqueue_front) não conta como chegada.
+
+ Uso: make bench_wait_stats && ./bench_wait_stats
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_queue.h"
+#include "util/latency_hist.h"
+#include "util/out_buffer.h"
+
+static unsigned long long rng_state = 0x2545F4914F6CDD1Dull;
+
+static uint64_t rnd64(void) {
+    rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Amostra de ordem ceil(q * n) (1-based), a mesma regra do histograma */
+static uint64_t exact_percentile(const uint64_t* sorted, size_t n, double q) {
+    size_t rank = (size_t)(q * (double)n);
+    if ((double)rank < q * (double)n || rank == 0) rank++;
+    return sorted[rank - 1];
+}
+
+static int check_accuracy(size_t n) {
+    static LatencyHist h;
+    uint64_t* v = malloc(n * sizeof *v);
+    if (!v) return 0;
+    latency_hist_reset(&h);
+    for (size_t i = 0; i < n; i++) {
+        /* log-uniforme: expoente em [0, 43) bits e mantissa aleatória */
+        unsigned bits = (unsigned)(rnd64() % 43);
+        v[i] = (rnd64() >> (64 - bits - 1)) | 1u;
+        latency_hist_record(&h, v[i]);
+    }
+    qsort(v, n, sizeof *v, cmp_u64);
+
+    static const double qs[] = { 0.50, 0.90, 0.99, 0.999, 1.0 };
+    printf("%-8s %20s %20s %10s\n", "perc.", "exato (ns)", "histograma (ns)", "erro");
+    int ok = h.total == n && h.max == v[n - 1];
+    for (size_t i = 0; i < sizeof qs / sizeof qs[0]; i++) {
+        uint64_t want = exact_percentile(v, n, qs[i]);
+        uint64_t got = latency_hist_percentile(&h, qs[i]);
+        printf("p%-7g %20llu %20llu %9.2f%%\n", qs[i] * 100, (unsigned long long)want,
+               (unsigned long long)got, want ? 100.0 * (double)(got - want) / (double)want : 0.0);
+        if (got < want || got - want > want / 16) ok = 0;
+    }
+    free(v);
+    return ok;
+}
+
+static void make_patient(Patient* p, int id) {
+    memset(p, 0, sizeof *p);
+    p->id = id;
+    snprintf(p->name, sizeof p->name, "Paciente %d", id);
+    snprintf(p->cpf, sizeof p->cpf, "%011d", id);
+    p->age = 40;
+    p->gender = 'M';
+    p->priority = id % QUEUE_LEVELS + 1;
+}
+
+int main(void) {
+    if (!check_accuracy(1000000)) { fputs("FALHA: percentis fora da tolerância\n", stderr); return 1; }
+    puts("precisão: OK\n");
+
+    /* Custo de registrar e de ler o relógio */
+    const size_t reps = 10000000;
+    static LatencyHist h;
+    latency_hist_reset(&h);
+    double t0 = now_sec();
+    for (size_t i = 0; i < reps; i++) latency_hist_record(&h, rnd64() >> (rnd64() & 31));
+    double rec_ns = (now_sec() - t0) * 1e9 / (double)reps;
+    volatile uint64_t sink = 0;
+    t0 = now_sec();
+    for (size_t i = 0; i < reps; i++) sink += latency_now_ns();
+    double clk_ns = (now_sec() - t0) * 1e9 / (double)reps;
+    (void)sink;
+
+    /* Fila com a medição ligada */
+    const size_t n = 1000000;
+    Patient* registry = malloc(n * sizeof *registry);
+    if (!registry) return 2;
+    for (size_t i = 0; i < n; i++) make_patient(&registry[i], (int)i + 1);
+    PatientQueue q;
+    init_queue(&q);
+    t0 = now_sec();
+    for (size_t i = 0; i < n; i++)
+        if (!enqueue(&q, &registry[i])) return 2;
+    double enq_ns = (now_sec() - t0) * 1e9 / (double)n;
+    t0 = now_sec();
+    for (size_t i = 0; i < n / 2; i++) dequeue(&q);
+    double deq_ns = (now_sec() - t0) * 1e9 / (double)(n / 2);
+
+    printf("%-32s %8.1f ns\n", "latency_hist_record", rec_ns);
+    printf("%-32s %8.1f ns\n", "latency_now_ns", clk_ns);
+    printf("%-32s %8.1f ns  (n = %zu)\n", "enqueue (marca a chegada)", enq_ns, n);
+    printf("%-32s %8.1f ns\n", "dequeue (registra a espera)", deq_ns);
+
+    /* Contagens: n chegadas, n/2 saídas, desistências dos últimos 1000 ainda
+       na fila (o nível 1 já saiu todo), 1 desfazer */
+    size_t cancelled = 0;
+    for (size_t i = n - 1000; i < n; i++) cancelled += queue_remove_cpf(&q, registry[i].cpf) != NULL;
+    const Patient* back = dequeue(&q);
+    enqueue_front(&q, back);
+    uint64_t arrivals = 0, served = 0, cancels = 0;
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        arrivals += q.stats.arrivals[lv];
+        served += q.stats.wait[lv].total;
+        cancels += q.stats.cancels[lv];
+    }
+    if (arrivals != n || served != n / 2 + 1 || cancels != cancelled || cancelled == 0) {
+        fputs("FALHA: contagens de chegadas/atendidos/desistências\n", stderr);
+        return 1;
+    }
+    /* Nível 1 é atendido primeiro: todos os seus saíram antes dos outros */
+    if (q.stats.wait[0].total != n / QUEUE_LEVELS || q.count[0] != 0) {
+        fputs("FALHA: atendidos por nível\n", stderr);
+        return 1;
+    }
+
+    putchar('\n');
+    fflush(stdout);
+    OutBuffer* out = out_stdout();
+    print_queue_stats(&q, out);
+    out_flush(out);
+
+    queue_stats_reset(&q);
+    if (q.stats.wait[0].total || q.stats.arrivals[1] || latency_hist_percentile(&q.stats.wait[2], 0.5)) {
+        fputs("FALHA: queue_stats_reset\n", stderr);
+        return 1;
+    }
+    free_queue(&q);
+    free(registry);
+    puts("conferência: OK");
+    return 0;
+}
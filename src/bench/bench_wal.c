@@ -0,0 +1,81 @@
+/*
+ Benchmark: vazão do WAL com e sem group commit.
+
+ Cada operação = mutação em memória + registro no WAL (cadastro, enfileirar,
+ atender), como fazem os controllers. Compara janela 0 (um fsync por
+ operação) com janelas de group commit de 1, 5 e 20 ms.
+
+ Uso: make bench_wal && ./bench_wal [arquivo]
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "util/wal.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void run(const char* path, unsigned window_ms, size_t ops) {
+    PatientList list; PatientQueue queue; Wal wal;
+    init_patient_list(&list);
+    init_queue(&queue);
+    remove(path);
+
+    WalConfig cfg = wal_default_config();
+    cfg.group_window_ms = window_ms;
+    if (!wal_open(&wal, path, cfg, 1)) { fprintf(stderr, "wal_open falhou\n"); return; }
+
+    Patient p;
+    memset(&p, 0, sizeof p);
+    p.age = 50; p.gender = 'F';
+    strcpy(p.name, "Paciente de teste");
+    strcpy(p.condition, "Retorno");
+
+    double t0 = now_sec();
+    for (size_t i = 0; i < ops; i++) {
+        switch (i % 3) {
+            case 0:
+                p.id = (int)i + 1;
+                p.priority = (int)(i % 3) + 1;
+                snprintf(p.cpf, sizeof p.cpf, "%011u", (unsigned)i);
+                insert_patient(&list, &p);
+                wal_log_register(&wal, &p);
+                break;
+            case 1:
+                enqueue(&queue, &list.head->data); /* handle do último inserido (cabeça) */
+                wal_log_enqueue(&wal, p.cpf);
+                break;
+            default: {
+                const Patient* out = dequeue(&queue);
+                wal_log_dequeue(&wal, out ? queue_level_of(out) : 0);
+            }
+        }
+    }
+    wal_sync(&wal);
+    double secs = now_sec() - t0;
+    size_t syncs = wal.syncs;
+    wal_close(&wal);
+
+    printf("%10u %10zu %10zu %14.0f %12.1f\n", window_ms, ops, syncs,
+           (double)ops / secs, secs * 1e6 / (double)ops);
+
+    free_list(&list);
+    free_queue(&queue);
+    remove(path);
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_wal.log";
+    printf("%10s %10s %10s %14s %12s\n", "janela_ms", "ops", "fsyncs", "ops/s", "us/op");
+    run(path, 0, 3000);      /* sem group commit: 1 fsync por operação */
+    run(path, 1, 300000);
+    run(path, 5, 300000);
+    run(path, 20, 300000);
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ Módulo: patient_store.c
+ Papel:  Cadastro em layout hot/cold (structure-of-arrays + vetor frio).
+
+ Decisões:
+   - Vetores quentes e frios crescem juntos (dobram) com realloc; como tudo
+     é endereçado por índice, mover os dados não invalida nada.
+   - Duas tabelas hash de endereçamento aberto (CPF compacto e id), com
+     sondagem linear e carga <= 50%. O slot guarda a chave e o índice + 1
+     (0 marca slot vazio), então a busca não toca nos vetores.
+   - A inserção reserva tudo antes de escrever: se faltar memória, o store
+     fica como estava.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "patient_store.h"
+#include "ds/cpf_index.h"
+
+#define STORE_MIN_CAP 16
+
+struct StoreSlot {
+    uint64_t key;   // CPF compacto ou (uint32) id
+    uint32_t pos;   // índice + 1 (0 => vazio)
+};
+
+/* Mistura multiplicativa (Fibonacci) para espalhar chaves sequenciais */
+static size_t slot_of(uint64_t key, size_t cap) {
+    key ^= key >> 29;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(key >> 32) & (cap - 1);
+}
+
+static StoreSlot* probe(StoreSlot* slots, size_t cap, uint64_t key) {
+    size_t i = slot_of(key, cap);
+    while (slots[i].pos && slots[i].key != key) i = (i + 1) & (cap - 1);
+    return &slots[i];
+}
+
+static uint64_t id_key(int id) {
+    return (uint64_t)(uint32_t)id;
+}
+
+void init_patient_store(PatientStore* store) {
+    memset(store, 0, sizeof *store);
+}
+
+static int grow_vectors(PatientStore* s, size_t cap) {
+    /* Cada realloc bem-sucedido já vale (o vetor só fica maior que s->cap) */
+    int32_t* id = realloc(s->id, cap * sizeof *id);
+    if (!id) return 0;
+    s->id = id;
+    uint64_t* cpf = realloc(s->cpf_key, cap * sizeof *cpf);
+    if (!cpf) return 0;
+    s->cpf_key = cpf;
+    unsigned char* pr = realloc(s->priority, cap * sizeof *pr);
+    if (!pr) return 0;
+    s->priority = pr;
+    PatientCold* cold = realloc(s->cold, cap * sizeof *cold);
+    if (!cold) return 0;
+    s->cold = cold;
+    s->cap = cap;
+    return 1;
+}
+
+static int grow_slots(PatientStore* s, size_t slot_cap) {
+    StoreSlot* cpf = calloc(slot_cap, sizeof *cpf);
+    StoreSlot* ids = calloc(slot_cap, sizeof *ids);
+    if (!cpf || !ids) { free(cpf); free(ids); return 0; }
+    for (size_t i = 0; i < s->count; i++) {
+        uint32_t pos = (uint32_t)(i + 1);
+        StoreSlot* a = probe(cpf, slot_cap, s->cpf_key[i]);
+        a->key = s->cpf_key[i];
+        a->pos = pos;
+        StoreSlot* b = probe(ids, slot_cap, id_key(s->id[i]));
+        b->key = id_key(s->id[i]);
+        b->pos = pos;
+    }
+    free(s->cpf_slots);
+    free(s->id_slots);
+    s->cpf_slots = cpf;
+    s->id_slots = ids;
+    s->slot_cap = slot_cap;
+    return 1;
+}
+
+int reserve_patient_store(PatientStore* store, size_t n) {
+    if (n > UINT32_MAX - 1) return 0;
+    if (n > store->cap && !grow_vectors(store, n)) return 0;
+    size_t slot_cap = store->slot_cap ? store->slot_cap : STORE_MIN_CAP;
+    while (n * 2 > slot_cap) slot_cap *= 2;
+    return slot_cap == store->slot_cap ? 1 : grow_slots(store, slot_cap);
+}
+
+int store_insert_patient(PatientStore* store, const Patient* p) {
+    uint64_t key;
+    if (!store || !p || !cpf_pack_key(p->cpf, &key)) return 0;
+    if (store_find_cpf_key(store, key) != STORE_NONE) return 0;
+    if (store_find_id(store, p->id) != STORE_NONE) return 0;
+
+    size_t n = store->count;
+    if (n == store->cap && !reserve_patient_store(store, n ? n * 2 : STORE_MIN_CAP)) return 0;
+    if ((n + 1) * 2 > store->slot_cap && !reserve_patient_store(store, n + 1)) return 0;
+
+    store->id[n] = p->id;
+    store->cpf_key[n] = key;
+    store->priority[n] = (unsigned char)p->priority;
+    PatientCold* c = &store->cold[n];
+    memcpy(c->name, p->name, sizeof c->name);
+    memcpy(c->condition, p->condition, sizeof c->condition);
+    c->age = p->age;
+    c->gender = p->gender;
+
+    StoreSlot* a = probe(store->cpf_slots, store->slot_cap, key);
+    a->key = key;
+    a->pos = (uint32_t)(n + 1);
+    StoreSlot* b = probe(store->id_slots, store->slot_cap, id_key(p->id));
+    b->key = id_key(p->id);
+    b->pos = (uint32_t)(n + 1);
+    store->count++;
+    return 1;
+}
+
+size_t store_find_cpf_key(const PatientStore* store, uint64_t key) {
+    if (!store->count) return STORE_NONE;
+    const StoreSlot* s = probe(store->cpf_slots, store->slot_cap, key);
+    return s->pos ? (size_t)s->pos - 1 : STORE_NONE;
+}
+
+size_t store_find_cpf(const PatientStore* store, const char* cpf) {
+    uint64_t key;
+    if (!cpf || !cpf_pack_key(cpf, &key)) return STORE_NONE;
+    return store_find_cpf_key(store, key);
+}
+
+size_t store_find_id(const PatientStore* store, int id) {
+    if (!store->count) return STORE_NONE;
+    const StoreSlot* s = probe(store->id_slots, store->slot_cap, id_key(id));
+    return s->pos ? (size_t)s->pos - 1 : STORE_NONE;
+}
+
+void store_get_patient(const PatientStore* store, size_t i, Patient* out) {
+    const PatientCold* c = &store->cold[i];
+    out->id = store->id[i];
+    cpf_unpack_key(store->cpf_key[i], out->cpf);
+    out->priority = store->priority[i];
+    memcpy(out->name, c->name, sizeof out->name);
+    memcpy(out->condition, c->condition, sizeof out->condition);
+    out->age = c->age;
+    out->gender = c->gender;
+}
+
+void free_patient_store(PatientStore* store) {
+    free(store->id);
+    free(store->cpf_key);
+    free(store->priority);
+    free(store->cold);
+    free(store->cpf_slots);
+    free(store->id_slots);
+    init_patient_store(store);
+}
@@ -0,0 +1,79 @@
+#ifndef PATIENT_STORE_H
+#define PATIENT_STORE_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t, int32_t */
+#include "model/patient.h"
+
+/*
+  Modo de armazenamento "hot/cold" do cadastro (alternativa ao Node da
+  PatientList). Protótipo medido pelo bench_hotcold: fica em src/bench/,
+  fora da libclinic.
+
+  No Node, cada paciente ocupa ~340 bytes contíguos e qualquer varredura
+  arrasta name[100] e condition[200] pela cache, mesmo quando só precisa de
+  cpf, id e prioridade. Aqui o cadastro é separado em:
+    - campos QUENTES em vetores paralelos (structure-of-arrays): id,
+      CPF compacto de 64 bits (cpf_pack_key) e prioridade — 13 bytes por
+      paciente, lidos em sequência;
+    - campos FRIOS (nome, condição, idade, sexo) num vetor à parte,
+      endereçado pelo mesmo índice, só tocado quando o paciente é exibido.
+  Busca por CPF e por id: tabelas hash de endereçamento aberto que guardam
+  o índice do paciente (a chave de CPF fica no slot, sem strcmp).
+
+  Os dados são endereçados por ÍNDICE (0..count-1), não por ponteiro: os
+  vetores crescem com realloc. Para ler um paciente inteiro há a cópia
+  preenchida (store_get_patient), num Patient de quem chama. O CPF
+  devolvido é a chave normalizada (só dígitos).
+*/
+
+#define STORE_NONE ((size_t)-1)  /* "não encontrado" nas buscas */
+
+typedef struct {
+    char name[100];
+    char condition[200];
+    int age;
+    char gender;
+} PatientCold;
+
+typedef struct StoreSlot StoreSlot; /* slot das tabelas hash (definido no .c) */
+
+typedef struct {
+    size_t count;            // pacientes armazenados
+    size_t cap;              // capacidade dos vetores abaixo
+
+    /* Quentes (SoA) */
+    int32_t* id;
+    uint64_t* cpf_key;       // cpf_pack_key (nunca 0)
+    unsigned char* priority; // 1..3
+
+    /* Frios, mesmo índice */
+    PatientCold* cold;
+
+    /* Índices: chave -> posição */
+    StoreSlot* cpf_slots;
+    StoreSlot* id_slots;
+    size_t slot_cap;         // potência de 2 (as duas tabelas têm o mesmo tamanho)
+} PatientStore;
+
+void init_patient_store(PatientStore* store);
+
+/* Pré-dimensiona vetores e tabelas para n pacientes. Returns: 1 ok, 0 sem memória. */
+int reserve_patient_store(PatientStore* store, size_t n);
+
+/* Copia p para o store. Recusa CPF não numérico (sem chave compacta),
+   CPF ou id repetidos e falta de memória (nada muda).
+   Returns: 1 se inseriu, 0 caso contrário. */
+int store_insert_patient(PatientStore* store, const Patient* p);
+
+/* Buscas. Returns: índice do paciente ou STORE_NONE. */
+size_t store_find_cpf(const PatientStore* store, const char* cpf);
+size_t store_find_cpf_key(const PatientStore* store, uint64_t key);
+size_t store_find_id(const PatientStore* store, int id);
+
+/* Preenche out com o paciente i (i < count). */
+void store_get_patient(const PatientStore* store, size_t i, Patient* out);
+
+void free_patient_store(PatientStore* store);
+
+#endif /* PATIENT_STORE_H */
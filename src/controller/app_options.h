@@ -0,0 +1,20 @@
+#ifndef APP_OPTIONS_H
+#define APP_OPTIONS_H
+
+#include <stddef.h>
+#include "lib/clinic.h"
+
+/* Limite padrão do histórico em anel (registros mais antigos são descartados). */
+#define APP_DEFAULT_HISTORY_MAX CLINIC_DEFAULT_HISTORY_MAX
+
+/* Opções de linha de comando repassadas aos controllers (menu, batch e servidor). */
+typedef struct {
+    PersistenceOptions persistence; // snapshot / WAL
+    size_t history_max;             // K do histórico (0 = ilimitado)
+    char import_gender;             // sexo padrão na importação sem coluna sexo (0 = obrigatório)
+    uint64_t max_wait_ns[QUEUE_LEVELS]; // envelhecimento da fila (0 = sem limite; tudo 0 = estrita)
+    const char* server_socket;      // modo servidor: socket Unix (NULL = sem)
+    unsigned server_port;           // modo servidor: TCP em 127.0.0.1 (0 = sem)
+} AppOptions;
+
+#endif /* APP_OPTIONS_H */
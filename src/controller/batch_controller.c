@@ -0,0 +1,436 @@
+/*
+===============================================================================
+ Módulo: batch_controller.c
+ Papel:  Controller não interativo. Executa um roteiro de comandos (replay
+         do dia, testes de carga) pela MESMA libclinic do menu (lib/clinic.h),
+         mas sem prompts e sem scanf/fgets por campo.
+
+ Entrada: LineReader (fread em blocos de 1 MiB, linhas parseadas no lugar).
+ Saída:   OutBuffer da saída padrão (1 MiB, um write(2) por flush) — uma
+          resposta por comando; A/F/H listam em modo página.
+===============================================================================
+*/
+
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "batch_controller.h"
+#include "util/line_reader.h"
+#include "util/out_buffer.h"
+#include "util/patient_import.h"
+#include "lib/clinic.h"
+#include "model/patient.h"
+
+/* Sessão do modo batch (o processo roda OU menu OU batch/servidor). */
+static clinic_ctx* batch_clinic;
+static char batch_default_gender;  /* --import-gender */
+
+/* Separa o próximo campo delimitado por '|' (modifica a linha no lugar). */
+static char* next_field(char** cursor) {
+    char* start = *cursor;
+    if (!start) return NULL;
+    char* bar = strchr(start, '|');
+    if (bar) { *bar = '\0'; *cursor = bar + 1; }
+    else     { *cursor = NULL; }
+    return start;
+}
+
+/* Inteiro no começo de s; *end aponta logo depois. Fora do int => 0. */
+static int parse_int_prefix(const char* s, int* out, char** end) {
+    errno = 0;
+    long v = strtol(s, end, 10);
+    if (*end == s || errno == ERANGE || v < INT_MIN || v > INT_MAX) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+/* Campo inteiro inteiro: nada sobrando depois do número. */
+static int parse_int(const char* s, int* out) {
+    char* end;
+    if (!s || !*s) return 0;
+    return parse_int_prefix(s, out, &end) && *end == '\0';
+}
+
+/* Copia com truncamento seguro para os campos de tamanho fixo do Patient. */
+static void copy_field(char* dst, size_t cap, const char* src) {
+    size_t n = strlen(src);
+    if (n >= cap) n = cap - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+}
+
+/* Saída de todas as respostas (ver out_buffer.h) */
+static OutBuffer* batch_out;
+
+static void emit_ok(void) {
+    out_write(batch_out, "OK\n", 3);
+}
+
+static void emit_patient(const Patient* p) {
+    OutBuffer* o = batch_out;
+    out_write(o, "P ", 2);
+    out_int(o, p->id);        out_char(o, '|');
+    out_str(o, p->name);      out_char(o, '|');
+    out_str(o, p->cpf);       out_char(o, '|');
+    out_int(o, p->age);       out_char(o, '|');
+    out_char(o, p->gender);   out_char(o, '|');
+    out_str(o, p->condition); out_char(o, '|');
+    out_int(o, p->priority);  out_char(o, '\n');
+}
+
+static int emit_error(size_t line_no, const char* msg) {
+    out_write(batch_out, "ERR ", 4);
+    out_u64(batch_out, line_no);
+    out_char(batch_out, ' ');
+    out_str(batch_out, msg);
+    out_char(batch_out, '\n');
+    return 0;
+}
+
+/* "[offset [limit]]" dos comandos de listagem. Returns: 1 ok, 0 inválido. */
+static int parse_page(const char* args, size_t* offset, size_t* limit) {
+    *offset = 0;
+    *limit = OUT_ALL;
+    char* end;
+    while (*args == ' ') args++;
+    if (!*args) return 1;
+    *offset = (size_t)strtoull(args, &end, 10);
+    if (end == args) return 0;
+    args = end;
+    while (*args == ' ') args++;
+    if (!*args) return 1;
+    *limit = (size_t)strtoull(args, &end, 10);
+    if (end == args) return 0;
+    while (*end == ' ') end++;
+    return *end == '\0';
+}
+
+/* A|F|H [offset [limit]]: cadastro, fila ou histórico em modo página.
+   Resposta: as linhas da página seguidas de "OK <linhas>". */
+static int cmd_list(char op, const char* args, size_t line_no) {
+    size_t offset, limit, n;
+    if (!parse_page(args, &offset, &limit)) return emit_error(line_no, "página inválida");
+    if (op == 'A')      n = print_patient_page(clinic_patients(batch_clinic), batch_out, offset, limit);
+    else if (op == 'F') n = print_queue_page(clinic_queue(batch_clinic), batch_out, offset, limit);
+    else                n = print_history_page(clinic_history(batch_clinic), batch_out, offset, limit);
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, n);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+/* R id|nome|cpf|idade|sexo|condicao|prioridade */
+static int cmd_register(char* args, size_t line_no) {
+    Patient p;
+    memset(&p, 0, sizeof p);
+    char* cur = args;
+    char* f_id = next_field(&cur);
+    char* f_name = next_field(&cur);
+    char* f_cpf = next_field(&cur);
+    char* f_age = next_field(&cur);
+    char* f_gender = next_field(&cur);
+    char* f_cond = next_field(&cur);
+    char* f_prio = next_field(&cur);
+
+    if (!f_prio || cur) return emit_error(line_no, "R espera 7 campos");
+    if (!parse_int(f_id, &p.id) || !parse_int(f_age, &p.age) ||
+        !parse_int(f_prio, &p.priority))
+        return emit_error(line_no, "campo numérico inválido");
+
+    copy_field(p.name, sizeof p.name, f_name);
+    copy_field(p.cpf, sizeof p.cpf, f_cpf);
+    copy_field(p.condition, sizeof p.condition, f_cond);
+    p.gender = f_gender[0];
+
+    PatientError why;
+    clinic_status st = clinic_register(batch_clinic, &p, NULL, &why);
+    if (st == CLINIC_ERR_INVALID) return emit_error(line_no, patient_strerror(why));
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_ok();
+    return 1;
+}
+
+static int cmd_lookup(const char* cpf, size_t line_no) {
+    const Patient* p = clinic_find_cpf(batch_clinic, cpf);
+    if (!p) return emit_error(line_no, clinic_strerror(CLINIC_ERR_NOT_FOUND));
+    emit_patient(p);
+    return 1;
+}
+
+/* G id: busca pelo id (índice ordenado). */
+static int cmd_get_by_id(const char* args, size_t line_no) {
+    int id;
+    if (!parse_int(args, &id)) return emit_error(line_no, "G espera um id");
+    const Patient* p = clinic_find_id(batch_clinic, id);
+    if (!p) return emit_error(line_no, "id não encontrado");
+    emit_patient(p);
+    return 1;
+}
+
+/* B a b: pacientes com id em [a, b], em ordem de id, e "OK <quantidade>". */
+static int cmd_id_range(char* args, size_t line_no) {
+    char* end;
+    int lo, hi;
+    if (!parse_int_prefix(args, &lo, &end) || !parse_int_prefix(end, &hi, &end))
+        return emit_error(line_no, "B espera dois ids");
+    while (*end == ' ' || *end == '\t') end++;
+    if (*end != '\0') return emit_error(line_no, "B espera dois ids");
+
+    size_t n = 0;
+    IdCursor cur = clinic_id_range(batch_clinic, lo, hi);
+    for (const Patient* p; (p = id_cursor_next(&cur)) != NULL; n++) emit_patient(p);
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, n);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+/* N texto: pacientes com uma palavra do nome começando por texto (sem
+   acento/caixa), em ordem alfabética, e "OK <quantidade>". */
+static int cmd_name_search(const char* query, size_t line_no) {
+    if (!*query) return emit_error(line_no, "N espera um nome");
+    size_t n = 0;
+    NameCursor cur;
+    clinic_name_search(batch_clinic, query, &cur);
+    for (const Patient* p; (p = name_cursor_next(&cur)) != NULL; n++) emit_patient(p);
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, n);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+static int cmd_enqueue(const char* cpf, size_t line_no) {
+    clinic_status st = clinic_enqueue(batch_clinic, cpf, NULL);
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_ok();
+    return 1;
+}
+
+/* X cpf: paciente desistiu; sai da fila sem passar pelo histórico. */
+static int cmd_cancel(const char* cpf, size_t line_no) {
+    const Patient* p;
+    clinic_status st = clinic_cancel(batch_clinic, cpf, &p);
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_patient(p);
+    return 1;
+}
+
+/* W cpf: posição na fila ("OK <posição>", 1 = próximo). */
+static int cmd_position(const char* cpf, size_t line_no) {
+    size_t pos = clinic_position(batch_clinic, cpf);
+    if (!pos) return emit_error(line_no, clinic_strerror(CLINIC_ERR_NOT_QUEUED));
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, pos);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+/* T: estatísticas de espera, uma linha por prioridade, e "OK <linhas>". */
+static int cmd_stats(void) {
+    size_t n = print_queue_stats(clinic_queue(batch_clinic), batch_out);
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, n);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+/* Atende o próximo e registra no histórico (permite desfazer). */
+static int cmd_dequeue(size_t line_no) {
+    const Patient* p;
+    clinic_status st = clinic_dequeue(batch_clinic, &p);
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_patient(p);
+    return 1;
+}
+
+/* Desfaz o último atendimento: o paciente volta para o início do seu nível. */
+static int cmd_undo(size_t line_no) {
+    HistoryRecord rec;
+    clinic_status st = clinic_undo(batch_clinic, &rec);
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_patient(rec.patient);
+    return 1;
+}
+
+/* S [arquivo]: grava snapshot (padrão: o --snapshot da linha de comando). */
+static int cmd_save(const char* path, size_t line_no) {
+    if (!*path) path = clinic_persistence(batch_clinic)->opt.snapshot_path;
+    if (!path) return emit_error(line_no, "S sem arquivo e sem --snapshot");
+    SnapshotStatus snap;
+    if (clinic_save(batch_clinic, path, &snap) != CLINIC_OK)
+        return emit_error(line_no, snapshot_strerror(snap));
+    emit_ok();
+    return 1;
+}
+
+/* O arquivo: substitui o estado atual pelo snapshot.
+   Com WAL ligado, o log antigo não vale mais para o novo estado: faz um
+   checkpoint no snapshot oficial logo em seguida. */
+static int cmd_open(const char* path, size_t line_no) {
+    if (!*path) return emit_error(line_no, "O espera um arquivo");
+    SnapshotStatus snap;
+    clinic_status st = clinic_load(batch_clinic, path, &snap);
+    if (st == CLINIC_ERR_ARG) return emit_error(line_no, "O com --wal exige --snapshot");
+    if (st == CLINIC_ERR_SNAPSHOT) return emit_error(line_no, snapshot_strerror(snap));
+    if (st != CLINIC_OK) return emit_error(line_no, clinic_strerror(st));
+    emit_ok();
+    return 1;
+}
+
+/* Erros por linha do arquivo importado: "ERR <linha do comando> <linha do arquivo>: motivo" */
+static void import_error(void* ctx, size_t file_line, const char* msg) {
+    size_t line_no = *(const size_t*)ctx;
+    out_write(batch_out, "ERR ", 4);
+    out_u64(batch_out, line_no);
+    out_char(batch_out, ' ');
+    out_u64(batch_out, file_line);
+    out_write(batch_out, ": ", 2);
+    out_str(batch_out, msg);
+    out_char(batch_out, '\n');
+}
+
+/* I arquivo: importação em massa (CSV ou JSONL pela extensão).
+   Resposta: um ERR por linha rejeitada e "OK <importados> <rejeitados>". */
+static int cmd_import(const char* path, size_t line_no) {
+    if (!*path) return emit_error(line_no, "I espera um arquivo");
+    FILE* f = fopen(path, "rb");
+    if (!f) return emit_error(line_no, "não foi possível abrir o arquivo");
+
+    ImportOptions opt = import_default_options();
+    opt.format = import_format_from_path(path);
+    opt.default_gender = batch_default_gender;
+    ImportSink sink = { &line_no, import_error, NULL };
+    ImportStats st;
+    clinic_status rc = clinic_import(batch_clinic, f, &opt, &sink, &st);
+    fclose(f);
+    if (rc != CLINIC_OK) return emit_error(line_no, clinic_strerror(rc));
+
+    out_write(batch_out, "OK ", 3);
+    out_u64(batch_out, st.imported);
+    out_char(batch_out, ' ');
+    out_u64(batch_out, st.rejected);
+    out_char(batch_out, '\n');
+    return 1;
+}
+
+static int dispatch(char* line, size_t line_no) {
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '\0' || *line == '#') return -1; /* nada a fazer */
+
+    char op = line[0];
+    char* args = line + 1;
+    while (*args == ' ' || *args == '\t') args++;
+
+    switch (op) {
+        case 'R': return cmd_register(args, line_no);
+        case 'L': return cmd_lookup(args, line_no);
+        case 'G': return cmd_get_by_id(args, line_no);
+        case 'B': return cmd_id_range(args, line_no);
+        case 'N': return cmd_name_search(args, line_no);
+        case 'E': return cmd_enqueue(args, line_no);
+        case 'D': return cmd_dequeue(line_no);
+        case 'X': return cmd_cancel(args, line_no);
+        case 'W': return cmd_position(args, line_no);
+        case 'T': return cmd_stats();
+        case 'U': return cmd_undo(line_no);
+        case 'S': return cmd_save(args, line_no);
+        case 'O': return cmd_open(args, line_no);
+        case 'I': return cmd_import(args, line_no);
+        case 'A':
+        case 'F':
+        case 'H': return cmd_list(op, args, line_no);
+        default:  return emit_error(line_no, "comando desconhecido");
+    }
+}
+
+int batch_session_open(const AppOptions* opt) {
+    batch_default_gender = opt ? opt->import_gender : 0;
+
+    clinic_options copt = clinic_default_options();
+    if (opt) {
+        copt.persistence = opt->persistence;
+        copt.history_max = opt->history_max;
+        memcpy(copt.max_wait_ns, opt->max_wait_ns, sizeof copt.max_wait_ns);
+    }
+    clinic_status st = clinic_create(&copt, &batch_clinic);
+    if (batch_clinic) persistence_print_report(clinic_persistence(batch_clinic), stderr);
+    if (st != CLINIC_OK) {
+        if (st == CLINIC_ERR_NOMEM) fprintf(stderr, "batch: %s\n", clinic_strerror(st));
+        clinic_destroy(batch_clinic);
+        batch_clinic = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+int batch_session_exec(char* line, size_t line_no, OutBuffer* out) {
+    batch_out = out;
+    return dispatch(line, line_no);
+}
+
+int batch_session_sync(void) {
+    return clinic_sync(batch_clinic) == CLINIC_OK;
+}
+
+void batch_session_close(void) {
+    clinic_destroy(batch_clinic);
+    batch_clinic = NULL;
+}
+
+int run_batch(const char* path, const AppOptions* opt) {
+    FILE* in = stdin;
+    if (path && strcmp(path, "-") != 0) {
+        in = fopen(path, "rb");
+        if (!in) {
+            fprintf(stderr, "batch: não foi possível abrir '%s'\n", path);
+            return 2;
+        }
+    }
+
+    LineReader reader;
+    if (!line_reader_open(&reader, in, 0)) {
+        fprintf(stderr, "batch: sem memória para o buffer de entrada\n");
+        if (in != stdin) fclose(in);
+        return 2;
+    }
+    OutBuffer* out = out_stdout();
+
+    if (!batch_session_open(opt)) {
+        line_reader_close(&reader);
+        if (in != stdin) fclose(in);
+        return 2;
+    }
+
+    size_t ops = 0, errors = 0;
+    clock_t t0 = clock();
+
+    char* line;
+    while ((line = line_reader_next(&reader, NULL)) != NULL) {
+        if (reader.truncated) {
+            batch_out = out;
+            emit_error(reader.line_no, "linha longa demais");
+            errors++;
+            continue;
+        }
+        int r = batch_session_exec(line, reader.line_no, out);
+        if (r < 0) continue;
+        ops++;
+        if (!r) errors++;
+    }
+
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    out_flush(out);
+    int durable = batch_session_sync();
+    if (!durable) fprintf(stderr, "batch: falha ao gravar o WAL; operações podem não estar no log\n");
+    fprintf(stderr, "batch: %zu comandos, %zu erros, %.3f s de CPU (%.0f ops/s)\n",
+            ops, errors, secs, secs > 0 ? (double)ops / secs : 0.0);
+
+    batch_session_close();
+    line_reader_close(&reader);
+    if (in != stdin) fclose(in);
+    if (!durable) return 2;
+    return errors ? 1 : 0;
+}
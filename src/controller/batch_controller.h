@@ -0,0 +1,68 @@
+#ifndef BATCH_CONTROLLER_H
+#define BATCH_CONTROLLER_H
+
+#include "app_options.h"
+#include "util/out_buffer.h"
+
+/*
+  Modo batch (não interativo): lê comandos de um arquivo (ou stdin quando
+  path é NULL ou "-") e executa contra as estruturas reais, sem prompts.
+
+  Protocolo (uma operação por linha, campos separados por '|'):
+    R id|nome|cpf|idade|sexo|condicao|prioridade   cadastrar paciente
+    L cpf                                          buscar por CPF
+    G id                                           buscar por id
+    B a b                                          pacientes com id em [a, b] (ordem de id)
+    N texto                                        busca por prefixo de nome (sem acento/caixa)
+    E cpf                                          colocar na fila
+    D                                              chamar próximo
+    X cpf                                          tirar da fila (desistência)
+    W cpf                                          posição na fila (1 = próximo)
+    T                                              estatísticas de espera por prioridade
+    U                                              desfazer último atendimento
+    S [arquivo]                                    salvar snapshot (atômico)
+    O arquivo                                      carregar snapshot (substitui o estado)
+    I arquivo                                      importar CSV/JSONL (ver patient_import.h)
+    A|F|H [offset [limit]]                         listar cadastro | fila | histórico,
+                                                   só as linhas [offset, offset+limit)
+    # ...                                          comentário (linha vazia também é ignorada)
+
+  Respostas (stdout): "OK", "P id|nome|cpf|idade|sexo|condicao|prioridade"
+  ou "ERR <linha> <motivo>"; listagens terminam com "OK <linhas>"; W responde
+  "OK <posição>"; T responde uma linha por nível ("Prioridade n: chegadas ...
+  | atendidos ... | desistências ... | na fila ... | espera ...") e
+  "OK <níveis>"; X responde o "P ..." de quem saiu; I responde um ERR por linha
+  rejeitada e "OK <importados> <rejeitados>". Resumo com tempo e ops/s vai para stderr.
+
+  opt (opcional): snapshot/WAL restaurados antes do primeiro comando; cada
+  mutação é registrada no WAL e "S" sem argumento grava no snapshot. Se o
+  WAL não aceitar o registro, a mutação vale em memória e a resposta é
+  "ERR <linha> aplicado, mas não gravado no WAL".
+  opt->history_max limita o histórico (undo alcança só os K últimos).
+
+  Returns: 0 se todos os comandos rodaram, 1 se houve erro de algum comando,
+           2 se não foi possível abrir a entrada ou abrir/gravar o WAL.
+*/
+int run_batch(const char* path, const AppOptions* opt);
+
+/*
+  Sessão de comandos sem a leitura do arquivo, para o modo servidor: o
+  mesmo estado (um por processo) e o mesmo protocolo de run_batch.
+*/
+
+/* Cria o estado e restaura snapshot/WAL de opt. Returns: 1 ok, 0 falha
+   (mensagem em stderr). */
+int batch_session_open(const AppOptions* opt);
+
+/* Executa uma linha do protocolo (modificada no lugar), respostas em out.
+   line_no vai nos "ERR <linha>". Returns: 1 ok, 0 erro do comando,
+   -1 linha vazia ou comentário. */
+int batch_session_exec(char* line, size_t line_no, OutBuffer* out);
+
+/* Grava no disco o que o WAL tem pendente (group commit por rodada).
+   Returns: 1 ok, 0 falha de E/S (pendentes continuam para a próxima vez). */
+int batch_session_sync(void);
+
+void batch_session_close(void);
+
+#endif /* BATCH_CONTROLLER_H */
@@ -16,10 +16,9 @@
         Declara utilitários de entrada (ex.: read_int_in_range(), press_enter()).
    - "util/patient_io.h":
         Funções de leitura/escrita de pacientes.
-   - "ds/patient_list.h":
-        PatientList, insert/print/search/free.
-   - "ds/patient_queue.h":
-        Fila de pacientes.
+   - "lib/clinic.h":
+        libclinic: cadastro, fila, histórico e snapshot/WAL atrás de um
+        handle (clinic_ctx); o menu só lê o console e imprime.
    - "model/patient.h":
         Struct Patient.
 ===============================================================================
@@ -32,100 +31,195 @@
 #include "view/menu_view.h"
 #include "util/input.h"
 #include "util/patient_io.h"
-#include "ds/patient_list.h"
-#include "ds/patient_queue.h"
+#include "util/patient_import.h"
+#include "lib/clinic.h"
 #include "model/patient.h"
 
 /* ------------------------------
    Submenus internos (helpers)
+   O estado (cadastro, fila, histórico, WAL) vive no clinic_ctx criado em
+   run_main_menu e passado a cada submenu.
 ------------------------------ */
-static void run_patient_menu(void);
-static void run_queue_menu(void);
-static void run_history_menu(void);
+static void run_patient_menu(clinic_ctx* clinic);
+static void run_queue_menu(clinic_ctx* clinic);
+static void run_history_menu(clinic_ctx* clinic);
 
-/* Lista global de pacientes */
-static PatientList global_patient_list;
-static int g_inited = 0;
+/* Arquivo de snapshot usado pela opção "Salvar" do menu principal */
+#define DEFAULT_SNAPSHOT_PATH "clinic.snap"
+static const char* g_snapshot_path = DEFAULT_SNAPSHOT_PATH;
 
-/* Fila global de pacientes */
-static PatientQueue global_patient_queue;
+/* Grava os pendentes do WAL antes de esperar o usuário; avisa se o disco falhou */
+static void sync_wal(clinic_ctx* clinic) {
+    if (clinic_sync(clinic) != CLINIC_OK)
+        puts("-> Atenção: falha ao gravar o WAL; as últimas operações podem não estar no log.");
+}
+
+/* A operação valeu em memória? CLINIC_ERR_IO também: só não foi para o WAL */
+static int applied(clinic_status st) {
+    if (st == CLINIC_ERR_IO)
+        puts("-> Atenção: operação feita, mas não gravada no WAL (pode se perder ao reiniciar).");
+    return st == CLINIC_OK || st == CLINIC_ERR_IO;
+}
+
+/* Sexo assumido na importação de arquivos sem essa coluna (--import-gender) */
+static char g_import_gender = 0;
 
 /* =========================
    Função de teste rápido
    ========================= */
-static void quick_test_patients(void) {
-    if (g_inited) return; // Se já foi inicializado, não faz nada.
-
-    // Se não foi, agora sim inicializa tudo aqui dentro
-    init_patient_list(&global_patient_list);
-    init_queue(&global_patient_queue);
-
+static void quick_test_patients(clinic_ctx* clinic) {
     Patient test_data[] = {
-        {1, "Alice", "111", 30, 'F', "Normal", 3},
-        {2, "Bob", "222", 25, 'M', "Urgente", 1},
-        {3, "Carol", "333", 40, 'F', "Média", 2}
+        {1, "Alice", "52998224725", 30, 'F', "Normal", 3},
+        {2, "Bob", "11144477735", 25, 'M', "Urgente", 1},
+        {3, "Carol", "12345678909", 40, 'F', "Média", 2}
     };
     int num_patients = sizeof(test_data) / sizeof(Patient);
 
     puts("-> Carregando pacientes de teste na lista e na fila...");
     for (int i = 0; i < num_patients; i++) {
-        // 1. Adiciona à lista geral
-        insert_patient(&global_patient_list, &test_data[i]);
-
-        // 2. Cria uma cópia para a fila
-        Patient *copy = malloc(sizeof(Patient));
-        if (copy) {
-            *copy = test_data[i];
-            // 3. Adiciona a cópia na fila de atendimento
-            enqueue(&global_patient_queue, copy);
-        }
+        // 1. Adiciona à lista geral; 2. e na fila de atendimento
+        if (applied(clinic_register(clinic, &test_data[i], NULL, NULL)))
+            clinic_enqueue(clinic, test_data[i].cpf, NULL);
     }
     puts("-> Pacientes de teste carregados!\n");
+}
 
-    // Define a flag APENAS NO FINAL de tudo.
-    g_inited = 1;
+/* =========================
+   Snapshot (persistência)
+   ========================= */
+static void save_snapshot(clinic_ctx* clinic) {
+    SnapshotStatus st;
+    if (clinic_save(clinic, g_snapshot_path, &st) == CLINIC_OK)
+        printf("\nEstado salvo em '%s'.\n", g_snapshot_path);
+    else
+        printf("\nFalha ao salvar '%s': %s.\n", g_snapshot_path, snapshot_strerror(st));
 }
 
 /* =========================
-   Inicialização leve (sem dados de teste)
+   Importação em massa (CSV/JSONL)
    ========================= */
-static void ensure_initialized(void) {
-    if (g_inited) return;
-    init_patient_list(&global_patient_list);
-    init_queue(&global_patient_queue);
-    g_inited = 1;
+#define IMPORT_MAX_SHOWN_ERRORS 20
+
+static void import_error(void* ctx, size_t line, const char* msg) {
+    size_t* shown = ctx;
+    if ((*shown)++ < IMPORT_MAX_SHOWN_ERRORS)
+        printf("  linha %zu: %s\n", line, msg);
+}
+
+static void import_file(clinic_ctx* clinic) {
+    char path[512];
+    printf("Arquivo (.csv ou .jsonl): ");
+    if (!read_line(path, sizeof path) || !*path) {
+        puts("\nEntrada cancelada.");
+        return;
+    }
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("\nNão foi possível abrir '%s'.\n", path);
+        return;
+    }
+
+    ImportOptions opt = import_default_options();
+    opt.format = import_format_from_path(path);
+    opt.default_gender = g_import_gender;
+    size_t shown = 0;
+    ImportSink sink = { &shown, import_error, NULL };
+    ImportStats st;
+    clinic_status rc = clinic_import(clinic, f, &opt, &sink, &st);
+    fclose(f);
+
+    if (shown > IMPORT_MAX_SHOWN_ERRORS)
+        printf("  ... e mais %zu erros.\n", shown - IMPORT_MAX_SHOWN_ERRORS);
+    if (!applied(rc)) puts("\nImportação interrompida (cabeçalho inválido ou falta de memória).");
+    printf("\n%zu registros lidos: %zu importados, %zu rejeitados.\n",
+           st.rows, st.imported, st.rejected);
 }
 
 /* =========================
    Loop do menu principal
    ========================= */
-void run_main_menu(void) {
-    // Apenas chama a função de inicialização.
-    // Ela mesma vai garantir que só roda uma vez, na ordem certa.
-    
-    ensure_initialized(); // Chama se sem teste
-    // quick_test_patients(); // Chama se com teste
+/*
+  Busca por nome: mostra NAME_PAGE resultados por vez (ordem alfabética).
+  O cursor do índice continua de onde parou, então cada página custa só
+  as linhas exibidas, não uma nova varredura.
+*/
+#define NAME_PAGE 20
+
+static void search_by_name(clinic_ctx* clinic) {
+    char query[100];
+    printf("Nome (ou começo do nome/sobrenome): ");
+    if (!read_line(query, sizeof query)) return;
+
+    NameCursor cur;
+    clinic_name_search(clinic, query, &cur);
+    OutBuffer *out = out_stdout();
+    size_t found = 0;
+    const Patient *p = name_cursor_next(&cur);
+    while (p) {
+        for (size_t i = 0; p && i < NAME_PAGE; i++, found++, p = name_cursor_next(&cur))
+            out_patient_line(out, p);
+        out_flush(out);
+        if (!p) break;
+        char answer[8];
+        printf("-- ENTER para mais resultados, 0 para parar: ");
+        if (!read_line(answer, sizeof answer) || answer[0] == '0') return;
+    }
+    if (!found) puts("\nNenhum paciente com esse nome.");
+}
+
+int run_main_menu(const AppOptions* opt) {
+    // Histórico em anel (só os K atendimentos mais recentes) e
+    // envelhecimento da fila vêm da linha de comando
+    clinic_options copt = clinic_default_options();
+    if (opt) {
+        copt.persistence = opt->persistence;
+        copt.history_max = opt->history_max;
+        memcpy(copt.max_wait_ns, opt->max_wait_ns, sizeof copt.max_wait_ns);
+        g_import_gender = opt->import_gender;
+    }
+
+    // Com --snapshot/--wal, o estado salvo é restaurado e "Salvar" grava nele
+    if (opt && opt->persistence.snapshot_path) g_snapshot_path = opt->persistence.snapshot_path;
+    clinic_ctx *clinic;
+    clinic_status st = clinic_create(&copt, &clinic);
+    if (!clinic) {
+        puts("Erro de memória!");
+        return 1;
+    }
+    persistence_print_report(clinic_persistence(clinic), stdout);
+    if (st == CLINIC_ERR_SNAPSHOT) {
+        // Seguir vazio e salvar depois apagaria o snapshot bom
+        puts("-> Encerrando sem abrir o menu: confira o arquivo de snapshot.");
+        clinic_destroy(clinic);
+        return 1;
+    }
+    if (st == CLINIC_ERR_WAL)
+        puts("-> Atenção: operações desta sessão NÃO serão registradas no WAL.");
+
+    // quick_test_patients(clinic); // Descomente para começar com dados de teste
 
     for (;;) {
         show_main_menu();
-        int option = read_int_in_range("Escolha uma opção [1-3,9]: ", 1, 9);
+        int option = read_int_in_range("Escolha uma opção [1-4,9]: ", 1, 9);
 
         switch (option) {
             case 1: 
-                run_patient_menu();
+                run_patient_menu(clinic);
                 break;
             case 2:     
-                run_queue_menu();
+                run_queue_menu(clinic);
                 break;
             case 3:     
-                run_history_menu();
+                run_history_menu(clinic);
+                break;
+            case 4:
+                save_snapshot(clinic);
                 break;
             case 9:
                 puts("Encerrando o sistema. Até mais!");
                 // Adicionando a liberação de memória para evitar vazamentos
-                free_list(&global_patient_list);
-                free_queue(&global_patient_queue);
-                return;
+                clinic_destroy(clinic);
+                return 0;
             default:
                 puts("Opção inválida.");
         }
@@ -135,10 +229,10 @@ void run_main_menu(void) {
 /* =========================
    Submenu: Pacientes (Lista)
 ========================= */
-static void run_patient_menu(void) {
+static void run_patient_menu(clinic_ctx* clinic) {
     for (;;) {
         show_patient_menu();
-        int option = read_int_in_range("Escolha uma opção [1-3,9]: ", 1, 9);
+        int option = read_int_in_range("Escolha uma opção [1-6,9]: ", 1, 9);
         if (option == 9) break;
 
         switch (option) {
@@ -147,13 +241,16 @@ static void run_patient_menu(void) {
                 printf("\nCadastrando paciente -\n");
                 printf("\nInsira as informações solicitadas abaixo:\n");
                 if (read_patient_from_console(&p)) {
-                    
-                    if (insert_patient(&global_patient_list, &p)) {
+                    const Patient *saved;
+                    PatientError why;
+                    clinic_status st = clinic_register(clinic, &p, &saved, &why);
+                    if (applied(st)) {
                         puts("\nPaciente cadastrado com sucesso.");
-                        print_patient_line(&p);
+                        print_patient_line(saved);
                         puts(""); // Pulo de linha simples
                     } else {
-                        puts("\nFalha ao cadastrar (CPF/ID já existente ou erro de memória).");
+                        printf("\nFalha ao cadastrar (%s).\n", st == CLINIC_ERR_INVALID
+                               ? patient_strerror(why) : clinic_strerror(st));
                     }
                 } else {
                     puts("\nEntrada cancelada ou dados inválidos.");
@@ -162,29 +259,45 @@ static void run_patient_menu(void) {
             }
             case 2:
                 // INTERTRAVAMENTO: bloqueia se a lista de pacientes estiver vazia 
-                if (is_patient_list_empty(&global_patient_list)) {
+                if (is_patient_list_empty(clinic_patients(clinic))) {
                     puts("\nNenhum paciente cadastrado. Use a opção de cadastro para incluir pacientes.\n");
                     break;
                 }
 
-                print_all_patient(&global_patient_list);
+                print_all_patient(clinic_patients(clinic));
                 puts(""); // Pulo de linha simples
                 break;
             case 3: {
                 char cpf[15];
                 if (read_cpf_from_console(cpf, sizeof cpf)) {
-                    const Patient *found = search_patient_by_CPF(&global_patient_list, cpf);
+                    const Patient *found = clinic_find_cpf(clinic, cpf);
                     if (found) print_patient_line(found);
                     else puts("\nCPF não encontrado.\n");
                 }
                 break;
             }
-            // case 4:
-            //     puts("[TODO] Remover paciente da fila por CPF");
-            //     break;
+            case 4:
+                import_file(clinic);
+                break;
+            case 5: { // Busca por id ou faixa [de, até] no índice ordenado
+                int lo = read_int_in_range("ID inicial: ", 1, 2147483647);
+                int hi = read_int_in_range("ID final (igual ao inicial = busca única): ", lo, 2147483647);
+                OutBuffer *out = out_stdout();
+                size_t found = 0;
+                IdCursor cur = clinic_id_range(clinic, lo, hi);
+                for (const Patient *p; (p = id_cursor_next(&cur)) != NULL; found++)
+                    out_patient_line(out, p);
+                out_flush(out);
+                if (!found) puts("\nNenhum paciente com ID na faixa informada.");
+                break;
+            }
+            case 6:
+                search_by_name(clinic);
+                break;
             default:
                 puts("Opção inválida.");
         }
+        sync_wal(clinic); // nada pendente enquanto espera o usuário
         press_enter(NULL);
     }
 }
@@ -198,85 +311,107 @@ static void run_patient_menu(void) {
   Returns:
     os dados dos pacientes contidos na lista de atendimento.
 */
-static void print_queue(PatientQueue *queue) {
+static void print_queue(const PatientQueue *queue) {
     if (is_queue_empty(queue)) {
         puts("\nFila de atendimento está vazia.\n");
         return;
     }
 
-    printf("\n========== FILA DE ATENDIMENTO ==========\n");
-    QueueNode *curr = queue->front;
-    int pos = 1;
-    while (curr) {
-        printf("%d) ", pos++);
-        print_patient_line(curr->patient); // Usando a função de impressão padrão
-        curr = curr->next;
-    }
-    printf("=========================================\n");
+    OutBuffer *out = out_stdout();
+    out_str(out, "\n========== FILA DE ATENDIMENTO ==========\n");
+    // Percorre os níveis de prioridade na ordem de atendimento
+    print_queue_page(queue, out, 0, OUT_ALL);
+    out_str(out, "=========================================\n");
+    out_flush(out);
 }
 
 /* =========================
    Submenu: Fila de Atendimento (Queue)
 ========================= */
-static void run_queue_menu(void) {
+static void run_queue_menu(clinic_ctx* clinic) {
     for (;;) {
         show_queue_menu();
-        int option = read_int_in_range("Escolha uma opção [1-3,9]: ", 1, 9);
+        int option = read_int_in_range("Escolha uma opção [1-6,9]: ", 1, 9);
         if (option == 9) break;
 
         switch (option) {
             case 1: { // Adicionar paciente à fila
 
                 // INTERTRAVAMENTO: bloqueia se a lista estiver vazia
-                if (is_patient_list_empty(&global_patient_list)) {
+                if (is_patient_list_empty(clinic_patients(clinic))) {
                     puts("\nNenhum paciente cadastrado. Use o menu 1 (Cadastro) para incluir pacientes.\n");
                     break;
                 }
 
                 puts("=== Pacientes disponíveis na lista ===");
-                print_all_patient(&global_patient_list);
+                print_all_patient(clinic_patients(clinic));
 
                 char cpf[15];
                 if (read_cpf_from_console(cpf, sizeof cpf)) {
-                    const Patient *p = search_patient_by_CPF(&global_patient_list, cpf);
-                    if (p) {
-                        Patient *copy = malloc(sizeof(Patient));
-                        if (!copy) {
-                            puts("Erro de memória!");
-                            break;
-                        }
-                        *copy = *p;
-                        // Chama a nova função corrigida
-                        enqueue(&global_patient_queue, copy);
-                        printf(" Paciente '%s' adicionado à fila (prioridade %d).\n", copy->name, copy->priority);
-                    } else {
+                    const Patient *p;
+                    clinic_status st = clinic_enqueue(clinic, cpf, &p);
+                    if (applied(st))
+                        printf(" Paciente '%s' adicionado à fila (prioridade %d).\n", p->name, p->priority);
+                    else if (st == CLINIC_ERR_NOMEM)
+                        puts("Erro: falha ao alocar memória para o novo nó da fila.");
+                    else
                         puts("CPF não encontrado.");
-                    }
                 }
                 break;
             }
             case 2: { // Chamar próximo paciente
-                // USA A FUNÇÃO DEQUEUE SEGURA, QUE JÁ EXISTE NO SEU patient_queue.c
-                Patient *p = dequeue(&global_patient_queue);
-
-                if (p) {
+                // Sai da fila e entra no histórico (clinic_dequeue)
+                const Patient *p;
+                clinic_status st = clinic_dequeue(clinic, &p);
+                if (applied(st)) {
                     printf("\n Chamando próximo paciente:\n");
                     print_patient_line(p);
-                    free(p); // Libera a memória da CÓPIA do paciente
+                } else if (st == CLINIC_ERR_NOMEM) {
+                    puts("Erro: falha ao alocar memória para histórico; paciente continua na fila.");
                 } else {
                     puts("\nFila vazia.\n");
                 }
                 break;
             }
             case 3:
-                print_queue(&global_patient_queue);
+                print_queue(clinic_queue(clinic));
+                break;
+            case 4: { // Remover paciente da fila por CPF (desistência)
+                if (is_queue_empty(clinic_queue(clinic))) {
+                    puts("\nFila vazia.\n");
+                    break;
+                }
+                char cpf[15];
+                if (read_cpf_from_console(cpf, sizeof cpf)) {
+                    const Patient *p;
+                    if (applied(clinic_cancel(clinic, cpf, &p))) {
+                        printf(" Paciente '%s' removido da fila.\n", p->name);
+                    } else {
+                        puts("CPF não está na fila.");
+                    }
+                }
+                break;
+            }
+            case 5: { // Posição na fila
+                char cpf[15];
+                if (read_cpf_from_console(cpf, sizeof cpf)) {
+                    size_t pos = clinic_position(clinic, cpf);
+                    if (pos) printf(" Posição na fila: %zu de %zu.\n", pos, clinic_queue(clinic)->size);
+                    else     puts("CPF não está na fila.");
+                }
+                break;
+            }
+            case 6: { // Tempos de espera por prioridade
+                OutBuffer *out = out_stdout();
+                out_str(out, "\n========== TEMPOS DE ESPERA ==========\n");
+                print_queue_stats(clinic_queue(clinic), out);
+                out_flush(out);
                 break;
-            // case 4:
-            //     puts("[TODO] Remover paciente da fila por CPF");
-            //     break;
+            }
             default:
                 puts("Opção inválida.");
         }
+        sync_wal(clinic); // nada pendente enquanto espera o usuário
         press_enter(NULL);
     }
 }
@@ -284,7 +419,7 @@ static void run_queue_menu(void) {
 /* =========================
    Submenu: Histórico (Pilha/Stack)
 ========================= */
-static void run_history_menu(void) {
+static void run_history_menu(clinic_ctx* clinic) {
     for (;;) {
         show_history_menu();
         int option = read_int_in_range("Escolha uma opção [1-2,9]: ", 1, 9);
@@ -292,14 +427,32 @@ static void run_history_menu(void) {
 
         switch (option) {
             case 1: 
-                puts("[TODO] Visualizar últimos atendimentos"); 
+                print_history(clinic_history(clinic));
                 break;
-            case 2: 
-                puts("[TODO] Desfazer último atendimento"); 
+            case 2: { // Desfazer último atendimento
+                HistoryRecord rec;
+                clinic_status st = clinic_undo(clinic, &rec);
+                if (st == CLINIC_ERR_HISTORY_EMPTY) {
+                    puts("\nNenhum atendimento para desfazer.\n");
+                    break;
+                }
+                if (st == CLINIC_ERR_NOMEM) {
+                    puts("Erro: falha ao alocar memória para o novo nó da fila.");
+                    break;
+                }
+                if (st == CLINIC_ERR_STALE) {
+                    puts("\nPaciente do último atendimento não está mais no cadastro; registro descartado.");
+                    break;
+                }
+                applied(st);
+                printf("\n Atendimento desfeito: '%s' voltou ao início da fila (prioridade %d).\n",
+                       rec.patient->name, rec.level);
                 break;
+            }
             default: 
                 puts("Opção inválida.");
         }
+        sync_wal(clinic); // nada pendente enquanto espera o usuário
         press_enter(NULL);
     }
 }
@@ -1,7 +1,14 @@
 #ifndef MAIN_CONTROLLER_H
 #define MAIN_CONTROLLER_H
 
-/* Mostra e controla o menu principal (loop). */
-void run_main_menu(void);
+#include "app_options.h"
+
+/* Mostra e controla o menu principal (loop).
+   opt: snapshot/WAL a restaurar no início (o snapshot também é o destino da
+   opção "Salvar"; sem ele, salva em "clinic.snap") e limite do histórico.
+   NULL => tudo padrão.
+   Returns: 0 ao sair pelo menu; 1 se o estado não pôde ser criado ou o
+   snapshot existe e não carregou (nem abre o menu). */
+int run_main_menu(const AppOptions* opt);
 
 #endif /* MAIN_CONTROLLER_H */
@@ -0,0 +1,494 @@
+/*
+===============================================================================
+ Módulo: server_controller.c
+ Papel:  Modo servidor. Um laço de eventos (epoll) multiplexa as conexões
+         dos balcões sobre o MESMO estado do modo batch (batch_session_*),
+         sem uma thread por cliente: o estado continua single-thread.
+
+ Rodada: epoll_wait -> cada conexão pronta lê um bloco (até 64 KiB) e
+         executa as linhas completas, acumulando as respostas no seu
+         OutBuffer em memória -> um wal_sync -> um send por conexão.
+         O que não coube no socket fica para o EPOLLOUT das próximas rodadas.
+===============================================================================
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include "server_controller.h"
+
+#if defined(__linux__)
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include "batch_controller.h"
+#include "util/out_buffer.h"
+
+#define SERVER_MAX_EVENTS 256
+#define CONN_IN_CAP   (64u * 1024u)  /* maior linha aceita */
+#define CONN_OUT_CAP  (64u * 1024u)  /* inicial; cresce sob demanda */
+#define CONN_OUT_HIGH (8u << 20)     /* pendente acima disso: para de ler */
+
+/* Comandos aceitos pela rede: cadastro, consulta, fila, desfazer e
+   estatísticas. S/O/I abririam arquivos do servidor com o caminho do
+   cliente; o resto fica para o batch e o menu. */
+#define SERVER_COMMANDS "RLEDUT"
+
+typedef enum { EP_LISTENER, EP_WAKE, EP_CONN } EndpointKind;
+
+typedef struct {
+    EndpointKind kind;
+    int fd;
+    int tcp;                     // listener TCP: conexões com TCP_NODELAY
+} Endpoint;
+
+typedef struct Conn {
+    Endpoint ep;                 // primeiro campo: data.ptr do epoll aponta aqui
+    char* in;                    // CONN_IN_CAP + 1 (o '\0' da última linha)
+    size_t in_len;
+    int discarding;              // linha longa demais: ignora até o '\n'
+    OutBuffer out;               // respostas (fd < 0: só memória)
+    size_t out_sent;             // prefixo de out já enviado
+    size_t line_no;              // comandos recebidos (vai no "ERR <n>")
+    uint32_t events;             // interesse atual no epoll
+    int closing;                 // cliente fechou a escrita: sai ao esvaziar out
+    int dead;                    // erro no socket: fecha no fim da rodada
+    int touched;                 // já está na lista da rodada
+    struct Conn* next_touched;
+    struct Conn* prev;           // todas as conexões abertas
+    struct Conn* next;
+} Conn;
+
+typedef struct {
+    int epfd;
+    Endpoint wake;
+    Endpoint listeners[2];
+    size_t listener_count;
+    Conn* conns;
+    Conn* touched;
+    int wal_failed;              // último sync falhou: respostas retidas
+    size_t accepted, commands, errors, busy_ticks;
+} Server;
+
+static atomic_int g_stop;
+static atomic_int g_wake_fd = -1;
+
+void server_stop(void) {
+    atomic_store(&g_stop, 1);
+    int fd = atomic_load(&g_wake_fd);
+    if (fd >= 0) {
+        uint64_t one = 1;
+        ssize_t w = write(fd, &one, sizeof one); /* só acorda o epoll_wait */
+        (void)w;
+    }
+}
+
+static void on_signal(int sig) {
+    (void)sig;
+    server_stop();
+}
+
+static int set_nonblock(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/* ---------- sockets de escuta ---------- */
+
+static int listen_unix(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof addr.sun_path) {
+        fprintf(stderr, "servidor: caminho do socket longo demais: %s\n", path);
+        return -1;
+    }
+    memcpy(addr.sun_path, path, strlen(path) + 1);
+
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        /* Alguém atende nele: outro servidor vivo, não uma sobra */
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int live = probe >= 0 && set_nonblock(probe) &&
+                   (connect(probe, (struct sockaddr*)&addr, sizeof addr) == 0 || errno == EAGAIN);
+        if (probe >= 0) close(probe);
+        if (live) {
+            fprintf(stderr, "servidor: já existe um servidor ativo em %s\n", path);
+            return -1;
+        }
+        unlink(path); /* sobra de outra execução */
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof addr) < 0 ||
+        listen(fd, SOMAXCONN) < 0 || !set_nonblock(fd)) {
+        fprintf(stderr, "servidor: não foi possível ouvir em %s: %s\n", path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int listen_tcp(unsigned port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof addr);
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  /* só local */
+
+    int one = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one) < 0 ||
+        bind(fd, (struct sockaddr*)&addr, sizeof addr) < 0 ||
+        listen(fd, SOMAXCONN) < 0 || !set_nonblock(fd)) {
+        fprintf(stderr, "servidor: não foi possível ouvir em 127.0.0.1:%u: %s\n", port, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ---------- conexões ---------- */
+
+static void conn_close(Server* s, Conn* c) {
+    epoll_ctl(s->epfd, EPOLL_CTL_DEL, c->ep.fd, NULL);
+    close(c->ep.fd);
+    if (c->prev) c->prev->next = c->next;
+    else         s->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+    free(c->in);
+    free(c->out.buf);  /* fd < 0: out_close não teria o que descarregar */
+    free(c);
+}
+
+static void accept_all(Server* s, const Endpoint* l) {
+    for (;;) {
+        int fd = accept(l->fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                fprintf(stderr, "servidor: accept: %s\n", strerror(errno));
+            return;
+        }
+        Conn* c = calloc(1, sizeof *c);
+        if (c) c->in = malloc(CONN_IN_CAP + 1);
+        if (!c || !c->in || !out_open(&c->out, -1, CONN_OUT_CAP) || !set_nonblock(fd)) {
+            if (c) free(c->in);
+            free(c);
+            close(fd);
+            continue;
+        }
+        if (l->tcp) {
+            int one = 1;  /* respostas já saem agrupadas por rodada */
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+        }
+        c->ep.kind = EP_CONN;
+        c->ep.fd = fd;
+        c->events = EPOLLIN;
+        struct epoll_event ev = { .events = c->events, .data.ptr = &c->ep };
+        if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            free(c->in);
+            free(c->out.buf);
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->next = s->conns;
+        if (s->conns) s->conns->prev = c;
+        s->conns = c;
+        s->accepted++;
+    }
+}
+
+// Linha vazia e comentário passam (o batch ignora); o resto, só SERVER_COMMANDS
+static int server_allows(const char* line) {
+    while (*line == ' ' || *line == '\t') line++;
+    return *line == '\0' || *line == '#' || strchr(SERVER_COMMANDS, *line) != NULL;
+}
+
+static void run_line(Server* s, Conn* c, char* line, size_t len) {
+    if (len && line[len - 1] == '\r') len--;
+    line[len] = '\0';
+    c->line_no++;
+    if (!server_allows(line)) {
+        out_write(&c->out, "ERR ", 4);
+        out_u64(&c->out, c->line_no);
+        out_str(&c->out, " comando não permitido no servidor\n");
+        s->commands++;
+        s->errors++;
+        return;
+    }
+    int r = batch_session_exec(line, c->line_no, &c->out);
+    if (r < 0) return;
+    s->commands++;
+    if (!r) s->errors++;
+}
+
+/* Lê um bloco e executa as linhas completas (a última, sem '\n', espera). */
+static void conn_read(Server* s, Conn* c) {
+    ssize_t r = read(c->ep.fd, c->in + c->in_len, CONN_IN_CAP - c->in_len);
+    if (r < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) c->dead = 1;
+        return;
+    }
+    if (r == 0) {
+        c->closing = 1;
+        if (c->in_len && !c->discarding) run_line(s, c, c->in, c->in_len);
+        c->in_len = 0;
+        return;
+    }
+    c->in_len += (size_t)r;
+
+    char* start = c->in;
+    char* end = c->in + c->in_len;
+    char* nl;
+    while ((nl = memchr(start, '\n', (size_t)(end - start))) != NULL) {
+        if (c->discarding) c->discarding = 0;
+        else               run_line(s, c, start, (size_t)(nl - start));
+        start = nl + 1;
+    }
+    size_t rest = (size_t)(end - start);
+    if (rest == CONN_IN_CAP) {
+        /* Buffer inteiro sem '\n': responde o erro uma vez e pula o resto */
+        if (!c->discarding) {
+            c->line_no++;
+            out_write(&c->out, "ERR ", 4);
+            out_u64(&c->out, c->line_no);
+            out_str(&c->out, " linha longa demais\n");
+            s->commands++;
+            s->errors++;
+        }
+        c->discarding = 1;
+        rest = 0;
+    }
+    memmove(c->in, start, rest);
+    c->in_len = rest;
+}
+
+static void conn_send(Conn* c) {
+    if (c->out.error) {  /* sem memória para a resposta: não dá para continuar */
+        c->dead = 1;
+        return;
+    }
+    while (c->out_sent < c->out.len) {
+        ssize_t w = send(c->ep.fd, c->out.buf + c->out_sent, c->out.len - c->out_sent, MSG_NOSIGNAL);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) c->dead = 1;
+            return;
+        }
+        c->out_sent += (size_t)w;
+    }
+    c->out.len = c->out_sent = 0;
+    if (c->out.cap > CONN_OUT_HIGH) {  /* listagem grande: devolve a memória */
+        char* small = realloc(c->out.buf, CONN_OUT_CAP);
+        if (small) {
+            c->out.buf = small;
+            c->out.cap = CONN_OUT_CAP;
+        }
+    }
+}
+
+static void touch(Server* s, Conn* c) {
+    if (c->touched) return;
+    c->touched = 1;
+    c->next_touched = s->touched;
+    s->touched = c;
+}
+
+/* WAL falhando: fecha as conexões mortas (HUP/ERR é level-triggered e
+   giraria o laço) e tira o EPOLLIN de quem já leu o EOF; as vivas
+   continuam na lista, com as respostas retidas. */
+static void hold_replies(Server* s) {
+    Conn** link = &s->touched;
+    while (*link) {
+        Conn* c = *link;
+        if (c->dead) {
+            *link = c->next_touched;
+            conn_close(s, c);
+            continue;
+        }
+        if (c->closing && (c->events & EPOLLIN)) {
+            struct epoll_event ev = { .events = 0, .data.ptr = &c->ep };
+            epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->ep.fd, &ev);
+            c->events = 0;
+        }
+        link = &c->next_touched;
+    }
+}
+
+/* Fim da rodada: um sync do WAL, um send por conexão, interesse no epoll.
+   Sem o sync as respostas não saem (resposta enviada = mutação no WAL):
+   ficam nas conexões tocadas e a rodada seguinte tenta o sync de novo. */
+static void end_of_tick(Server* s, size_t commands_before) {
+    if (s->commands != commands_before || s->wal_failed) {
+        if (s->commands != commands_before) s->busy_ticks++;
+        int was_failed = s->wal_failed;
+        s->wal_failed = !batch_session_sync();
+        if (s->wal_failed != was_failed)
+            fprintf(stderr, s->wal_failed ? "servidor: falha ao gravar o WAL; respostas retidas\n"
+                                          : "servidor: WAL gravado; respostas liberadas\n");
+        if (s->wal_failed) {
+            hold_replies(s);
+            return;
+        }
+    }
+    Conn* next;
+    for (Conn* c = s->touched; c; c = next) {
+        next = c->next_touched;
+        c->touched = 0;
+        if (!c->dead) conn_send(c);
+        size_t pending = c->out.len - c->out_sent;
+        if (c->dead || (c->closing && !pending)) {
+            conn_close(s, c);
+            continue;
+        }
+        uint32_t want = 0;
+        if (!c->closing && pending < CONN_OUT_HIGH) want |= EPOLLIN;
+        if (pending) want |= EPOLLOUT;
+        if (want != c->events) {
+            struct epoll_event ev = { .events = want, .data.ptr = &c->ep };
+            epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->ep.fd, &ev);
+            c->events = want;
+        }
+    }
+    s->touched = NULL;
+}
+
+/* ---------- laço ---------- */
+
+static int watch(Server* s, Endpoint* ep) {
+    struct epoll_event ev = { .events = EPOLLIN, .data.ptr = ep };
+    return epoll_ctl(s->epfd, EPOLL_CTL_ADD, ep->fd, &ev) == 0;
+}
+
+static void serve(Server* s) {
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (!atomic_load(&g_stop)) {
+        /* Com o WAL falhando, acorda sozinho para tentar o sync de novo */
+        int n = epoll_wait(s->epfd, events, SERVER_MAX_EVENTS, s->wal_failed ? 100 : -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "servidor: epoll_wait: %s\n", strerror(errno));
+            return;
+        }
+        size_t commands_before = s->commands;
+        for (int i = 0; i < n; i++) {
+            Endpoint* ep = events[i].data.ptr;
+            uint32_t ev = events[i].events;
+            if (ep->kind == EP_WAKE) {
+                uint64_t v;
+                ssize_t r = read(ep->fd, &v, sizeof v);
+                (void)r;
+            } else if (ep->kind == EP_LISTENER) {
+                accept_all(s, ep);
+            } else {
+                Conn* c = (Conn*)ep;
+                touch(s, c);
+                /* HUP depois do EOF: não há mais a quem responder */
+                if ((ev & (EPOLLERR | EPOLLHUP)) && (!(ev & EPOLLIN) || c->closing)) c->dead = 1;
+                else if ((ev & EPOLLIN) && !c->closing) conn_read(s, c);
+            }
+        }
+        end_of_tick(s, commands_before);
+    }
+}
+
+int run_server(const AppOptions* opt) {
+    if (!opt || (!opt->server_socket && !opt->server_port)) {
+        fprintf(stderr, "servidor: informe --server socket e/ou --tcp porta\n");
+        return 2;
+    }
+
+    Server s;
+    memset(&s, 0, sizeof s);
+    struct sigaction sa, old_int, old_term;
+    int status = 2;
+    s.epfd = epoll_create1(0);
+    s.wake.kind = EP_WAKE;
+    s.wake.fd = eventfd(0, EFD_NONBLOCK);
+    if (s.epfd < 0 || s.wake.fd < 0 || !watch(&s, &s.wake)) {
+        fprintf(stderr, "servidor: epoll/eventfd: %s\n", strerror(errno));
+        goto done;
+    }
+    if (opt->server_socket) {
+        Endpoint* l = &s.listeners[s.listener_count];
+        l->kind = EP_LISTENER;
+        l->fd = listen_unix(opt->server_socket);
+        if (l->fd < 0) goto done;
+        s.listener_count++;
+        if (!watch(&s, l)) goto done;
+    }
+    if (opt->server_port) {
+        Endpoint* l = &s.listeners[s.listener_count];
+        l->kind = EP_LISTENER;
+        l->tcp = 1;
+        l->fd = listen_tcp(opt->server_port);
+        if (l->fd < 0) goto done;
+        s.listener_count++;
+        if (!watch(&s, l)) goto done;
+    }
+    /* Estado só depois dos sockets: um segundo servidor no mesmo socket
+       desiste antes de reaplicar (e cortar) o WAL do que está no ar */
+    if (!batch_session_open(opt)) goto done;
+
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, &old_int);
+    sigaction(SIGTERM, &sa, &old_term);
+    atomic_store(&g_stop, 0);
+    atomic_store(&g_wake_fd, s.wake.fd);
+
+    fprintf(stderr, "servidor: ouvindo em");
+    if (opt->server_socket) fprintf(stderr, " %s", opt->server_socket);
+    if (opt->server_port) fprintf(stderr, " 127.0.0.1:%u", opt->server_port);
+    fputc('\n', stderr);
+
+    serve(&s);
+
+    atomic_store(&g_wake_fd, -1);
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    fprintf(stderr, "servidor: %zu conexões, %zu comandos, %zu erros, %.1f comandos por rodada\n",
+            s.accepted, s.commands, s.errors,
+            s.busy_ticks ? (double)s.commands / (double)s.busy_ticks : 0.0);
+    status = 0;
+
+done:
+    while (s.conns) conn_close(&s, s.conns);
+    for (size_t i = 0; i < s.listener_count; i++) close(s.listeners[i].fd);
+    if (opt->server_socket && s.listener_count) unlink(opt->server_socket);
+    if (s.wake.fd >= 0) close(s.wake.fd);
+    if (s.epfd >= 0) close(s.epfd);
+    batch_session_close();
+    return status;
+}
+
+#else  /* !__linux__ */
+
+int run_server(const AppOptions* opt) {
+    (void)opt;
+    fprintf(stderr, "servidor: modo disponível só no Linux (epoll)\n");
+    return 2;
+}
+
+void server_stop(void) {
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef SERVER_CONTROLLER_H
+#define SERVER_CONTROLLER_H
+
+#include "app_options.h"
+
+/*
+  Modo servidor: um processo guarda o estado (cadastro, fila, histórico) e
+  atende muitos balcões ao mesmo tempo por socket Unix (opt->server_socket)
+  e/ou TCP só em 127.0.0.1 (opt->server_port). Linux (epoll).
+
+  Protocolo: o do --batch (batch_controller.h), uma linha por comando e as
+  mesmas respostas, mas só com R, L, E, D, U e T; os outros (arquivos do
+  servidor, listagens, importação) recebem "ERR <n> comando não permitido
+  no servidor". "ERR <n>" traz o número do comando na conexão. Toda
+  resposta termina numa linha "OK ..." / "ERR ..." ou, nos comandos de um
+  paciente (L, D, U), numa linha "P ...". O cliente pode mandar vários
+  comandos sem esperar (pipeline): as respostas saem na ordem.
+
+  Socket Unix: um arquivo de socket que ainda aceita conexão é de outro
+  servidor vivo e run_server desiste (sem tocar no WAL); sem ninguém
+  atendendo, é sobra de outra execução e é substituído.
+
+  Laço: um epoll_wait por rodada. Cada conexão pronta tem os comandos
+  completos executados na hora, com as respostas acumuladas no seu buffer;
+  no fim da rodada o WAL faz um único sync e cada conexão recebe tudo o que
+  acumulou num só send. Resposta enviada = mutação já no WAL. Cliente que
+  não lê as respostas deixa de ser lido (contrapressão).
+
+  Returns: 0 ao parar (SIGINT/SIGTERM ou server_stop), 2 se não conseguiu
+  restaurar o estado ou abrir os sockets.
+*/
+int run_server(const AppOptions* opt);
+
+/* Pede para run_server parar no fim da rodada (seguro em outra thread). */
+void server_stop(void);
+
+#endif /* SERVER_CONTROLLER_H */
@@ -0,0 +1,129 @@
+/*
+ Módulo: concurrent_queue.c
+ Papel:  Fila multi-balcão / multi-médico sobre a PatientQueue (ver .h).
+
+ Por que assim:
+   - Os balcões só disputam o CAS da cabeça do anel de chegadas.
+   - A PatientQueue (mapa de CPF, Fenwick, slab) não é thread-safe; em vez
+     de um mutex em volta de cada operação, ela vira retaguarda privada de
+     quem está drenando. A drenagem trabalha em lote: um dono por vez,
+     muitas chegadas por posse.
+   - Os médicos pegam dos anéis de prontos (CAS na cauda), sem lock; com
+     nível 1 pronto nem olham o resto. Os anéis de prontos são pequenos:
+     o que ficou na retaguarda ainda está na ordem certa e entra na próxima
+     reposição.
+
+ Tempo de espera: a retaguarda usa um relógio que devolve o instante de
+ chegada do bilhete (enqueue) ou o de reposição (dequeue_level), então
+ backlog.stats mede chegada -> pronto para atender.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include "concurrent_queue.h"
+#include "util/latency_hist.h"
+
+#if !defined(_WIN32)
+#include <sched.h>
+#endif
+
+// Relógio da retaguarda: quem drena ajusta antes de cada operação
+static _Thread_local uint64_t drain_now;
+static uint64_t drain_clock(void) { return drain_now; }
+
+static void cpu_yield(void) {
+#if !defined(_WIN32)
+    sched_yield();
+#endif
+}
+
+int cq_init(ConcurrentQueue* cq, size_t arrivals, size_t ready) {
+    if (!arrivals) arrivals = CQ_DEFAULT_ARRIVALS;
+    if (!ready) ready = CQ_DEFAULT_READY;
+    if (!mpmc_ring_init(&cq->arrivals, arrivals)) return 0;
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        if (!mpmc_ring_init(&cq->ready[lv], ready)) {
+            while (lv-- > 0) mpmc_ring_destroy(&cq->ready[lv]);
+            mpmc_ring_destroy(&cq->arrivals);
+            return 0;
+        }
+    }
+    init_queue(&cq->backlog);
+    cq->backlog.clock = drain_clock;
+    cq->has_carry = 0;
+    atomic_init(&cq->drain_lock, 0);
+    atomic_init(&cq->backlog_size, 0);
+    return 1;
+}
+
+void cq_destroy(ConcurrentQueue* cq) {
+    mpmc_ring_destroy(&cq->arrivals);
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) mpmc_ring_destroy(&cq->ready[lv]);
+    free_queue(&cq->backlog);
+}
+
+int cq_enqueue(ConcurrentQueue* cq, const Patient* p) {
+    QueueTicket t = { p, latency_now_ns() };
+    return mpmc_ring_push(&cq->arrivals, &t);
+}
+
+// Chegadas -> retaguarda (no máximo uma volta do anel, para não prender a
+// drenagem com balcões que não param) e retaguarda -> prontos, por nível.
+static void drain_locked(ConcurrentQueue* cq) {
+    PatientQueue* q = &cq->backlog;
+    QueueTicket t;
+    size_t budget = mpmc_ring_capacity(&cq->arrivals);
+    while (budget--) {
+        if (cq->has_carry) t = cq->carry;
+        else if (!mpmc_ring_pop(&cq->arrivals, &t)) break;
+        drain_now = t.enqueued_ns;
+        cq->has_carry = !enqueue(q, t.patient);
+        if (cq->has_carry) { cq->carry = t; break; } // sem memória: tenta na próxima
+    }
+
+    drain_now = latency_now_ns();
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        for (const QueueNode* n = q->front[lv]; n; n = q->front[lv]) {
+            QueueTicket r = { n->patient, n->enqueued_ns };
+            if (!mpmc_ring_push(&cq->ready[lv], &r)) break; // prontos cheios
+            dequeue_level(q, lv);
+        }
+    }
+    atomic_store_explicit(&cq->backlog_size, q->size + (size_t)cq->has_carry, memory_order_relaxed);
+}
+
+// Há chegadas no anel ou gente na retaguarda? (leitura aproximada)
+static int has_pending(ConcurrentQueue* cq) {
+    return atomic_load_explicit(&cq->arrivals.head, memory_order_acquire) !=
+           atomic_load_explicit(&cq->arrivals.tail, memory_order_acquire) ||
+           atomic_load_explicit(&cq->backlog_size, memory_order_relaxed) != 0;
+}
+
+void cq_drain(ConcurrentQueue* cq) {
+    if (!has_pending(cq)) return;
+    int expected = 0;
+    if (atomic_compare_exchange_strong_explicit(&cq->drain_lock, &expected, 1,
+                                                memory_order_acquire, memory_order_relaxed)) {
+        drain_locked(cq);
+        atomic_store_explicit(&cq->drain_lock, 0, memory_order_release);
+        return;
+    }
+    // Outro já está drenando: espera para ver o que ele repôs
+    while (atomic_load_explicit(&cq->drain_lock, memory_order_acquire)) cpu_yield();
+}
+
+const Patient* cq_dequeue(ConcurrentQueue* cq, uint64_t* enqueued_ns) {
+    QueueTicket t;
+    if (!mpmc_ring_pop(&cq->ready[0], &t)) {
+        // Sem nível 1 pronto: traz as chegadas antes de olhar os níveis abaixo
+        cq_drain(cq);
+        int lv = 0;
+        while (lv < QUEUE_LEVELS && !mpmc_ring_pop(&cq->ready[lv], &t)) lv++;
+        if (lv == QUEUE_LEVELS) return NULL;
+    }
+    if (enqueued_ns) *enqueued_ns = t.enqueued_ns;
+    return t.patient;
+}
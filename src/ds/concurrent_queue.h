@@ -0,0 +1,58 @@
+#ifndef CONCURRENT_QUEUE_H
+#define CONCURRENT_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "patient_queue.h"
+#include "mpmc_ring.h"
+
+/*
+  Fila de atendimento para vários balcões e vários médicos ao mesmo tempo.
+
+  Chegadas: cada balcão faz cq_enqueue num anel MPMC sem lock (arrivals).
+  Drenagem: uma thread por vez (quem pegar drain_lock) move as chegadas
+  para a PatientQueue de retaguarda (backlog, com as estatísticas de
+  espera) e enche, nível por nível, um anel pequeno de "prontos" por
+  prioridade com os primeiros de cada nível.
+  Atendimento: cq_dequeue tira do anel de prontos do nível 1 sem lock; só
+  quando ele está vazio drena e tenta os níveis seguintes, em ordem.
+
+  Ordem: estrita por prioridade (FIFO dentro do nível) entre as chegadas já
+  drenadas; uma chegada conta a partir da drenagem, que todo cq_dequeue sem
+  nível 1 pronto provoca (ou espera terminar). Desistência, posição e
+  envelhecimento continuam só na PatientQueue do modo single-thread.
+*/
+
+#define CQ_DEFAULT_ARRIVALS 4096u  /* anel de chegadas */
+#define CQ_DEFAULT_READY    64u    /* anel de prontos por nível */
+
+typedef struct {
+    MpmcRing arrivals;               // balcões -> drenagem
+    MpmcRing ready[QUEUE_LEVELS];    // drenagem -> médicos, por nível
+    PatientQueue backlog;            // só quem tem drain_lock mexe
+    QueueTicket carry;               // chegada que não coube no backlog (sem memória)
+    int has_carry;
+    atomic_int drain_lock;           // 1 => alguém drenando
+    atomic_size_t backlog_size;      // cópia de backlog.size para leitura sem lock
+} ConcurrentQueue;
+
+/* arrivals/ready = 0 usam os padrões. Returns: 1 ok, 0 sem memória. */
+int cq_init(ConcurrentQueue* cq, size_t arrivals, size_t ready);
+
+/* Libera tudo (sem threads usando a fila). */
+void cq_destroy(ConcurrentQueue* cq);
+
+/* Seguro entre threads. p precisa continuar válido até ser atendido.
+   Returns: 1 ok, 0 se o anel de chegadas está cheio (tente de novo). */
+int cq_enqueue(ConcurrentQueue* cq, const Patient* p);
+
+/* Seguro entre threads. Próximo paciente na ordem de prioridade, ou NULL se
+   não há ninguém. enqueued_ns (opcional) recebe o instante de chegada. */
+const Patient* cq_dequeue(ConcurrentQueue* cq, uint64_t* enqueued_ns);
+
+/* Move as chegadas pendentes para a retaguarda e repõe os prontos (ou espera
+   quem já está drenando). Seguro entre threads; cq_dequeue já chama. */
+void cq_drain(ConcurrentQueue* cq);
+
+#endif /* CONCURRENT_QUEUE_H */
@@ -0,0 +1,284 @@
+/*
+ Módulo: concurrent_registry.c
+ Papel:  Cadastro com leitura sem lock e reciclagem por épocas (ver .h).
+
+ Publicação:
+   - nó novo: todos os campos escritos antes do store-release em head (ou
+     no slot do índice), e os leitores seguem ponteiros com load-acquire;
+   - índice de CPF: endereçamento aberto sem remoção. O escritor grava o nó
+     do slot e depois a chave (release); o leitor lê a chave (acquire) e só
+     então o nó. Crescer = montar outra tabela e trocar o ponteiro.
+
+ Épocas (3 épocas, como no EBR clássico):
+   - o leitor copia a época global para o seu slot ao entrar e zera ao sair;
+   - o lixo é marcado com a época em que saiu da estrutura;
+   - a época global só avança de E para E + 1 quando todo leitor ativo está
+     em E, então ao chegar em E + 2 ninguém que podia ter visto o lixo de E
+     continua lendo: ele pode ser liberado.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "concurrent_registry.h"
+#include "model/cpf.h"
+#include "util/patient_io.h"
+
+struct CregGarbage {
+    CregGarbage* next;
+    uint64_t epoch;              // época em que saiu da estrutura
+};
+
+struct CregNode {
+    CregGarbage gc;              // primeiro campo: o bloco inteiro vira lixo
+    Patient data;
+    uint64_t cpf_key;
+    _Atomic(CregNode*) next;
+    CregNode* prev;              // só o escritor usa (troca em O(1))
+};
+
+typedef struct {
+    atomic_uint_fast64_t key;    // 0 => vazio
+    _Atomic(CregNode*) node;
+} CregSlot;
+
+struct CregTable {
+    CregGarbage gc;
+    size_t mask;
+    size_t used;                 // só o escritor usa
+    CregSlot slots[];
+};
+
+#define CREG_MIN_TABLE 1024u
+
+/* ---------- índice de CPF ---------- */
+
+static size_t slot_home(const CregTable* t, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 20) & t->mask;
+}
+
+static CregTable* table_new(size_t cap) {
+    CregTable* t = malloc(sizeof *t + cap * sizeof t->slots[0]);
+    if (!t) return NULL;
+    t->mask = cap - 1;
+    t->used = 0;
+    for (size_t i = 0; i < cap; i++) {
+        atomic_init(&t->slots[i].key, 0);
+        atomic_init(&t->slots[i].node, NULL);
+    }
+    return t;
+}
+
+static CregNode* table_find(const CregTable* t, uint64_t key) {
+    for (size_t i = slot_home(t, key);; i = (i + 1) & t->mask) {
+        uint64_t k = atomic_load_explicit(&t->slots[i].key, memory_order_acquire);
+        if (k == key) return atomic_load_explicit(&t->slots[i].node, memory_order_acquire);
+        if (k == 0) return NULL;
+    }
+}
+
+// Escritor: coloca (ou troca) o nó da chave. A tabela tem folga (carga <= 1/2).
+static void table_put(CregTable* t, uint64_t key, CregNode* node) {
+    size_t i = slot_home(t, key);
+    for (;; i = (i + 1) & t->mask) {
+        uint64_t k = atomic_load_explicit(&t->slots[i].key, memory_order_relaxed);
+        if (k == key) {
+            atomic_store_explicit(&t->slots[i].node, node, memory_order_release);
+            return;
+        }
+        if (k == 0) break;
+    }
+    atomic_store_explicit(&t->slots[i].node, node, memory_order_relaxed);
+    atomic_store_explicit(&t->slots[i].key, key, memory_order_release);
+    t->used++;
+}
+
+/* ---------- lixo e épocas ---------- */
+
+static void retire(ConcurrentRegistry* reg, CregGarbage* g) {
+    g->epoch = atomic_load(&reg->epoch);
+    g->next = reg->garbage;
+    reg->garbage = g;
+    reg->garbage_count++;
+}
+
+size_t creg_reclaim(ConcurrentRegistry* reg) {
+    // Ordena as desligações já feitas antes de olhar as épocas dos leitores
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t e = atomic_load(&reg->epoch);
+    int all_current = 1;
+    for (size_t i = 0; i < CREG_MAX_READERS && all_current; i++) {
+        uint64_t re = atomic_load(&reg->readers[i].epoch);
+        if (re && re != e) all_current = 0;
+    }
+    if (all_current) atomic_store(&reg->epoch, ++e);
+
+    CregGarbage** link = &reg->garbage;
+    while (*link) {
+        CregGarbage* g = *link;
+        if (g->epoch + 2 <= e) {
+            *link = g->next;
+            free(g);
+            reg->garbage_count--;
+        } else {
+            link = &g->next;
+        }
+    }
+    return reg->garbage_count;
+}
+
+/* ---------- ciclo de vida ---------- */
+
+int creg_init(ConcurrentRegistry* reg) {
+    CregTable* t = table_new(CREG_MIN_TABLE);
+    if (!t) return 0;
+    atomic_init(&reg->head, NULL);
+    atomic_init(&reg->table, t);
+    atomic_init(&reg->size, 0);
+    atomic_init(&reg->epoch, 1);
+    atomic_flag_clear(&reg->write_lock);
+    reg->garbage = NULL;
+    reg->garbage_count = 0;
+    for (size_t i = 0; i < CREG_MAX_READERS; i++) {
+        atomic_init(&reg->readers[i].epoch, 0);
+        atomic_init(&reg->readers[i].used, 0);
+    }
+    return 1;
+}
+
+void creg_destroy(ConcurrentRegistry* reg) {
+    CregNode* n = atomic_load(&reg->head);
+    while (n) {
+        CregNode* next = atomic_load_explicit(&n->next, memory_order_relaxed);
+        free(n);
+        n = next;
+    }
+    free(atomic_load(&reg->table));
+    while (reg->garbage) {
+        CregGarbage* g = reg->garbage;
+        reg->garbage = g->next;
+        free(g);
+    }
+    atomic_store(&reg->head, NULL);
+    atomic_store(&reg->table, NULL);
+    reg->garbage_count = 0;
+}
+
+/* ---------- leitores ---------- */
+
+CregReader* creg_reader_join(ConcurrentRegistry* reg) {
+    for (size_t i = 0; i < CREG_MAX_READERS; i++) {
+        int expected = 0;
+        if (atomic_compare_exchange_strong(&reg->readers[i].used, &expected, 1))
+            return &reg->readers[i];
+    }
+    return NULL;
+}
+
+void creg_reader_leave(CregReader* r) {
+    atomic_store(&r->epoch, 0);
+    atomic_store(&r->used, 0);
+}
+
+void creg_enter(ConcurrentRegistry* reg, CregReader* r) {
+    atomic_store(&r->epoch, atomic_load(&reg->epoch));
+    // O anúncio precisa ficar visível antes das leituras da estrutura
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+void creg_exit(CregReader* r) {
+    atomic_store_explicit(&r->epoch, 0, memory_order_release);
+}
+
+const Patient* creg_find_cpf(const ConcurrentRegistry* reg, const char* cpf) {
+    uint64_t key;
+    if (!cpf_pack_key(cpf, &key)) return NULL;
+    const CregTable* t = atomic_load_explicit(&reg->table, memory_order_acquire);
+    const CregNode* n = table_find(t, key);
+    return n ? &n->data : NULL;
+}
+
+size_t creg_print_page(const ConcurrentRegistry* reg, OutBuffer* out, size_t offset, size_t limit) {
+    size_t end = out_page_end(offset, limit);
+    size_t i = 0, written = 0;
+    for (const CregNode* n = atomic_load_explicit(&reg->head, memory_order_acquire); n && i < end;
+         n = atomic_load_explicit(&n->next, memory_order_acquire), i++) {
+        if (i < offset) continue;
+        out_patient_line(out, &n->data);
+        written++;
+    }
+    return written;
+}
+
+/* ---------- escritores ---------- */
+
+static void write_lock(ConcurrentRegistry* reg) {
+    while (atomic_flag_test_and_set_explicit(&reg->write_lock, memory_order_acquire)) {
+        // escritas são raras: espera ativa curta
+    }
+}
+
+static void write_unlock(ConcurrentRegistry* reg) {
+    atomic_flag_clear_explicit(&reg->write_lock, memory_order_release);
+}
+
+// Garante carga <= 1/2 para mais uma chave; troca a tabela se precisar.
+static int table_reserve(ConcurrentRegistry* reg) {
+    CregTable* t = atomic_load_explicit(&reg->table, memory_order_relaxed);
+    if ((t->used + 1) * 2 <= t->mask + 1) return 1;
+    CregTable* bigger = table_new((t->mask + 1) * 2);
+    if (!bigger) return 0;
+    for (size_t i = 0; i <= t->mask; i++) {
+        uint64_t k = atomic_load_explicit(&t->slots[i].key, memory_order_relaxed);
+        if (k) table_put(bigger, k, atomic_load_explicit(&t->slots[i].node, memory_order_relaxed));
+    }
+    atomic_store_explicit(&reg->table, bigger, memory_order_release);
+    retire(reg, &t->gc); // leitores ainda podem estar sondando a velha
+    return 1;
+}
+
+int creg_insert(ConcurrentRegistry* reg, const Patient* p) {
+    uint64_t key;
+    if (!p || !cpf_pack_key(p->cpf, &key)) return 0;
+    write_lock(reg);
+    CregTable* t = atomic_load_explicit(&reg->table, memory_order_relaxed);
+    CregNode* n = NULL;
+    int ok = !table_find(t, key) && table_reserve(reg) && (n = malloc(sizeof *n)) != NULL;
+    if (ok) {
+        n->data = *p;
+        n->cpf_key = key;
+        n->prev = NULL;
+        CregNode* head = atomic_load_explicit(&reg->head, memory_order_relaxed);
+        atomic_init(&n->next, head);
+        if (head) head->prev = n;
+        table_put(atomic_load_explicit(&reg->table, memory_order_relaxed), key, n);
+        atomic_store_explicit(&reg->head, n, memory_order_release);
+        atomic_fetch_add_explicit(&reg->size, 1, memory_order_relaxed);
+        creg_reclaim(reg);
+    }
+    write_unlock(reg);
+    return ok;
+}
+
+int creg_update(ConcurrentRegistry* reg, const Patient* p) {
+    uint64_t key;
+    if (!p || !cpf_pack_key(p->cpf, &key)) return 0;
+    write_lock(reg);
+    CregNode* old = table_find(atomic_load_explicit(&reg->table, memory_order_relaxed), key);
+    CregNode* n = old ? malloc(sizeof *n) : NULL;
+    if (n) {
+        // Cópia completa; o nó velho fica intacto para quem já está nele
+        n->data = *p;
+        n->cpf_key = key;
+        n->prev = old->prev;
+        CregNode* next = atomic_load_explicit(&old->next, memory_order_relaxed);
+        atomic_init(&n->next, next);
+        if (next) next->prev = n;
+        table_put(atomic_load_explicit(&reg->table, memory_order_relaxed), key, n);
+        if (old->prev) atomic_store_explicit(&old->prev->next, n, memory_order_release);
+        else           atomic_store_explicit(&reg->head, n, memory_order_release);
+        retire(reg, &old->gc);
+        creg_reclaim(reg);
+    }
+    write_unlock(reg);
+    return n != NULL;
+}
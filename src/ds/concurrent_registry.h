@@ -0,0 +1,81 @@
+#ifndef CONCURRENT_REGISTRY_H
+#define CONCURRENT_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "../model/patient.h"
+#include "util/out_buffer.h"
+
+/*
+  Cadastro compartilhado entre threads, para tráfego de leitura pesado.
+
+  Leitura sem lock: busca por CPF e listagem só fazem loads atômicos
+  (acquire) dentro de uma seção de leitura (creg_enter/creg_exit), que
+  apenas anuncia a época em que a thread está.
+  Escrita: insert/update são serializados entre si (spinlock do escritor)
+  e publicam com um único store-release: o nó novo fica completo antes de
+  aparecer na lista ou no índice. Update troca o nó inteiro (cópia).
+  Reciclagem por épocas: nós trocados e tabelas antigas do índice vão para
+  uma lista de lixo e só são liberados duas épocas depois, quando nenhum
+  leitor que podia vê-los ainda está numa seção de leitura.
+
+  Os ponteiros devolvidos valem até o creg_exit da seção em que foram lidos.
+  Índices por id e por nome continuam só na PatientList (single-thread).
+*/
+
+#define CREG_MAX_READERS 64
+
+typedef struct CregNode CregNode;     /* definidos no .c */
+typedef struct CregTable CregTable;
+typedef struct CregGarbage CregGarbage;
+
+typedef struct {
+    atomic_uint_fast64_t epoch;  // 0 => fora de seção de leitura
+    atomic_int used;             // slot reservado por creg_reader_join
+    char pad[64 - sizeof(atomic_uint_fast64_t) - sizeof(atomic_int)];
+} CregReader;
+
+typedef struct {
+    _Atomic(CregNode*) head;         // lista (inserção no início)
+    _Atomic(CregTable*) table;       // CPF compacto -> nó
+    atomic_size_t size;
+    atomic_uint_fast64_t epoch;      // época global (começa em 1)
+    atomic_flag write_lock;          // um escritor por vez
+    CregGarbage* garbage;            // retirados, ainda não liberados (escritor)
+    size_t garbage_count;
+    CregReader readers[CREG_MAX_READERS];
+} ConcurrentRegistry;
+
+/* Returns: 1 ok, 0 sem memória. */
+int creg_init(ConcurrentRegistry* reg);
+
+/* Libera tudo (nenhuma thread pode estar usando o cadastro). */
+void creg_destroy(ConcurrentRegistry* reg);
+
+/* Reserva um slot de leitor para a thread. Returns: leitor ou NULL se os
+   CREG_MAX_READERS estão em uso. */
+CregReader* creg_reader_join(ConcurrentRegistry* reg);
+void creg_reader_leave(CregReader* r);
+
+/* Seção de leitura (não bloqueia, não aninha). */
+void creg_enter(ConcurrentRegistry* reg, CregReader* r);
+void creg_exit(CregReader* r);
+
+/* Dentro da seção: paciente com o CPF ou NULL. */
+const Patient* creg_find_cpf(const ConcurrentRegistry* reg, const char* cpf);
+
+/* Dentro da seção: linhas [offset, offset + limit) da lista em out (como
+   print_patient_page). Returns: linhas escritas. */
+size_t creg_print_page(const ConcurrentRegistry* reg, OutBuffer* out, size_t offset, size_t limit);
+
+/* Escritores (seguro entre threads). Returns: 1 ok, 0 CPF inválido,
+   repetido (insert) / ausente (update) ou sem memória. */
+int creg_insert(ConcurrentRegistry* reg, const Patient* p);
+int creg_update(ConcurrentRegistry* reg, const Patient* p);  /* pelo CPF */
+
+/* Tenta avançar a época e libera o lixo que já pode sair. Returns:
+   quantos itens continuam esperando. Insert/update já chamam. */
+size_t creg_reclaim(ConcurrentRegistry* reg);
+
+#endif /* CONCURRENT_REGISTRY_H */
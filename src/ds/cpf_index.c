@@ -0,0 +1,127 @@
+/*
+ Módulo: cpf_index.c
+ Papel:  Índice hash de CPF usado pela PatientList para busca e checagem de
+         unicidade em O(1) esperado (antes era uma varredura O(n) da lista).
+
+ Decisões:
+   - Chave = CPF compacto de 64 bits (model/cpf.h), empacotado uma vez na
+     entrada; nada de strcmp nem de guardar o texto no slot.
+   - Sondagem linear por GRUPOS de 8 slots (CpfGroup: linha das chaves +
+     linha dos ponteiros, vizinhas): o hash escolhe um grupo, o
+     núcleo SIMD compara a chave com as 8 de uma vez e também diz quais
+     estão vazias. Se não casou e há vazio no grupo, a chave não existe;
+     senão, segue para o grupo seguinte. (Não há remoção, então um vazio
+     encerra a sequência com segurança.)
+   - Capacidade potência de 2, fator de carga máximo 70%; acima disso a
+     tabela dobra (rehash).
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "cpf_index.h"
+#include "cpf_scan.h"
+
+#define CPF_INDEX_MIN_CAP 16
+#define CPF_INDEX_ALIGN   64
+
+/* Espalha a chave (dígitos sequenciais) antes de escolher o grupo */
+static size_t group_of(uint64_t key, size_t groups) {
+    key ^= key >> 31;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(key >> 32) & (groups - 1);
+}
+
+void cpf_index_init(CpfIndex* idx) {
+    if (!idx) return;
+    idx->groups = NULL;
+    idx->raw = NULL;
+    idx->cap = 0;
+    idx->count = 0;
+}
+
+/* Grupo + posição da chave, ou do primeiro vazio da sequência de grupos. */
+static CpfGroup* probe(CpfGroup* groups, size_t cap, uint64_t key, unsigned* pos) {
+    size_t n_groups = cap / CPF_SCAN_GROUP;
+    size_t g = group_of(key, n_groups);
+    for (;;) {
+        unsigned empty;
+        unsigned hit = cpf_group_match(groups[g].keys, key, &empty);
+        if (hit)   { *pos = cpf_scan_first_bit(hit);   return &groups[g]; }
+        if (empty) { *pos = cpf_scan_first_bit(empty); return &groups[g]; }
+        g = (g + 1) & (n_groups - 1);
+    }
+}
+
+static int rehash(CpfIndex* idx, size_t new_cap) {
+    size_t n_groups = new_cap / CPF_SCAN_GROUP;
+    void* raw = calloc(n_groups * sizeof(CpfGroup) + CPF_INDEX_ALIGN, 1);
+    if (!raw) return 0;
+    CpfGroup* groups = (CpfGroup*)(((uintptr_t)raw + CPF_INDEX_ALIGN - 1) &
+                                   ~(uintptr_t)(CPF_INDEX_ALIGN - 1));
+
+    for (size_t g = 0; g < idx->cap / CPF_SCAN_GROUP; g++) {
+        for (unsigned i = 0; i < CPF_SCAN_GROUP; i++) {
+            uint64_t key = idx->groups[g].keys[i];
+            if (!key) continue;
+            unsigned pos;
+            CpfGroup* dst = probe(groups, new_cap, key, &pos);
+            dst->keys[pos] = key;
+            dst->patients[pos] = idx->groups[g].patients[i];
+        }
+    }
+    free(idx->raw);
+    idx->raw = raw;
+    idx->groups = groups;
+    idx->cap = new_cap;
+    return 1;
+}
+
+const Patient* cpf_index_find_key(const CpfIndex* idx, uint64_t key) {
+    if (!idx || idx->count == 0 || !key) return NULL;
+    unsigned pos;
+    const CpfGroup* g = probe(idx->groups, idx->cap, key, &pos);
+    return g->keys[pos] ? g->patients[pos] : NULL;
+}
+
+const Patient* cpf_index_find(const CpfIndex* idx, const char* cpf) {
+    uint64_t key;
+    if (!cpf_pack_key(cpf, &key)) return NULL;
+    return cpf_index_find_key(idx, key);
+}
+
+int cpf_index_insert(CpfIndex* idx, const char* cpf, const Patient* patient) {
+    uint64_t key;
+    if (!cpf_pack_key(cpf, &key)) return 0;
+    return cpf_index_insert_key(idx, key, patient);
+}
+
+int cpf_index_insert_key(CpfIndex* idx, uint64_t key, const Patient* patient) {
+    if (!idx || !patient || !key) return 0;
+
+    /* Mantém carga <= 70% já contando a nova entrada */
+    if ((idx->count + 1) * 10 > idx->cap * 7 &&
+        !rehash(idx, idx->cap ? idx->cap * 2 : CPF_INDEX_MIN_CAP))
+        return 0;
+
+    unsigned pos;
+    CpfGroup* g = probe(idx->groups, idx->cap, key, &pos);
+    if (g->keys[pos]) return 0; /* CPF já indexado */
+
+    g->keys[pos] = key;
+    g->patients[pos] = patient;
+    idx->count++;
+    return 1;
+}
+
+int cpf_index_reserve(CpfIndex* idx, size_t n) {
+    if (!idx) return 0;
+    size_t cap = idx->cap ? idx->cap : CPF_INDEX_MIN_CAP;
+    while (n * 10 > cap * 7) cap *= 2;
+    return cap == idx->cap ? 1 : rehash(idx, cap);
+}
+
+void cpf_index_free(CpfIndex* idx) {
+    if (!idx) return;
+    free(idx->raw);
+    cpf_index_init(idx);
+}
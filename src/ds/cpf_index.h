@@ -0,0 +1,53 @@
+#ifndef CPF_INDEX_H
+#define CPF_INDEX_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
+#include "model/patient.h"
+#include "model/cpf.h"
+
+/*
+  Índice hash (endereçamento aberto) de CPF -> Patient*.
+
+  A chave é o CPF compacto de 64 bits (cpf_pack_key): "111.222.333-44" e
+  "11122233344" viram o MESMO inteiro, e comparar chaves é comparar
+  inteiros. Os slots ficam em grupos de 8: as 8 chaves ocupam uma linha de
+  cache e são comparadas de uma vez pelo núcleo SIMD de cpf_scan.h; os 8
+  ponteiros para os pacientes ficam na linha seguinte, só lida no acerto.
+  O índice não é dono dos Patient: apenas guarda ponteiros estáveis
+  para os dados que vivem nos nós da PatientList.
+*/
+
+typedef struct {
+    uint64_t keys[8];            // chaves compactas (0 => slot vazio): 1 linha de cache
+    const Patient* patients[8];  // paciente de cada slot: a linha seguinte
+} CpfGroup;
+
+typedef struct {
+    CpfGroup* groups;         // grupos alinhados a 64 bytes
+    void* raw;                // bloco alocado (antes do alinhamento)
+    size_t cap;               // número de slots (potência de 2, múltiplo de 8)
+    size_t count;             // slots ocupados
+} CpfIndex;
+
+void cpf_index_init(CpfIndex* idx);
+
+/* Busca por CPF (empacota internamente). Returns: Patient* ou NULL. */
+const Patient* cpf_index_find(const CpfIndex* idx, const char* cpf);
+
+/* Busca pela chave já empacotada. Returns: Patient* ou NULL. */
+const Patient* cpf_index_find_key(const CpfIndex* idx, uint64_t key);
+
+/* Insere CPF -> patient. Returns: 1 se inseriu, 0 se duplicado, CPF não
+   numérico (sem chave compacta) ou sem memória. */
+int cpf_index_insert(CpfIndex* idx, const char* cpf, const Patient* patient);
+
+/* Idem, com a chave já empacotada. */
+int cpf_index_insert_key(CpfIndex* idx, uint64_t key, const Patient* patient);
+
+/* Pré-dimensiona para n entradas sem rehash. Returns: 1 ok, 0 sem memória. */
+int cpf_index_reserve(CpfIndex* idx, size_t n);
+
+void cpf_index_free(CpfIndex* idx);
+
+#endif /* CPF_INDEX_H */
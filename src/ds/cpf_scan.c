@@ -0,0 +1,157 @@
+/*
+ Módulo: cpf_scan.c
+ Papel:  Comparação de 8 chaves de CPF por vez (SSE2/AVX2 com fallback escalar).
+
+ Decisões:
+   - O nível é escolhido na primeira chamada (cpuid via
+     __builtin_cpu_supports) e fica num ponteiro de função; o AVX2 é
+     compilado só nesta função (atributo target), então o binário continua
+     rodando em CPUs sem AVX2 e o Makefile não precisa de -mavx2.
+   - SSE2 não tem comparação de 64 bits (é do SSE4.1): compara as metades
+     de 32 bits e exige que as duas casem.
+*/
+
+#include <stdatomic.h>
+#include "cpf_scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CPF_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+static unsigned group_scalar(const uint64_t* g, uint64_t key, unsigned* empty) {
+    unsigned m = 0, e = 0;
+    for (unsigned i = 0; i < CPF_SCAN_GROUP; i++) {
+        m |= (unsigned)(g[i] == key) << i;
+        e |= (unsigned)(g[i] == 0) << i;
+    }
+    *empty = e;
+    return m;
+}
+
+#if defined(CPF_SCAN_X86)
+__attribute__((target("sse2")))
+static unsigned eq64_sse2(__m128i x, __m128i k) {
+    __m128i e = _mm_cmpeq_epi32(x, k);
+    e = _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned)_mm_movemask_pd(_mm_castsi128_pd(e));
+}
+
+__attribute__((target("sse2")))
+static unsigned group_sse2(const uint64_t* g, uint64_t key, unsigned* empty) {
+    const __m128i k = _mm_set1_epi64x((long long)key);
+    const __m128i z = _mm_setzero_si128();
+    unsigned m = 0, e = 0;
+    for (unsigned i = 0; i < CPF_SCAN_GROUP; i += 2) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(g + i));
+        m |= eq64_sse2(x, k) << i;
+        e |= eq64_sse2(x, z) << i;
+    }
+    *empty = e;
+    return m;
+}
+
+__attribute__((target("avx2")))
+static unsigned group_avx2(const uint64_t* g, uint64_t key, unsigned* empty) {
+    const __m256i k = _mm256_set1_epi64x((long long)key);
+    const __m256i z = _mm256_setzero_si256();
+    __m256i a = _mm256_loadu_si256((const __m256i*)g);
+    __m256i b = _mm256_loadu_si256((const __m256i*)(g + 4));
+    unsigned m = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, k))) |
+                 (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(b, k))) << 4;
+    *empty = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, z))) |
+             (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(b, z))) << 4;
+    return m;
+}
+#endif
+
+typedef unsigned (*GroupFn)(const uint64_t*, uint64_t, unsigned*);
+
+static CpfScanLevel supported_level(void) {
+#if defined(CPF_SCAN_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return CPF_SCAN_AVX2;
+    if (__builtin_cpu_supports("sse2")) return CPF_SCAN_SSE2;
+#endif
+    return CPF_SCAN_SCALAR;
+}
+
+static GroupFn fn_for(CpfScanLevel level) {
+#if defined(CPF_SCAN_X86)
+    if (level == CPF_SCAN_AVX2) return group_avx2;
+    if (level == CPF_SCAN_SSE2) return group_sse2;
+#endif
+    (void)level;
+    return group_scalar;
+}
+
+static unsigned group_resolve(const uint64_t* g, uint64_t key, unsigned* empty);
+
+/* Leitores em várias threads (PatientList compartilhada): o ponteiro é
+   atômico. Carga relaxed basta: quem ainda vê group_resolve só passa por
+   cpf_scan_init, que é idempotente. */
+static _Atomic(GroupFn) g_group = group_resolve;
+static _Atomic int g_level = CPF_SCAN_SCALAR;
+
+void cpf_scan_init(void) {
+    GroupFn expected = group_resolve;
+    CpfScanLevel level = supported_level();
+    /* Só a primeira resolução grava; não desfaz um cpf_scan_set_level */
+    if (atomic_compare_exchange_strong(&g_group, &expected, fn_for(level)))
+        atomic_store(&g_level, (int)level);
+}
+
+/* Chamada antes de cpf_scan_init (uso direto do módulo): resolve e segue. */
+static unsigned group_resolve(const uint64_t* g, uint64_t key, unsigned* empty) {
+    cpf_scan_init();
+    return atomic_load_explicit(&g_group, memory_order_relaxed)(g, key, empty);
+}
+
+unsigned cpf_group_match(const uint64_t g[CPF_SCAN_GROUP], uint64_t key, unsigned* empty) {
+    return atomic_load_explicit(&g_group, memory_order_relaxed)(g, key, empty);
+}
+
+unsigned cpf_scan_first_bit(unsigned m) {
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctz(m);
+#else
+    unsigned i = 0;
+    while (!(m & 1u)) { m >>= 1; i++; }
+    return i;
+#endif
+}
+
+size_t cpf_key_scan(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t i = 0;
+    unsigned empty;
+    GroupFn group = atomic_load_explicit(&g_group, memory_order_relaxed);
+    for (; i + CPF_SCAN_GROUP <= n; i += CPF_SCAN_GROUP) {
+        unsigned m = group(keys + i, key, &empty);
+        if (m) return i + cpf_scan_first_bit(m);
+    }
+    for (; i < n; i++)
+        if (keys[i] == key) return i;
+    return n;
+}
+
+CpfScanLevel cpf_scan_level(void) {
+    cpf_scan_init();
+    return (CpfScanLevel)atomic_load(&g_level);
+}
+
+CpfScanLevel cpf_scan_set_level(CpfScanLevel level) {
+    CpfScanLevel max = supported_level();
+    if (level > max) level = max;
+    atomic_store(&g_level, (int)level);
+    atomic_store(&g_group, fn_for(level));
+    return level;
+}
+
+const char* cpf_scan_level_name(CpfScanLevel level) {
+    switch (level) {
+        case CPF_SCAN_SCALAR: return "escalar";
+        case CPF_SCAN_SSE2:   return "sse2";
+        case CPF_SCAN_AVX2:   return "avx2";
+    }
+    return "?";
+}
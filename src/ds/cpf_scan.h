@@ -0,0 +1,49 @@
+#ifndef CPF_SCAN_H
+#define CPF_SCAN_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
+
+/*
+  Núcleo de comparação de chaves compactas de CPF (model/cpf.h) em lote.
+
+  Compara uma chave contra um grupo de CPF_SCAN_GROUP chaves de uma vez:
+    - AVX2: 4 chaves por instrução (2 por grupo), escolhido em tempo de
+      execução se a CPU suporta;
+    - SSE2: 2 chaves por instrução (4 por grupo), base de todo x86-64;
+    - escalar: laço simples, em qualquer outra arquitetura.
+  O resultado é uma máscara de bits (bit i = chave i do grupo casou).
+*/
+
+#define CPF_SCAN_GROUP 8  /* 8 x 8 bytes = uma linha de cache */
+
+typedef enum {
+    CPF_SCAN_SCALAR = 0,
+    CPF_SCAN_SSE2,
+    CPF_SCAN_AVX2
+} CpfScanLevel;
+
+/* Detecta a CPU e escolhe o núcleo (uma vez; chamadas seguintes não fazem
+   nada). cpf_index_init chama, então quem usa a PatientList não precisa. */
+void cpf_scan_init(void);
+
+/* Máscara das posições de g[0..7] iguais a key; *empty recebe a máscara das
+   posições iguais a 0 (slot vazio nas tabelas hash). */
+unsigned cpf_group_match(const uint64_t g[CPF_SCAN_GROUP], uint64_t key, unsigned* empty);
+
+/* Índice do bit menos significativo ligado (mask != 0). */
+unsigned cpf_scan_first_bit(unsigned mask);
+
+/* Primeira posição de keys[0..n) igual a key, ou n se não houver. */
+size_t cpf_key_scan(const uint64_t* keys, size_t n, uint64_t key);
+
+/* Nível em uso (o melhor suportado, salvo cpf_scan_set_level). */
+CpfScanLevel cpf_scan_level(void);
+
+/* Força um nível (benchmarks); pedidos acima do suportado são rebaixados.
+   Returns: o nível efetivamente em uso. */
+CpfScanLevel cpf_scan_set_level(CpfScanLevel level);
+
+const char* cpf_scan_level_name(CpfScanLevel level);
+
+#endif /* CPF_SCAN_H */
@@ -4,82 +4,116 @@
 #include <time.h>
 #include "ds/history_stack.h"
 
-static void now_timestamp(char out_timestamp[20]){
-    time_t current_time = time(NULL);
+#define HISTORY_MIN_CAP 64
+
+/* Formata o epoch do registro só na hora de exibir (YYYY-MM-DD HH:MM). */
+static void format_timestamp(int64_t epoch, char out_timestamp[20]){
+    time_t current_time = (time_t)epoch;
     struct tm local_time;
 #if defined(_POSIX_THREAD_SAFE_FUNCTIONS)
     localtime_r(&current_time, &local_time);
 #else  
     struct tm* tm_ptr = localtime(&current_time);
     if (tm_ptr) local_time = *tm_ptr;
+    else memset(&local_time, 0, sizeof local_time);
 #endif
     strftime(out_timestamp, 20, "%Y-%m-%d %H:%M", &local_time);
 }
 
 /*
- Inicializa a pilha de histórico.
+ Inicializa a pilha de histórico (modo ilimitado).
 
  Args:
    stack: Ponteiro para a pilha a ser inicializada.
 
  Efeito:
-   - Define stack->top = NULL e stack->size = 0.
+   - Pilha vazia, sem vetor alocado ainda (aloca no primeiro push).
 */
 void init_history_stack(HistoryStack* stack){
+    init_history_stack_bounded(stack, 0);
+}
+
+/*
+ Inicializa a pilha em modo limitado: guarda no máximo max_records
+ registros; ao encher, cada push descarta o mais antigo.
+
+ Args:
+   stack: Ponteiro para a pilha.
+   max_records: Limite K (0 = ilimitado).
+*/
+void init_history_stack_bounded(HistoryStack* stack, size_t max_records){
     if (stack == NULL)      // Se o ponteiro for nulo, significa que ele não está apontando 
         return;             // para lugar nenhum válido na memória.
         // Finaliza método por aqui mesmo
 
-    stack->top = NULL;  // Define o top como nulo, espaço vazio
+    stack->records = NULL;
+    stack->cap = 0;
+    stack->max_records = max_records;
+    stack->head = 0;
     stack->size = 0; // Define 0 para o tamanho da pilha
 }
 
 /*
- Cria um HistoryRecord do tipo QUEUE_OUT com timestamp atual e snapshot do paciente.
+ Cria um HistoryRecord do tipo QUEUE_OUT com o horário atual.
 
  Args:
-   patient: Ponteiro para o paciente atendido (pode ser NULL).
+   patient: Paciente atendido, de preferência o ponteiro do CADASTRO
+            (PatientList), que é estável; pode ser NULL.
 
  Returns:
    HistoryRecord preenchido.
 */
 HistoryRecord make_history_record(const Patient* patient){
     HistoryRecord record;
-    now_timestamp(record.timestamp); // Atribuindo timestamp ao atributo timestamp da struct
+    record.timestamp = (int64_t)time(NULL); // Epoch; texto só ao exibir
     record.action = QUEUE_OUT; // Ação realizada é a saída da lista de espera
-
-    if (patient) { // Se existir o paciente...
-        record.patient = *patient; // Atribui o endereço do paciente ao atributo da struct
-    } else {
-        // Função padrão do C para "setar memória" (memory set). Ela preenche um bloco de memória com um valor específico.
-        // &record.patient: endereço de onde começar a preencher.
-        // 0: com qual valor preencher (nesse caso, tudo com zeros).
-        // sizeof(record.patient): quantos bytes devem ser preenchidos (o tamanho exato da estrutura de um paciente).
-        memset(&record.patient, 0, sizeof(record.patient));
-    }
+    record.patient = patient;
+    record.level = (unsigned char)(patient ? patient->priority : 0);
+    record.enqueued_ns = 0; // quem atende preenche (dequeue_timed)
     return record; // Devolve o objeto record com os dados manipulados
 }
 
+/* Dobra o vetor (respeitando o limite) e "desenrola" o anel para o início. */
+static int grow(HistoryStack* stack) {
+    size_t new_cap = stack->cap ? stack->cap * 2 : HISTORY_MIN_CAP;
+    if (stack->max_records && new_cap > stack->max_records) new_cap = stack->max_records;
+
+    HistoryRecord* records = malloc(new_cap * sizeof(HistoryRecord));
+    if (!records) return 0;
+    for (size_t i = 0; i < stack->size; i++)
+        records[i] = stack->records[(stack->head + i) % stack->cap];
+
+    free(stack->records);
+    stack->records = records;
+    stack->cap = new_cap;
+    stack->head = 0;
+    return 1;
+}
+
 /*
  Empilha um registro de histórico na pilha.
 
  Args:
    stack: Ponteiro para a pilha global.
-   record: Registro de histórico (snapshot do paciente).
-*/
-void push_history(HistoryStack* stack, HistoryRecord record) {
-    if (!stack) return;
+   record: Registro de histórico.
 
-    HistoryNode* newNode = malloc(sizeof(HistoryNode));
-    if (!newNode) {
-        puts("Erro: falha ao alocar memória para histórico.");
-        return;
+ Returns:
+   1 em sucesso (inclusive quando descarta o mais antigo), 0 sem memória.
+*/
+int push_history(HistoryStack* stack, HistoryRecord record) {
+    if (!stack) return 0;
+
+    if (stack->max_records && stack->size == stack->max_records) {
+        /* Cheia no modo limitado: o novo topo ocupa o lugar do mais antigo */
+        stack->records[stack->head] = record;
+        stack->head = (stack->head + 1) % stack->cap;
+        return 1;
     }
+    if (stack->size == stack->cap && !grow(stack)) return 0;
 
-    newNode->data = record;
-    newNode->next = stack->top;
-    stack->top = newNode;
+    stack->records[(stack->head + stack->size) % stack->cap] = record;
     stack->size++;
+    return 1;
 }
 
 /*
@@ -87,51 +121,116 @@ void push_history(HistoryStack* stack, HistoryRecord record) {
  Retorna 1 se removeu com sucesso, 0 se pilha vazia.
 */
 int pop_history(HistoryStack* stack, HistoryRecord* out_record) {
-    if (!stack || !stack->top) return 0;
-
-    HistoryNode* temp = stack->top;
-    if (out_record) *out_record = temp->data;
+    if (!stack || stack->size == 0) return 0;
 
-    stack->top = temp->next;
-    free(temp);
+    size_t top = (stack->head + stack->size - 1) % stack->cap;
+    if (out_record) *out_record = stack->records[top];
     stack->size--;
     return 1;
 }
 
+const HistoryRecord* history_at(const HistoryStack* stack, size_t i) {
+    if (!stack || i >= stack->size) return NULL;
+    return &stack->records[(stack->head + stack->size - 1 - i) % stack->cap];
+}
+
+/*
+ Desfaz o último atendimento (topo da pilha).
+
+ O paciente volta para a FRENTE do nível de onde saiu (enqueue_front_at), sem
+ percorrer a fila: como dequeue sempre tira do início de um nível, a fila
+ fica idêntica à de antes do atendimento. A chegada original (enqueued_ns
+ do registro) volta junto, então com envelhecimento quem já tinha passado
+ do limite continua passando na frente.
+
+ Args:
+   stack: Histórico.
+   queue: Fila de atendimento.
+   out:   Recebe o registro desfeito (opcional).
+
+ Returns:
+   UNDO_OK; UNDO_EMPTY; UNDO_NO_PATIENT (registro órfão, descartado);
+   UNDO_NOMEM (nada muda, o registro continua no topo).
+*/
+UndoStatus undo_last_service(HistoryStack* stack, PatientQueue* queue, HistoryRecord* out) {
+    const HistoryRecord* top = history_at(stack, 0);
+    if (!top) return UNDO_EMPTY;
+    if (out) *out = *top;
+
+    if (!top->patient) {
+        pop_history(stack, NULL);
+        return UNDO_NO_PATIENT;
+    }
+
+    /* A fila guarda o handle do cadastro; o nível é o do paciente, o mesmo
+       registrado no atendimento (a prioridade no cadastro não muda) */
+    if (!enqueue_front_at(queue, top->patient, top->enqueued_ns)) return UNDO_NOMEM;
+
+    pop_history(stack, NULL);
+    return UNDO_OK;
+}
+
 /*
- Exibe todo o histórico (topo → base)
+ Exibe todo o histórico (topo → base). Os dados do paciente vêm do
+ cadastro através do handle guardado no registro.
 */
 void print_history(const HistoryStack* stack) {
-    if (!stack || !stack->top) {
+    if (!stack || stack->size == 0) {
         puts("\nNenhum atendimento realizado ainda.\n");
         return;
     }
 
-    printf("\n========== HISTÓRICO DE ATENDIMENTOS ==========\n");
-    HistoryNode* curr = stack->top;
-    int index = 1;
-    while (curr) {
-        const HistoryRecord* rec = &curr->data;
-        printf("%d) [%s] %s (CPF: %s, prioridade %d)\n",
-               index++, rec->timestamp,
-               rec->patient.name,
-               rec->patient.cpf,
-               rec->patient.priority);
-        curr = curr->next;
+    OutBuffer* out = out_stdout();
+    out_str(out, "\n========== HISTÓRICO DE ATENDIMENTOS ==========\n");
+    print_history_page(stack, out, 0, OUT_ALL);
+    out_str(out, "===============================================\n");
+    out_flush(out);
+}
+
+/*
+ Escreve os registros [offset, offset + limit) do topo para a base:
+ "N) [YYYY-MM-DD HH:MM] Nome (CPF: ..., prioridade P)".
+*/
+size_t print_history_page(const HistoryStack* stack, OutBuffer* out,
+                          size_t offset, size_t limit) {
+    if (!stack) return 0;
+    size_t end = out_page_end(offset, limit);
+    if (end > stack->size) end = stack->size;
+
+    char timestamp[20];
+    int64_t formatted = INT64_MIN; // epoch já formatado em timestamp
+    size_t written = 0;
+    for (size_t i = offset; i < end; i++) { // acesso direto no anel: sem percorrer
+        const HistoryRecord* rec = history_at(stack, i);
+        // Atendimentos vizinhos costumam cair no mesmo segundo/minuto:
+        // localtime + strftime só quando o epoch muda
+        if (rec->timestamp != formatted) {
+            format_timestamp(rec->timestamp, timestamp);
+            formatted = rec->timestamp;
+        }
+        out_u64(out, (uint64_t)i + 1);
+        out_str(out, ") [");
+        out_str(out, timestamp);
+        out_str(out, "] ");
+        if (rec->patient) {
+            out_str(out, rec->patient->name);
+            out_str(out, " (CPF: ");
+            out_str(out, rec->patient->cpf);
+            out_str(out, ", prioridade ");
+            out_int(out, rec->level);
+            out_str(out, ")\n");
+        } else {
+            out_str(out, "(paciente não encontrado no cadastro)\n");
+        }
+        written++;
     }
-    printf("===============================================\n");
+    return written;
 }
 
 /*
- Libera toda a memória da pilha de histórico.
+ Libera toda a memória da pilha de histórico (um único vetor).
 */
 void free_history(HistoryStack* stack) {
-    HistoryNode* curr = stack->top;
-    while (curr) {
-        HistoryNode* temp = curr;
-        curr = curr->next;
-        free(temp);
-    }
-    stack->top = NULL;
-    stack->size = 0;
-}
\ No newline at end of file
+    free(stack->records);
+    init_history_stack_bounded(stack, stack->max_records);
+}
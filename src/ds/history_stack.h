@@ -3,38 +3,57 @@
 
 #include <stddef.h>  /* size_t */
 #include "model/history.h"
+#include "ds/patient_queue.h"
+#include "util/out_buffer.h"
 
 /*
   Pilha LIFO de HistoryRecord para "desfazer" o último atendimento.
-*/
 
-/*
-    Struct que representa o nó da pilha de histórico
+  Implementada como buffer circular contíguo: no modo limitado guarda no
+  máximo max_records registros e, cheia, descarta o mais antigo. No modo
+  ilimitado (max_records == 0) o vetor dobra quando enche.
 */
-typedef struct HistoryNode{
-    HistoryRecord data; // Struct contendo dados da auditoria
-    struct HistoryNode* next; // ponteiro para proximo da lista
-} HistoryNode;
-
 
 /*
     Pilha de atendimentos (histórico)
-    Struct contendo dados do node e o seu tamanho 
+    Vetor circular: o registro mais antigo fica em records[head] e o topo em
+    records[(head + size - 1) % cap].
 */
 typedef struct {
-    HistoryNode* top; // representação do topo da pilha
-    size_t size; //Numero de nós na pilha
+    HistoryRecord* records; // vetor circular
+    size_t cap;             // capacidade alocada
+    size_t max_records;     // limite K (0 = ilimitado)
+    size_t head;            // índice do registro mais antigo
+    size_t size;            // Numero de registros na pilha
 } HistoryStack;
 
 
+/* Resultado de undo_last_service */
+typedef enum {
+    UNDO_OK = 0,
+    UNDO_EMPTY,       // histórico vazio
+    UNDO_NO_PATIENT,  // registro sem paciente no cadastro (descartado)
+    UNDO_NOMEM        // sem memória na fila (histórico intacto)
+} UndoStatus;
+
 /* Funções públicas da pilha de histórico */
 void init_history_stack(HistoryStack* stack);
+void init_history_stack_bounded(HistoryStack* stack, size_t max_records);
 HistoryRecord make_history_record(const Patient* patient);
-void push_history(HistoryStack* stack, HistoryRecord record);
+int push_history(HistoryStack* stack, HistoryRecord record);
 int pop_history(HistoryStack* stack, HistoryRecord* out_record);
+/* i-ésimo registro a partir do topo (0 = topo); NULL se fora da faixa. */
+const HistoryRecord* history_at(const HistoryStack* stack, size_t i);
+/* Desfaz o último atendimento em O(1): desempilha o topo e devolve o
+   paciente ao INÍCIO do seu nível na fila. out (opcional) recebe o registro. */
+UndoStatus undo_last_service(HistoryStack* stack, PatientQueue* queue, HistoryRecord* out);
 void print_history(const HistoryStack* stack);
+/* Modo página: registros [offset, offset + limit) a partir do topo, sem
+   cabeçalho e sem flush. Returns: quantas linhas foram escritas. */
+size_t print_history_page(const HistoryStack* stack, OutBuffer* out,
+                          size_t offset, size_t limit);
 void free_history(HistoryStack* stack);
 
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,253 @@
+#include <string.h>
+#include "id_index.h"
+
+/*
+ Árvore B+ de ids.
+
+ Inserção iterativa: a descida guarda o caminho (nó + filho escolhido em
+ cada nível). Antes de mexer em qualquer nó, conta quantos vão dividir
+ (folha cheia e os pais cheios logo acima) e já separa os nós novos no
+ pool; se faltar memória, a árvore continua intacta.
+*/
+
+void id_index_init(IdIndex* idx) {
+    idx->root = NULL;
+    idx->count = 0;
+    idx->height = 0;
+    slab_pool_init(&idx->node_pool, sizeof(IdNode));
+}
+
+/* Primeira posição com keys[i] >= id */
+static int lower_bound(const IdNode* n, int id) {
+    int lo = 0, hi = n->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (n->keys[mid] < id) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* Primeira posição com keys[i] > id (filho a seguir num nó interno) */
+static int upper_bound(const IdNode* n, int id) {
+    int lo = 0, hi = n->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (n->keys[mid] <= id) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static const IdNode* find_leaf(const IdIndex* idx, int id) {
+    const IdNode* n = idx->root;
+    while (n && !n->leaf) n = n->u.child[upper_bound(n, id)];
+    return n;
+}
+
+const Patient* id_index_find(const IdIndex* idx, int id) {
+    const IdNode* leaf = find_leaf(idx, id);
+    if (!leaf) return NULL;
+    int pos = lower_bound(leaf, id);
+    return (pos < leaf->count && leaf->keys[pos] == id) ? leaf->u.val[pos] : NULL;
+}
+
+static IdNode* new_node(IdNode** spare, int* n_spare, int leaf) {
+    IdNode* n = spare[--*n_spare];
+    n->leaf = leaf;
+    n->count = 0;
+    n->next = NULL;
+    return n;
+}
+
+/* Insere (id, p) na posição pos da folha; divide se estiver cheia.
+   Returns: irmão novo à direita (ou NULL) e sua menor chave em *up_key. */
+static IdNode* leaf_insert(IdNode* leaf, int pos, int id, const Patient* p,
+                           IdNode** spare, int* n_spare, int* up_key) {
+    if (leaf->count < ID_INDEX_ORDER) {
+        memmove(leaf->keys + pos + 1, leaf->keys + pos, (size_t)(leaf->count - pos) * sizeof(int));
+        memmove(leaf->u.val + pos + 1, leaf->u.val + pos,
+                (size_t)(leaf->count - pos) * sizeof(const Patient*));
+        leaf->keys[pos] = id;
+        leaf->u.val[pos] = p;
+        leaf->count++;
+        return NULL;
+    }
+
+    int keys[ID_INDEX_ORDER + 1];
+    const Patient* vals[ID_INDEX_ORDER + 1];
+    memcpy(keys, leaf->keys, (size_t)pos * sizeof(int));
+    memcpy(vals, leaf->u.val, (size_t)pos * sizeof(const Patient*));
+    keys[pos] = id;
+    vals[pos] = p;
+    memcpy(keys + pos + 1, leaf->keys + pos, (size_t)(ID_INDEX_ORDER - pos) * sizeof(int));
+    memcpy(vals + pos + 1, leaf->u.val + pos, (size_t)(ID_INDEX_ORDER - pos) * sizeof(const Patient*));
+
+    IdNode* right = new_node(spare, n_spare, 1);
+    int total = ID_INDEX_ORDER + 1;
+    int left_n = total / 2;
+    leaf->count = left_n;
+    memcpy(leaf->keys, keys, (size_t)left_n * sizeof(int));
+    memcpy(leaf->u.val, vals, (size_t)left_n * sizeof(const Patient*));
+    right->count = total - left_n;
+    memcpy(right->keys, keys + left_n, (size_t)right->count * sizeof(int));
+    memcpy(right->u.val, vals + left_n, (size_t)right->count * sizeof(const Patient*));
+
+    right->next = leaf->next;
+    leaf->next = right;
+    *up_key = right->keys[0];
+    return right;
+}
+
+/* Insere a chave key e o filho child à direita dela, na posição pos.
+   Divide se cheio. Returns: irmão novo (ou NULL); *up_key sobe ao pai. */
+static IdNode* internal_insert(IdNode* n, int pos, int key, IdNode* child,
+                               IdNode** spare, int* n_spare, int* up_key) {
+    if (n->count < ID_INDEX_ORDER) {
+        memmove(n->keys + pos + 1, n->keys + pos, (size_t)(n->count - pos) * sizeof(int));
+        memmove(n->u.child + pos + 2, n->u.child + pos + 1,
+                (size_t)(n->count - pos) * sizeof(IdNode*));
+        n->keys[pos] = key;
+        n->u.child[pos + 1] = child;
+        n->count++;
+        return NULL;
+    }
+
+    int keys[ID_INDEX_ORDER + 1];
+    IdNode* kids[ID_INDEX_ORDER + 2];
+    memcpy(keys, n->keys, (size_t)pos * sizeof(int));
+    keys[pos] = key;
+    memcpy(keys + pos + 1, n->keys + pos, (size_t)(ID_INDEX_ORDER - pos) * sizeof(int));
+    memcpy(kids, n->u.child, (size_t)(pos + 1) * sizeof(IdNode*));
+    kids[pos + 1] = child;
+    memcpy(kids + pos + 2, n->u.child + pos + 1, (size_t)(ID_INDEX_ORDER - pos) * sizeof(IdNode*));
+
+    /* A chave do meio sobe; esquerda fica com [0, mid), direita com (mid, total) */
+    int total = ID_INDEX_ORDER + 1;
+    int mid = total / 2;
+    IdNode* right = new_node(spare, n_spare, 0);
+    n->count = mid;
+    memcpy(n->keys, keys, (size_t)mid * sizeof(int));
+    memcpy(n->u.child, kids, (size_t)(mid + 1) * sizeof(IdNode*));
+    right->count = total - mid - 1;
+    memcpy(right->keys, keys + mid + 1, (size_t)right->count * sizeof(int));
+    memcpy(right->u.child, kids + mid + 1, (size_t)(right->count + 1) * sizeof(IdNode*));
+    *up_key = keys[mid];
+    return right;
+}
+
+int id_index_insert(IdIndex* idx, int id, const Patient* patient) {
+    IdNode* spare[ID_INDEX_MAX_HEIGHT + 1];
+    int n_spare = 0;
+
+    if (!idx->root) {
+        IdNode* leaf = slab_pool_alloc(&idx->node_pool);
+        if (!leaf) return 0;
+        spare[n_spare++] = leaf;
+        idx->root = new_node(spare, &n_spare, 1);
+        idx->height = 1;
+    }
+
+    /* Descida guardando o caminho */
+    IdNode* path[ID_INDEX_MAX_HEIGHT];
+    int slot[ID_INDEX_MAX_HEIGHT];
+    int depth = 0;
+    IdNode* n = idx->root;
+    while (!n->leaf) {
+        int i = upper_bound(n, id);
+        path[depth] = n;
+        slot[depth++] = i;
+        n = n->u.child[i];
+    }
+    int pos = lower_bound(n, id);
+    if (pos < n->count && n->keys[pos] == id) return 0; /* id repetido */
+
+    /* Quantos nós novos esta inserção exige (divisões + nova raiz) */
+    int need = 0;
+    if (n->count == ID_INDEX_ORDER) {
+        need = 1;
+        int d = depth - 1;
+        while (d >= 0 && path[d]->count == ID_INDEX_ORDER) { need++; d--; }
+        if (d < 0) need++; /* a raiz também divide */
+        if (need > ID_INDEX_MAX_HEIGHT) return 0;
+    }
+    for (; n_spare < need; n_spare++) {
+        spare[n_spare] = slab_pool_alloc(&idx->node_pool);
+        if (!spare[n_spare]) {
+            while (n_spare-- > 0) slab_pool_free(&idx->node_pool, spare[n_spare]);
+            return 0;
+        }
+    }
+
+    int up_key;
+    IdNode* split = leaf_insert(n, pos, id, patient, spare, &n_spare, &up_key);
+    while (split && depth > 0) {
+        depth--;
+        split = internal_insert(path[depth], slot[depth], up_key, split, spare, &n_spare, &up_key);
+    }
+    if (split) {
+        /* Raiz dividiu: a árvore cresce um nível */
+        IdNode* root = new_node(spare, &n_spare, 0);
+        root->count = 1;
+        root->keys[0] = up_key;
+        root->u.child[0] = idx->root;
+        root->u.child[1] = split;
+        idx->root = root;
+        idx->height++;
+    }
+    idx->count++;
+    return 1;
+}
+
+int id_index_remove(IdIndex* idx, int id) {
+    IdNode* leaf = (IdNode*)find_leaf(idx, id);
+    if (!leaf) return 0;
+    int pos = lower_bound(leaf, id);
+    if (pos >= leaf->count || leaf->keys[pos] != id) return 0;
+    memmove(leaf->keys + pos, leaf->keys + pos + 1, (size_t)(leaf->count - pos - 1) * sizeof(int));
+    memmove(leaf->u.val + pos, leaf->u.val + pos + 1,
+            (size_t)(leaf->count - pos - 1) * sizeof(const Patient*));
+    leaf->count--;
+    idx->count--;
+    return 1;
+}
+
+int id_index_max(const IdIndex* idx) {
+    if (!idx->count) return 0;
+    /* A folha mais à direita pode ter ficado vazia por remoções: desce pela
+       direita e, se preciso, busca a maior chave por uma faixa completa. */
+    const IdNode* n = idx->root;
+    while (!n->leaf) n = n->u.child[n->count];
+    if (n->count) return n->keys[n->count - 1];
+    int max = 0;
+    IdCursor cur = id_index_range(idx, -2147483647 - 1, 2147483647);
+    for (const Patient* p; (p = id_cursor_next(&cur)) != NULL;) max = p->id;
+    return max;
+}
+
+IdCursor id_index_range(const IdIndex* idx, int lo, int hi) {
+    IdCursor cur;
+    cur.leaf = find_leaf(idx, lo);
+    cur.pos = cur.leaf ? lower_bound(cur.leaf, lo) : 0;
+    cur.hi = hi;
+    return cur;
+}
+
+const Patient* id_cursor_next(IdCursor* cur) {
+    while (cur->leaf && cur->pos >= cur->leaf->count) {
+        cur->leaf = cur->leaf->next; /* folha seguinte (pode estar vazia) */
+        cur->pos = 0;
+    }
+    if (!cur->leaf || cur->leaf->keys[cur->pos] > cur->hi) {
+        cur->leaf = NULL;
+        return NULL;
+    }
+    return cur->leaf->u.val[cur->pos++];
+}
+
+void id_index_free(IdIndex* idx) {
+    slab_pool_destroy(&idx->node_pool); /* todos os nós saem em bloco */
+    idx->root = NULL;
+    idx->count = 0;
+    idx->height = 0;
+}
@@ -0,0 +1,71 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include <stddef.h>  /* size_t */
+#include "model/patient.h"
+#include "util/slab_pool.h"
+
+/*
+  Índice ordenado de id -> Patient* (árvore B+ em memória).
+
+  Nós internos só guiam a busca; os pares (id, paciente) ficam nas folhas,
+  encadeadas da esquerda para a direita. Assim:
+    - busca pontual e unicidade de id: O(log n);
+    - faixa [a, b]: desce uma vez até a e segue pelas folhas, sem percorrer
+      o cadastro inteiro.
+  Como o CpfIndex, não é dono dos Patient: guarda ponteiros estáveis para
+  os dados nos nós da PatientList. Os nós da árvore vêm de um SlabPool.
+*/
+
+#define ID_INDEX_ORDER 32       /* máximo de chaves por nó */
+#define ID_INDEX_MAX_HEIGHT 16  /* 16^16 chaves: nunca é atingido na prática */
+
+typedef struct IdNode {
+    int leaf;                         // 1 = folha
+    int count;                        // chaves em uso
+    int keys[ID_INDEX_ORDER];
+    union {
+        struct IdNode* child[ID_INDEX_ORDER + 1]; // interno: child[i] < keys[i] <= child[i+1]
+        const Patient* val[ID_INDEX_ORDER];       // folha: paciente de keys[i]
+    } u;
+    struct IdNode* next;              // folha seguinte (ids maiores)
+} IdNode;
+
+typedef struct {
+    IdNode* root;        // NULL => vazio
+    size_t count;        // ids indexados
+    int height;          // níveis (1 = só a raiz-folha)
+    SlabPool node_pool;  // nós da árvore
+} IdIndex;
+
+/* Cursor de faixa: percorre em ordem crescente de id. */
+typedef struct {
+    const IdNode* leaf;
+    int pos;
+    int hi;              // último id incluído
+} IdCursor;
+
+void id_index_init(IdIndex* idx);
+
+/* Busca pontual. Returns: Patient* ou NULL. */
+const Patient* id_index_find(const IdIndex* idx, int id);
+
+/* Insere id -> patient. Returns: 1 se inseriu, 0 se duplicado/sem memória. */
+int id_index_insert(IdIndex* idx, int id, const Patient* patient);
+
+/* Remove id (a folha pode ficar com menos chaves; não há rebalanceamento).
+   Returns: 1 se removeu, 0 se não existia. */
+int id_index_remove(IdIndex* idx, int id);
+
+/* Maior id indexado (0 se vazio). */
+int id_index_max(const IdIndex* idx);
+
+/* Posiciona um cursor no primeiro id >= lo; a faixa termina em hi. */
+IdCursor id_index_range(const IdIndex* idx, int lo, int hi);
+
+/* Próximo paciente da faixa (ordem crescente de id) ou NULL no fim. */
+const Patient* id_cursor_next(IdCursor* cur);
+
+void id_index_free(IdIndex* idx);
+
+#endif /* ID_INDEX_H */
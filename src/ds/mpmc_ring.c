@@ -0,0 +1,85 @@
+/*
+ Módulo: mpmc_ring.c
+ Papel:  Anel limitado sem lock para as chegadas de vários balcões
+         (ver concurrent_queue.c).
+
+ Ordem de memória: a célula é publicada com store-release em seq e lida
+ depois de um load-acquire do mesmo seq; os CAS em head/tail só reservam a
+ posição (relaxed), quem sincroniza o conteúdo é o seq da célula.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "mpmc_ring.h"
+
+struct MpmcCell {
+    atomic_size_t seq;
+    QueueTicket ticket;
+};
+
+int mpmc_ring_init(MpmcRing* r, size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap *= 2;
+    r->cells = malloc(cap * sizeof *r->cells);
+    if (!r->cells) return 0;
+    for (size_t i = 0; i < cap; i++) atomic_init(&r->cells[i].seq, i);
+    r->mask = cap - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    return 1;
+}
+
+void mpmc_ring_destroy(MpmcRing* r) {
+    free(r->cells);
+    r->cells = NULL;
+    r->mask = 0;
+}
+
+int mpmc_ring_push(MpmcRing* r, const QueueTicket* t) {
+    size_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    MpmcCell* cell;
+    for (;;) {
+        cell = &r->cells[pos & r->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            // Célula livre nesta volta: tenta reservar a posição
+            if (atomic_compare_exchange_weak_explicit(&r->head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return 0; // ainda ocupada pela volta anterior: cheio
+        } else {
+            pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+        }
+    }
+    cell->ticket = *t;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return 1;
+}
+
+int mpmc_ring_pop(MpmcRing* r, QueueTicket* t) {
+    size_t pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    MpmcCell* cell;
+    for (;;) {
+        cell = &r->cells[pos & r->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return 0; // nada publicado nesta posição: vazio
+        } else {
+            pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+    *t = cell->ticket;
+    atomic_store_explicit(&cell->seq, pos + r->mask + 1, memory_order_release);
+    return 1;
+}
+
+size_t mpmc_ring_capacity(const MpmcRing* r) {
+    return r->mask + 1;
+}
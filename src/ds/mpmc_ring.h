@@ -0,0 +1,51 @@
+#ifndef MPMC_RING_H
+#define MPMC_RING_H
+
+#include <stddef.h>      /* size_t */
+#include <stdint.h>      /* uint64_t */
+#include <stdatomic.h>
+#include "../model/patient.h"
+
+/*
+  Anel limitado MPMC (vários produtores, vários consumidores) sem lock.
+
+  Cada célula tem um número de sequência (esquema de Vyukov): o produtor
+  que ganha o CAS na cabeça escreve a célula e publica seq = pos + 1; o
+  consumidor que ganha o CAS na cauda lê e devolve a célula para a próxima
+  volta (seq = pos + capacidade). Ninguém espera por ninguém: cheio/vazio
+  viram retorno 0 e quem chamou decide se tenta de novo.
+*/
+
+/* Entrada do anel: handle do cadastro + instante de chegada */
+typedef struct {
+    const Patient* patient;
+    uint64_t enqueued_ns;
+} QueueTicket;
+
+typedef struct MpmcCell MpmcCell; /* definido no .c */
+
+typedef struct {
+    MpmcCell* cells;
+    size_t mask;                 // capacidade - 1 (potência de 2)
+    char pad0[64];
+    atomic_size_t head;          // próxima posição de escrita
+    char pad1[64];               // cabeça e cauda em linhas de cache separadas
+    atomic_size_t tail;          // próxima posição de leitura
+    char pad2[64];
+} MpmcRing;
+
+/* Capacidade arredondada para potência de 2 (mínimo 2).
+   Returns: 1 ok, 0 sem memória. */
+int mpmc_ring_init(MpmcRing* r, size_t capacity);
+
+void mpmc_ring_destroy(MpmcRing* r);
+
+/* Returns: 1 se entrou, 0 se o anel está cheio. */
+int mpmc_ring_push(MpmcRing* r, const QueueTicket* t);
+
+/* Returns: 1 se tirou um item para *t, 0 se o anel está vazio. */
+int mpmc_ring_pop(MpmcRing* r, QueueTicket* t);
+
+size_t mpmc_ring_capacity(const MpmcRing* r);
+
+#endif /* MPMC_RING_H */
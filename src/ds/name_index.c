@@ -0,0 +1,264 @@
+#include <stdlib.h>
+#include <string.h>
+#include "name_index.h"
+
+/*
+ Trie compactada de nomes dobrados.
+
+ Cada aresta guarda um rótulo (ponteiro + tamanho) para dentro de uma chave
+ já armazenada na arena, então dividir uma aresta não copia texto: o nó do
+ meio fica com o começo do rótulo e o filho avança o ponteiro. Os filhos de
+ um nó formam uma lista de irmãos ordenada pelo primeiro caractere
+ (alfabeto pequeno: a-z, 0-9 e espaço), o que dá a ordem alfabética na
+ pré-ordem sem ordenar nada na consulta.
+*/
+
+#define NAME_BLOCK_SIZE (64u * 1024u)
+
+struct NameBlock {
+    NameBlock* next;
+    char data[NAME_BLOCK_SIZE];
+};
+
+/* Dobra de U+00C0..U+00FF (mesmos códigos em Latin-1): letra base ou espaço. */
+static const char latin1_fold[64] =
+    "aaaaaaaceeeeiiiidnooooo ouuuuyts"  /* À..ß */
+    "aaaaaaaceeeeiiiidnooooo ouuuuyty"; /* à..ÿ */
+
+size_t name_fold(const char* name, char* out, size_t cap) {
+    const unsigned char* s = (const unsigned char*)name;
+    size_t n = 0;
+    int pending_space = 0;
+
+    while (*s) {
+        unsigned char c = *s++;
+        char f = 0;
+        if (c < 0x80) {
+            if (c >= 'A' && c <= 'Z') f = (char)(c - 'A' + 'a');
+            else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) f = (char)c;
+            else f = ' ';
+        } else if (c == 0xC3 && (*s & 0xC0) == 0x80) {
+            f = latin1_fold[*s++ - 0x80];              /* UTF-8: C3 80..BF */
+        } else if (c >= 0xC0 && (*s & 0xC0) == 0x80) {
+            while ((*s & 0xC0) == 0x80) s++;           /* outro caractere UTF-8: ignora */
+        } else if (c >= 0xC0) {
+            f = latin1_fold[c - 0xC0];                 /* Latin-1 (console Windows) */
+        }
+        if (f == ' ') { pending_space = n > 0; continue; }
+        if (!f) continue;
+
+        size_t need = pending_space ? 2 : 1;
+        if (n + need >= cap) break;
+        if (pending_space) out[n++] = ' ';
+        out[n++] = f;
+        pending_space = 0;
+    }
+    if (cap) out[n] = '\0';
+    return n;
+}
+
+void name_index_init(NameIndex* idx) {
+    memset(&idx->root, 0, sizeof idx->root);
+    idx->count = 0;
+    slab_pool_init(&idx->node_pool, sizeof(NameNode));
+    slab_pool_init(&idx->entry_pool, sizeof(NameEntry));
+    idx->blocks = NULL;
+    idx->block_used = 0;
+}
+
+/* Reserva n bytes na arena de chaves (liberada só em name_index_free). */
+static char* arena_alloc(NameIndex* idx, size_t n) {
+    if (!idx->blocks || idx->block_used + n > NAME_BLOCK_SIZE) {
+        NameBlock* b = malloc(sizeof *b);
+        if (!b) return NULL;
+        b->next = idx->blocks;
+        idx->blocks = b;
+        idx->block_used = 0;
+    }
+    char* p = idx->blocks->data + idx->block_used;
+    idx->block_used += n;
+    return p;
+}
+
+/* Elo (ponteiro a alterar) do filho de node que começa por ch, ou da posição
+   onde ele entraria na lista ordenada de irmãos. */
+static NameNode** child_link(NameNode* node, unsigned char ch) {
+    NameNode** link = &node->child;
+    while (*link && (unsigned char)(*link)->label[0] < ch) link = &(*link)->sibling;
+    return link;
+}
+
+/* Insere a chave s[0..len) com uma entrada para patient.
+   Os dois nós que podem faltar (divisão + folha) e a entrada saem do pool
+   antes de mexer na trie; se faltar memória, nada muda. */
+static int insert_key(NameIndex* idx, const char* s, size_t len,
+                      const Patient* patient, const char* key, size_t off) {
+    NameEntry* e = slab_pool_alloc(&idx->entry_pool);
+    NameNode* spare[2];
+    spare[0] = slab_pool_alloc(&idx->node_pool);
+    spare[1] = slab_pool_alloc(&idx->node_pool);
+    if (!e || !spare[0] || !spare[1]) {
+        slab_pool_free(&idx->entry_pool, e);
+        slab_pool_free(&idx->node_pool, spare[0]);
+        slab_pool_free(&idx->node_pool, spare[1]);
+        return 0;
+    }
+    int n_spare = 2;
+
+    NameNode* node = &idx->root;
+    while (len > 0) {
+        NameNode** link = child_link(node, (unsigned char)s[0]);
+        NameNode* c = *link;
+        if (!c || c->label[0] != s[0]) {
+            /* Nenhuma aresta com esse começo: folha nova com o resto da chave */
+            NameNode* leaf = spare[--n_spare];
+            memset(leaf, 0, sizeof *leaf);
+            leaf->label = s;
+            leaf->len = (unsigned char)len;
+            leaf->sibling = c;
+            *link = leaf;
+            node = leaf;
+            break;
+        }
+
+        size_t m = 0;
+        while (m < c->len && m < len && c->label[m] == s[m]) m++;
+        if (m < c->len) {
+            /* Diverge no meio da aresta: nó intermediário com o trecho comum */
+            NameNode* mid = spare[--n_spare];
+            memset(mid, 0, sizeof *mid);
+            mid->label = c->label;
+            mid->len = (unsigned char)m;
+            mid->child = c;
+            mid->sibling = c->sibling;
+            c->label += m;
+            c->len = (unsigned char)(c->len - m);
+            c->sibling = NULL;
+            *link = mid;
+            c = mid;
+        }
+        node = c;
+        s += m;
+        len -= m;
+    }
+
+    e->patient = patient;
+    e->key = key;
+    e->off = (unsigned char)off;
+    e->next = node->entries;
+    node->entries = e;
+
+    while (n_spare > 0) slab_pool_free(&idx->node_pool, spare[--n_spare]);
+    return 1;
+}
+
+/* Retira a entrada de patient da chave exata s[0..len). */
+static int unlink_key(NameIndex* idx, const char* s, size_t len, const Patient* patient) {
+    NameNode* node = &idx->root;
+    while (len > 0) {
+        NameNode* c = *child_link(node, (unsigned char)s[0]);
+        if (!c || c->len > len || memcmp(c->label, s, c->len) != 0) return 0;
+        node = c;
+        s += c->len;
+        len -= c->len;
+    }
+    for (NameEntry** link = &node->entries; *link; link = &(*link)->next) {
+        if ((*link)->patient == patient) {
+            NameEntry* dead = *link;
+            *link = dead->next;
+            slab_pool_free(&idx->entry_pool, dead);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int is_word_start(const char* key, size_t i) {
+    return i == 0 || key[i - 1] == ' ';
+}
+
+int name_index_insert(NameIndex* idx, const Patient* patient) {
+    char folded[NAME_KEY_CAP];
+    size_t len = name_fold(patient->name, folded, sizeof folded);
+    char* key = arena_alloc(idx, len + 1);
+    if (!key) return 0;
+    memcpy(key, folded, len + 1);
+
+    /* Uma chave por palavra: o nome inteiro e cada sufixo que começa numa palavra */
+    for (size_t i = 0; i == 0 || i < len; i++) {
+        if (!is_word_start(key, i)) continue;
+        if (!insert_key(idx, key + i, len - i, patient, key, i)) {
+            while (i-- > 0) /* desfaz as palavras anteriores (a chave fica na arena) */
+                if (is_word_start(key, i)) unlink_key(idx, key + i, len - i, patient);
+            return 0;
+        }
+    }
+    idx->count++;
+    return 1;
+}
+
+int name_index_remove(NameIndex* idx, const Patient* patient) {
+    char key[NAME_KEY_CAP];
+    size_t len = name_fold(patient->name, key, sizeof key);
+    int removed = 0;
+    for (size_t i = 0; i == 0 || i < len; i++)
+        if (is_word_start(key, i)) removed |= unlink_key(idx, key + i, len - i, patient);
+    if (removed) idx->count--;
+    return removed;
+}
+
+void name_index_prefix(const NameIndex* idx, const char* query, NameCursor* cur) {
+    cur->plen = name_fold(query, cur->prefix, sizeof cur->prefix);
+    cur->entry = NULL;
+    cur->top = 0;
+
+    const char* q = cur->prefix;
+    size_t len = cur->plen;
+    const NameNode* node = &idx->root;
+    while (len > 0) {
+        const NameNode* c = *child_link((NameNode*)node, (unsigned char)q[0]);
+        if (!c) return;
+        size_t m = len < c->len ? len : c->len;
+        if (memcmp(c->label, q, m) != 0) return;
+        node = c; /* prefixo pode terminar no meio desta aresta: subárvore inteira casa */
+        q += m;
+        len -= m;
+    }
+    cur->entry = node->entries;
+    if (node->child) cur->stack[cur->top++] = node->child;
+}
+
+/* O nome já casou numa palavra anterior? (evita repetir o paciente) */
+static int matched_before(const NameEntry* e, const char* prefix, size_t plen) {
+    for (size_t i = 0; i < e->off; i++)
+        if (is_word_start(e->key, i) && strncmp(e->key + i, prefix, plen) == 0) return 1;
+    return 0;
+}
+
+const Patient* name_cursor_next(NameCursor* cur) {
+    for (;;) {
+        while (!cur->entry) {
+            if (cur->top == 0) return NULL;
+            const NameNode* n = cur->stack[--cur->top];
+            /* Irmão fica pendente; o filho sai primeiro (pré-ordem) */
+            if (n->sibling) cur->stack[cur->top++] = n->sibling;
+            if (n->child) cur->stack[cur->top++] = n->child;
+            cur->entry = n->entries;
+        }
+        const NameEntry* e = cur->entry;
+        cur->entry = e->next;
+        if (e->off && matched_before(e, cur->prefix, cur->plen)) continue;
+        return e->patient;
+    }
+}
+
+void name_index_free(NameIndex* idx) {
+    slab_pool_destroy(&idx->node_pool);
+    slab_pool_destroy(&idx->entry_pool);
+    while (idx->blocks) {
+        NameBlock* next = idx->blocks->next;
+        free(idx->blocks);
+        idx->blocks = next;
+    }
+    name_index_init(idx);
+}
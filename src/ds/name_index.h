@@ -0,0 +1,83 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <stddef.h>  /* size_t */
+#include "model/patient.h"
+#include "util/slab_pool.h"
+
+/*
+  Índice de nomes para busca por prefixo (trie compactada / radix tree).
+
+  A chave é o nome "dobrado": minúsculas, sem acento (UTF-8 ou Latin-1),
+  pontuação vira espaço e espaços repetidos colapsam. Assim "JOSÉ  da
+  Conceição" e "jose da conceicao" são a MESMA chave.
+
+  Cada palavra do nome também é indexada (a partir dela até o fim), então
+  "silva" encontra "Maria da Silva". Os resultados saem em ordem alfabética
+  da parte casada, de forma incremental (cursor): a primeira página custa
+  O(tamanho do prefixo + página), sem varrer o cadastro.
+
+  Como os outros índices, não é dono dos Patient: guarda ponteiros estáveis
+  para os dados nos nós da PatientList.
+*/
+
+#define NAME_KEY_CAP 100  /* cabe o name[100] do Patient dobrado */
+
+typedef struct NameEntry {
+    const Patient* patient;
+    const char* key;          // nome dobrado completo (na arena do índice)
+    unsigned char off;        // início da palavra indexada dentro de key
+    struct NameEntry* next;   // outros pacientes com a mesma chave
+} NameEntry;
+
+typedef struct NameNode {
+    const char* label;        // rótulo da aresta (aponta para uma chave da arena)
+    unsigned char len;        // tamanho do rótulo
+    struct NameNode* child;   // primeiro filho (irmãos ordenados por label[0])
+    struct NameNode* sibling; // próximo irmão
+    NameEntry* entries;       // chaves que terminam exatamente aqui
+} NameNode;
+
+typedef struct NameBlock NameBlock; /* bloco da arena de chaves (definido no .c) */
+
+typedef struct {
+    NameNode root;            // raiz (rótulo vazio)
+    size_t count;             // pacientes indexados
+    SlabPool node_pool;       // nós da trie
+    SlabPool entry_pool;      // entradas (uma por palavra do nome)
+    NameBlock* blocks;        // arena das chaves dobradas
+    size_t block_used;        // bytes usados no bloco atual
+} NameIndex;
+
+/* Cursor de busca: percorre a subárvore do prefixo em pré-ordem. */
+typedef struct {
+    char prefix[NAME_KEY_CAP];         // consulta já dobrada
+    size_t plen;
+    const NameEntry* entry;            // próxima entrada do nó atual
+    const NameNode* stack[NAME_KEY_CAP + 1]; // nós pendentes (profundidade <= chave)
+    int top;
+} NameCursor;
+
+/* Dobra um nome para chave (ver acima).
+   Returns: tamanho da chave escrita em out (cap >= 1; sempre termina em '\0'). */
+size_t name_fold(const char* name, char* out, size_t cap);
+
+void name_index_init(NameIndex* idx);
+
+/* Indexa o nome de patient. Returns: 1 se inseriu, 0 sem memória (nada muda). */
+int name_index_insert(NameIndex* idx, const Patient* patient);
+
+/* Retira as entradas de patient (os nós ficam; não há compactação).
+   Returns: 1 se removeu, 0 se não estava indexado. */
+int name_index_remove(NameIndex* idx, const Patient* patient);
+
+/* Posiciona cur no início dos nomes que têm uma palavra começando por query
+   (dobrada). query vazia => todos, em ordem alfabética. */
+void name_index_prefix(const NameIndex* idx, const char* query, NameCursor* cur);
+
+/* Próximo paciente (cada um aparece uma vez por busca) ou NULL no fim. */
+const Patient* name_cursor_next(NameCursor* cur);
+
+void name_index_free(NameIndex* idx);
+
+#endif /* NAME_INDEX_H */
@@ -9,11 +9,15 @@
    - <stdio.h>:
         Fornece funções de E/S, como printf() para exibir a lista e
         mensagens de erro/status.
-   - <stdlib.h>:
-        Essencial para o gerenciamento de memória dinâmica. Usamos malloc()
-        para alocar espaço para novos nós (Node) e free() para liberá-los.
-   - <string.h>:
-        Fornece a função strcmp() para comparar os CPFs durante a busca.
+   - "util/slab_pool.h":
+        Alocador por slabs. Os nós (Node) saem de um pool próprio da lista
+        em vez de um malloc()/free() por nó.
+   - "cpf_index.h":
+        Índice hash de CPF (endereçamento aberto, chave compacta de 64 bits)
+        usado na busca e na checagem de unicidade.
+   - "cpf_scan.h":
+        Núcleo de busca por grupo do índice de CPF; init_patient_list escolhe
+        a versão (escalar/SSE2/AVX2) uma vez, antes de a lista ser lida.
    - "patient_list.h":
         Header do próprio módulo. Traz as DECLARAÇÕES das estruturas (Patient,
         Node, PatientList) e os protótipos das funções públicas, formando o
@@ -27,9 +31,9 @@
 */
 
 #include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
 #include "patient_list.h"
+#include "cpf_scan.h"
+#include "util/patient_io.h"
 
 /*
  Função: init_patient_list
@@ -46,6 +50,14 @@
 */
 void init_patient_list(PatientList* list) {
     list->head = NULL;
+    list->size = 0;
+    cpf_scan_init(); // resolve o núcleo aqui, não na primeira busca concorrente
+    cpf_index_init(&list->cpf_index);
+    id_index_init(&list->id_index);
+    name_index_init(&list->name_index);
+    list->names_deferred = 0;
+    list->names_done = NULL;
+    slab_pool_init(&list->node_pool, sizeof(Node));
 }
 
 /*
@@ -57,33 +69,75 @@ void init_patient_list(PatientList* list) {
    - list: Ponteiro para a lista onde o paciente será inserido.
    - patient: Os dados do paciente a serem adicionados (copiados para a lista).
  Lógica de Implementação:
-   0. (NOVO) Verifica se já existe um paciente com o mesmo CPF; se existir,
-      não insere para manter unicidade de CPF.
-   1. Aloca memória dinamicamente para um novo 'Node' (o contêiner).
+   0. Empacota o CPF na chave de 64 bits (recusa CPF não numérico) e
+      verifica no índice hash se já existe um paciente com a mesma chave
+      e no índice de id se o id já foi usado; se existir, não insere para
+      manter a unicidade de CPF e de id.
+   1. Pega um 'Node' livre do pool da lista (o contêiner).
    2. Verifica se a alocação de memória foi bem-sucedida. É uma boa prática
       de programação defensiva para evitar que o programa quebre.
    3. Copia os dados do paciente para dentro do novo nó.
    4. O 'next' do novo nó aponta para o que era o antigo início da lista.
    5. A cabeça ('head') da lista passa a ser o novo nó que acabamos de criar.
+   6. Registra &newNode->data nos índices de id, nome e CPF. O nó nunca muda de
+      endereço, então os ponteiros guardados continuam válidos até free_list.
 */
 int insert_patient(PatientList *list, const Patient *p) {
     if (!list || !p) return 0;
 
-    /* Unicidade de CPF */
-    const Patient *dup = search_patient_by_CPF(list, p->cpf);
-    if (dup) return 0;
+    /* Unicidade de CPF (O(1) esperado via índice); a chave compacta é
+       calculada uma vez e reaproveitada na inserção abaixo */
+    uint64_t cpf_key;
+    if (!cpf_pack_key(p->cpf, &cpf_key)) return 0;
+    if (cpf_index_find_key(&list->cpf_index, cpf_key)) return 0;
 
-    Node *newNode = (Node*)malloc(sizeof(Node));
+    /* Unicidade de id (O(log n) via árvore B+) */
+    if (id_index_find(&list->id_index, p->id)) return 0;
+
+    Node *newNode = slab_pool_alloc(&list->node_pool);
     if (!newNode) return 0;
 
     newNode->data = *p;          /* copia por valor a partir do ponteiro */
+
+    /* Indexa antes de ligar o nó: se faltar memória, nada muda na lista */
+    if (!id_index_insert(&list->id_index, newNode->data.id, &newNode->data)) {
+        slab_pool_free(&list->node_pool, newNode);
+        return 0;
+    }
+    /* Carga em lote: o nome entra depois, em patient_list_build_names */
+    int named = !list->names_deferred;
+    if (named && !name_index_insert(&list->name_index, &newNode->data)) {
+        id_index_remove(&list->id_index, newNode->data.id);
+        slab_pool_free(&list->node_pool, newNode);
+        return 0;
+    }
+    if (!cpf_index_insert_key(&list->cpf_index, cpf_key, &newNode->data)) {
+        if (named) name_index_remove(&list->name_index, &newNode->data);
+        id_index_remove(&list->id_index, newNode->data.id);
+        slab_pool_free(&list->node_pool, newNode);
+        return 0;
+    }
+
     newNode->next = list->head;  /* insere no início (O(1)) */
     list->head    = newNode;
+    list->size++;
 
     return 1;
 }
 
 
+/*
+ Função: reserve_patient_list
+ Responsabilidade:
+   - Preparar a lista para receber muitos pacientes de uma vez (ex.: carga
+     de snapshot), dimensionando o índice de CPF uma única vez em vez de
+     dobrá-lo (rehash) várias vezes durante a carga.
+*/
+int reserve_patient_list(PatientList *list, size_t n) {
+    if (!list) return 0;
+    return cpf_index_reserve(&list->cpf_index, list->size + n);
+}
+
 /*
  Função: search_patient_by_CPF
  Responsabilidade:
@@ -96,45 +150,86 @@ int insert_patient(PatientList *list, const Patient *p) {
    - Retorna NULL se nenhum paciente com o CPF informado for encontrado.
  Lógica:
    1. Verifica argumentos básicos (list e cpf). Se inválidos, retorna NULL.
-   2. Percorre a lista a partir de 'head' até o fim (cur = cur->next).
-   3. Em cada nó, compara o CPF armazenado com o CPF buscado via strcmp().
-   4. Se strcmp() retornar 0 (strings iguais), retorna &cur->data imediatamente.
-   5. Se chegar ao final sem encontrar, retorna NULL.
+   2. Consulta o índice hash de CPF (cpf_index_find), que empacota o CPF
+      num inteiro de 64 bits e compara 8 slots por vez (SIMD).
  Observações:
-   - Complexidade de tempo: O(n), onde n é o número de nós da lista.
-   - Pressupõe que o CPF já foi normalizado no momento da entrada
-     (ex.: sem '\n' e sem espaços nas pontas). A comparação é exata:
-     "111.222.333-44" é diferente de "11122233344".
+   - Complexidade de tempo: O(1) esperado (antes: O(n) percorrendo os nós).
+   - A chave é normalizada (sem pontuação/espaços), então
+     "111.222.333-44" e "11122233344" encontram o MESMO paciente.
 */
 const Patient* search_patient_by_CPF(const PatientList *list, const char *cpf) {
     if (!list || !cpf) return NULL;
-    for (Node *cur = list->head; cur; cur = cur->next) {
-        if (strcmp(cur->data.cpf, cpf) == 0) return &cur->data;
+    return cpf_index_find(&list->cpf_index, cpf);
+}
+
+/*
+ Função: search_patient_by_id
+ Responsabilidade:
+   - Buscar um paciente pelo id (substitui o antigo id_exists, que percorria
+     a lista inteira em O(n)).
+ Retorno:
+   - Ponteiro para os dados do paciente ou NULL se o id não existir.
+ Observações:
+   - Complexidade O(log n): descida na árvore B+ do id_index.
+*/
+const Patient* search_patient_by_id(const PatientList *list, int id) {
+    if (!list) return NULL;
+    return id_index_find(&list->id_index, id);
+}
+
+/*
+ Função: patient_id_range
+ Responsabilidade:
+   - Listar os pacientes com id entre lo e hi (inclusive), em ordem de id,
+     sem percorrer a lista: desce uma vez na árvore e segue pelas folhas.
+*/
+IdCursor patient_id_range(const PatientList *list, int lo, int hi) {
+    return id_index_range(&list->id_index, lo, hi);
+}
+
+/*
+ Função: patient_list_defer_names / patient_list_build_names
+ Responsabilidade:
+   - Tirar a trie de nomes do caminho da carga em lote. Inserir nome a nome
+     custa uma descida na trie (com faltas de cache) por palavra; numa
+     partida a frio de 10^6 pacientes isso dobrava o tempo do snapshot_load.
+ Lógica:
+   - A lista insere no início, então os nós sem nome indexado são sempre
+     os primeiros: da cabeça até names_done (exclusive).
+   - build percorre esse trecho e indexa cada um. Se faltar memória no
+     meio, retira os que acabou de indexar e devolve 0.
+*/
+void patient_list_defer_names(PatientList *list) {
+    if (!list || list->names_deferred) return;
+    list->names_deferred = 1;
+    list->names_done = list->head;
+}
+
+int patient_list_build_names(PatientList *list) {
+    if (!list || !list->names_deferred) return 1;
+    for (Node *n = list->head; n != list->names_done; n = n->next) {
+        if (name_index_insert(&list->name_index, &n->data)) continue;
+        for (Node *m = list->head; m != n; m = m->next)
+            name_index_remove(&list->name_index, &m->data);
+        return 0;
     }
-    return NULL;
+    list->names_deferred = 0;
+    list->names_done = NULL;
+    return 1;
 }
 
-// /*
-//  Função: id_exists  (opcional, auxiliar)
-//  Responsabilidade:
-//    - Verificar se já existe um paciente com o ID informado na lista.
-//  Parâmetros:
-//    - list: Lista onde a verificação será feita.
-//    - id:   Identificador numérico do paciente a verificar.
-//  Retorno:
-//    - Retorna 1 se existir ao menos um nó com 'data.id == id'.
-//    - Retorna 0 se não encontrar nenhum ID igual.
-//  Lógica:
-//    - Percorre a lista do 'head' ao fim comparando 'cur->data.id == id'.
-//    - Se encontrar, retorna 1 imediatamente; senão, ao final retorna 0.
-//    - Complexidade O(n).
-// */
-// static int id_exists(const PatientList *list, int id) {
-//     for (Node *cur = list->head; cur; cur = cur->next) {
-//         if (cur->data.id == id) return 1;
-//     }
-//     return 0;
-// }
+/*
+ Função: patient_name_search
+ Responsabilidade:
+   - Buscar pacientes por parte do nome (recepção digita "jose" ou "silva"),
+     ignorando maiúsculas e acentos, sem percorrer a lista: desce na trie
+     de nomes até o prefixo e devolve a subárvore em ordem alfabética.
+   - Depois de uma carga em lote, indexa antes os nomes pendentes.
+*/
+void patient_name_search(PatientList *list, const char *query, NameCursor *cur) {
+    patient_list_build_names(list);
+    name_index_prefix(&list->name_index, query ? query : "", cur);
+}
 
 
 /*
@@ -144,28 +239,21 @@ const Patient* search_patient_by_CPF(const PatientList *list, const char *cpf) {
      evitando vazamentos de memória (memory leaks).
  Parâmetros:
    - list: A lista a ser "destruída".
- Lógica de Implementação (CRUCIAL):
-   - Percorre a lista, mas com um cuidado especial:
-   1. Um ponteiro 'current' aponta para o nó atual que será liberado.
-   2. ANTES de liberar 'current', é preciso guardar uma referência para o
-      próximo nó, senão perderíamos o resto da lista. Um ponteiro 'temp'
-      guarda 'current'.
-   3. 'current' avança para o próximo nó.
-   4. AGORA sim, com o caminho para o resto da lista salvo, podemos liberar
-      a memória do nó anterior (apontado por 'temp').
+ Lógica de Implementação:
+   - Todos os nós vieram do pool da lista, então não é preciso percorrer
+     os nós um a um: slab_pool_destroy devolve os slabs inteiros de uma vez.
    - Ao final, o 'head' da lista é setado para NULL para indicar que ela está
      vazia e segura para ser usada novamente.
 */
 void free_list(PatientList* list) {
-    Node* current = list->head;
-    Node* temp;
-
-    while (current != NULL) {
-        temp = current;             // 1. Guarda o nó atual para liberar depois
-        current = current->next;    // 2. AVANÇA para o próximo ANTES de apagar o atual
-        free(temp);                 // 3. Libera a memória do nó que ficou para trás
-    }
+    slab_pool_destroy(&list->node_pool); // Libera todos os nós em bloco
     list->head = NULL; // Deixa a lista em um estado limpo e seguro
+    list->size = 0;
+    cpf_index_free(&list->cpf_index); // Índices apontavam para os nós liberados
+    id_index_free(&list->id_index);
+    name_index_free(&list->name_index);
+    list->names_deferred = 0;
+    list->names_done = NULL;
 }
 
 /*
@@ -181,16 +269,36 @@ void free_list(PatientList* list) {
      a. Imprime os dados do paciente no nó atual.
      b. Avança 'current' para o próximo nó da sequência (current = current->next).
 */
-void print_all_patient(PatientList* list) {
-
-    Node* current = list->head; // Ponteiro para percorrer a lista sem perder a referência da cabeça
-    printf("\n=== Lista de Pacientes ===\n");
-    while (current != NULL) {
-        Patient p = current->data;
-        printf("ID: %d | Nome: %s | CPF: %s | Idade: %d | Prioridade: %d\n",
-               p.id, p.name, p.cpf, p.age, p.priority);
-        current = current->next; // Move para o próximo nó
+void print_all_patient(const PatientList* list) {
+    OutBuffer* out = out_stdout();
+    out_str(out, "\n=== Lista de Pacientes ===\n");
+    print_patient_page(list, out, 0, OUT_ALL);
+    out_flush(out); // Um write(2) por buffer cheio, não um printf por paciente
+}
+
+/*
+  Escreve no buffer as linhas [offset, offset + limit) da lista.
+
+  Args:
+    list:   Lista de pacientes.
+    out:    Buffer de saída (o chamador decide quando dar flush).
+    offset: Primeira linha (0-based) a escrever.
+    limit:  Máximo de linhas (OUT_ALL => todas a partir de offset).
+
+  Returns:
+    Número de linhas escritas.
+*/
+size_t print_patient_page(const PatientList* list, OutBuffer* out,
+                          size_t offset, size_t limit) {
+    size_t end = out_page_end(offset, limit);
+    size_t i = 0, written = 0;
+    // Lê o paciente no próprio nó (sem copiar o Patient por valor)
+    for (const Node* current = list->head; current && i < end; current = current->next, i++) {
+        if (i < offset) continue;
+        out_patient_line(out, &current->data);
+        written++;
     }
+    return written;
 }
 
 
@@ -3,7 +3,13 @@
 #ifndef PATIENT_LIST_H
 #define PATIENT_LIST_H
 
+#include <stddef.h>
 #include "../model/patient.h"
+#include "cpf_index.h"
+#include "id_index.h"
+#include "name_index.h"
+#include "util/slab_pool.h"
+#include "util/out_buffer.h"
 
 // Estrutura do "nó" ou "elo" da lista.
 // Cada nó contém os dados de um paciente e um ponteiro para o próximo nó.
@@ -13,9 +19,18 @@ typedef struct node {
 } Node;
 
 // Estrutura principal da lista.
-// Contém apenas um ponteiro para o primeiro nó (a "cabeça" da lista).
+// Contém o ponteiro para o primeiro nó (a "cabeça" da lista), o índice
+// hash de CPF, o índice ordenado de id e o índice de nomes, mantidos em
+// sincronia a cada inserção.
 typedef struct {
     Node* head;            // Ponteiro para o nó inicial da lista.
+    size_t size;           // Número de pacientes cadastrados.
+    CpfIndex cpf_index;    // CPF compacto (64 bits) -> &node->data (busca O(1) esperado).
+    IdIndex id_index;      // id -> &node->data em ordem (busca O(log n), faixas).
+    NameIndex name_index;  // nome dobrado (e cada palavra) -> &node->data (prefixo).
+    int names_deferred;    // carga em lote: name_index ainda sem os nós novos
+    Node* names_done;      // com names_deferred: primeiro nó já no name_index
+    SlabPool node_pool;    // Pool de onde saem os nós (liberado em bloco).
 } PatientList;
 
 
@@ -27,12 +42,52 @@ void init_patient_list(PatientList* list);
 /* Insere um novo paciente no início da lista. */
 int insert_patient(PatientList *list, const Patient *p);
 
+/* Pré-dimensiona o índice de CPF para n pacientes (carga em lote).
+   Returns: 1 em sucesso, 0 se faltar memória. */
+int reserve_patient_list(PatientList *list, size_t n);
+
+/* Carga em lote (snapshot): os próximos insert_patient não passam pelo
+   índice de nomes; patient_list_build_names (ou a primeira busca por nome)
+   indexa todos de uma vez. Mantém a partida a frio longe da trie. */
+void patient_list_defer_names(PatientList *list);
+
+/* Indexa os nomes pendentes de patient_list_defer_names (nada a fazer se
+   não há). Quem compartilha a lista entre threads chama antes: a busca por
+   nome também completaria o índice, e isso é escrita.
+   Returns: 1 ok, 0 sem memória (o índice fica como estava). */
+int patient_list_build_names(PatientList *list);
+
 /* Exibe todos os pacientes da lista no console. */
-void print_all_patient(PatientList* list);
+void print_all_patient(const PatientList* list);
+
+/* Modo página: acumula em out só as linhas [offset, offset + limit)
+   (limit = OUT_ALL => até o fim), sem cabeçalho e sem flush.
+   Returns: quantas linhas foram escritas. */
+size_t print_patient_page(const PatientList* list, OutBuffer* out,
+                          size_t offset, size_t limit);
 
 /* Busca por CPF; retorna ponteiro constante para o Patient na lista, ou NULL.*/
 const Patient* search_patient_by_CPF(const PatientList *list, const char *cpf);
 
+/* Busca por id (O(log n)); retorna ponteiro constante ou NULL. */
+const Patient* search_patient_by_id(const PatientList *list, int id);
+
+/* Cursor sobre os pacientes com id em [lo, hi], em ordem crescente:
+       IdCursor c = patient_id_range(list, lo, hi);
+       for (const Patient* p; (p = id_cursor_next(&c));) ... */
+IdCursor patient_id_range(const PatientList *list, int lo, int hi);
+
+/* Busca por prefixo de nome, sem diferenciar maiúsculas nem acentos; casa
+   com o início de qualquer palavra do nome. Resultados em ordem alfabética,
+   um a um (a primeira página não depende do tamanho do cadastro):
+       NameCursor c;
+       patient_name_search(list, "jose sil", &c);
+       for (const Patient* p; (p = name_cursor_next(&c));) ...
+   Depois de uma carga em lote, a primeira busca indexa os nomes pendentes
+   (patient_list_build_names); sem memória para isso, busca só nos que já
+   estavam indexados. */
+void patient_name_search(PatientList *list, const char *query, NameCursor *cur);
+
 /* Libera toda a memória alocada pelos nós da lista, evitando memory leaks. */
 void free_list(PatientList* list);
 
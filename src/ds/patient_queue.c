@@ -2,77 +2,535 @@
 #include <stdlib.h>
 #include <string.h>
 #include "patient_queue.h"
+#include "model/cpf.h"
+#include "util/patient_io.h"
+
+/*
+ Fila de atendimento com "baldes" de prioridade.
+
+ Antes: uma única lista ordenada; cada enqueue percorria os nós até achar a
+ posição (O(n)), lendo QueueNode->patient->priority a cada passo.
+ Agora: uma FIFO por nível + bitmask de ocupação. O nível mais prioritário
+ não vazio é o bit menos significativo ligado, obtido por tabela (3 bits).
+ A ordem FIFO dentro de cada nível é preservada.
+
+ Memória: os nós vêm de um pool (slab_pool) da própria fila; free_queue
+ devolve tudo em bloco. O nó guarda só um handle para o Patient do
+ cadastro (zero-cópia): enfileirar não copia os ~330 bytes do paciente e
+ atender não devolve nada. O nível fica no próprio nó, então percorrer a
+ fila não toca nos dados do cadastro.
+
+ Tempo de espera: cada nó leva o instante de chegada (relógio monotônico);
+ dequeue mede agora - chegada e soma 1 no histograma log-linear do nível
+ (latency_hist: um contador fixo por balde, sem alocação). O desfazer
+ devolve o paciente com a chegada original (enqueue_front_at), então o
+ envelhecimento continua contando a espera dele; a amostra do atendimento
+ desfeito fica no histograma. Depois de um restart a chegada original não
+ existe mais (o relógio é do processo): snapshot e WAL reaplicam o
+ histórico com chegada desconhecida e o desfazer usa a chegada agora.
+
+ Envelhecimento (opcional): dentro de um nível a fila é FIFO, então o
+ primeiro de cada nível é quem espera há mais tempo ali. dequeue só olha
+ esses QUEUE_LEVELS candidatos: se algum passou do limite do seu nível, sai
+ o de prazo (chegada + limite) mais antigo; senão, a ordem estrita.
+
+ Desistência e posição:
+   - os níveis são duplamente encadeados, então um nó sai do meio em O(1);
+   - um mapa CPF compacto -> nó (endereçamento aberto, remoção por
+     deslocamento, sem lápides) acha o nó sem percorrer a fila;
+   - cada nível numera seus nós com "slots" crescentes na ordem FIFO
+     (enqueue_front usa o slot antes do primeiro). Posição no nível = slots
+     entre o início e o nó, menos as desistências nesse intervalo, contadas por
+     uma árvore de Fenwick que só muda na desistência: O(log n), e
+     enqueue/dequeue continuam O(1) sem tocar na árvore. Quando os slots
+     de uma ponta acabam, os vivos são renumerados em O(n) — amortizado
+     O(1), pois sobra folga de pelo menos metade dos vivos em cada ponta.
+*/
+
+// Índice do menor bit ligado para máscaras de 3 bits (-1 se nenhum)
+static const signed char lowest_level[1u << QUEUE_LEVELS] = {
+    -1, 0, 1, 0, 2, 0, 1, 0
+};
+
+// Converte a prioridade (1..3) em índice de nível; valores fora da faixa
+// vão para o extremo mais próximo em vez de corromper a fila.
+int queue_level_of(const Patient *p) {
+    if (p->priority < 1) return 0;
+    if (p->priority > QUEUE_LEVELS) return QUEUE_LEVELS - 1;
+    return p->priority - 1;
+}
 
 // Inicializa a fila
 void init_queue(PatientQueue *q) {
-    q->front = q->rear = NULL;
+    for (int i = 0; i < QUEUE_LEVELS; i++)
+        q->front[i] = q->rear[i] = NULL;
+    q->occupancy = 0;
+    q->size = 0;
+    for (int i = 0; i < QUEUE_LEVELS; i++) {
+        q->count[i] = 0;
+        q->rank[i].tree = NULL;
+        q->rank[i].cap = q->rank[i].hi = 0;
+        q->rank[i].cancelled = 0;
+    }
+    q->handles = NULL;
+    q->handle_cap = q->handle_count = 0;
+    slab_pool_init(&q->node_pool, sizeof(QueueNode));
+    q->clock = latency_now_ns;
+    queue_set_aging(q, NULL);
+    queue_stats_reset(q);
 }
 
-// Adiciona paciente na fila (FIFO, cópia independente)
-void enqueue(PatientQueue *q, Patient *p) {
-    printf("\nDEBUG: EXECUTANDO A FUNCAO ENQUEUE COM LOGICA DE PRIORIDADE PARA: '%s'\n", p->name);
-    QueueNode *newNode = malloc(sizeof(QueueNode));
-    if (!newNode) {
-        puts("Erro: Falha ao alocar memória para o novo nó da fila.");
-        return;
+void queue_set_aging(PatientQueue *q, const uint64_t max_wait_ns[QUEUE_LEVELS]) {
+    q->aging.mask = 0;
+    for (int i = 0; i < QUEUE_LEVELS; i++) {
+        q->aging.max_wait_ns[i] = max_wait_ns ? max_wait_ns[i] : 0;
+        if (q->aging.max_wait_ns[i]) q->aging.mask |= 1u << i;
     }
-    newNode->patient = p;
-    newNode->next = NULL;
+}
+
+void queue_stats_reset(PatientQueue *q) {
+    QueueStats *st = &q->stats;
+    for (int i = 0; i < QUEUE_LEVELS; i++) {
+        latency_hist_reset(&st->wait[i]);
+        st->arrivals[i] = st->cancels[i] = st->promoted[i] = 0;
+    }
+    st->since_ns = q->clock();
+}
+
+/* ---------- contador de ordem (Fenwick) ---------- */
+
+// Marca (+1) ou desmarca (-1) um slot desistente
+static void rank_add(QueueRank *r, size_t slot, int delta) {
+    for (size_t i = slot + 1; i <= r->cap; i += i & (0 - i))
+        r->tree[i] += (uint32_t)delta;
+}
+
+// Desistências com slot <= slot
+static size_t rank_prefix(const QueueRank *r, size_t slot) {
+    size_t sum = 0;
+    for (size_t i = slot + 1; i > 0; i -= i & (0 - i))
+        sum += r->tree[i];
+    return sum;
+}
+
+// Renumera os nós vivos do nível a partir de cap/4; as desistências
+// antigas somem junto com os slots velhos. Retorna 0 se faltar memória
+// (nível intacto).
+static int rank_rebuild(PatientQueue *q, int lv) {
+    QueueRank *r = &q->rank[lv];
+    size_t live = q->count[lv];
+    size_t cap = 64;
+    while (cap < 2 * (live + 1)) cap *= 2;
+    uint32_t *tree = calloc(cap + 1, sizeof *tree);
+    if (!tree) return 0;
+
+    size_t slot = cap / 4;
+    for (QueueNode *n = q->front[lv]; n; n = n->next) n->slot = (uint32_t)slot++;
+    r->hi = slot;
+    free(r->tree);
+    r->tree = tree;
+    r->cap = cap;
+    r->cancelled = 0;
+    return 1;
+}
+
+// Reserva o slot do novo nó no fim (back=1) ou no início do nível.
+// No fim o slot é sempre novo; no início é o anterior ao do primeiro nó,
+// que pode ter ficado marcado por uma desistência (a marca sai).
+// Retorna 0 se faltar memória.
+static int rank_reserve(PatientQueue *q, int lv, int back, size_t *slot) {
+    QueueRank *r = &q->rank[lv];
+    if (q->count[lv] == 0) back = 1; // nível vazio: início == fim
+    if (back ? r->hi >= r->cap : q->front[lv]->slot == 0)
+        if (!rank_rebuild(q, lv)) return 0;
+    if (back) {
+        *slot = r->hi++;
+        return 1;
+    }
+    *slot = q->front[lv]->slot - 1;
+    if (r->cancelled && rank_prefix(r, *slot) - (*slot ? rank_prefix(r, *slot - 1) : 0)) {
+        rank_add(r, *slot, -1);
+        r->cancelled--;
+    }
+    return 1;
+}
+
+// Posição do nó dentro do nível (1 = início): slots entre o início e ele,
+// menos as desistências no meio do caminho.
+static size_t rank_of(const PatientQueue *q, int lv, const QueueNode *node) {
+    const QueueRank *r = &q->rank[lv];
+    size_t first = q->front[lv]->slot;
+    size_t pos = node->slot - first + 1;
+    if (r->cancelled) pos -= rank_prefix(r, node->slot) - rank_prefix(r, first);
+    return pos;
+}
 
-    // --- LÓGICA DE PRIORIDADE CORRIGIDA ---
+/* ---------- mapa CPF -> nó ---------- */
 
-    // Caso 1: A fila está vazia OU o novo paciente tem a maior prioridade e deve ser o novo 'front'.
-    if (is_queue_empty(q) || p->priority < q->front->patient->priority) {
-        newNode->next = q->front;
-        q->front = newNode;
+static size_t handle_home(const PatientQueue *q, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 20) & (q->handle_cap - 1);
+}
+
+// Slot com a chave ou o slot vazio onde ela entraria (mapa não vazio)
+static size_t handle_slot(const PatientQueue *q, uint64_t key) {
+    size_t i = handle_home(q, key);
+    while (q->handles[i].key && q->handles[i].key != key)
+        i = (i + 1) & (q->handle_cap - 1);
+    return i;
+}
+
+// Garante espaço para mais um CPF (carga <= 3/4). Retorna 0 se faltar memória.
+static int handle_reserve(PatientQueue *q) {
+    if ((q->handle_count + 1) * 4 <= q->handle_cap * 3) return 1;
+    size_t old_cap = q->handle_cap;
+    QueueHandle *old = q->handles;
+    size_t cap = old_cap ? old_cap * 2 : 64;
+    QueueHandle *handles = calloc(cap, sizeof *handles);
+    if (!handles) return 0;
+    q->handles = handles;
+    q->handle_cap = cap;
+    for (size_t i = 0; i < old_cap; i++)
+        if (old[i].key) q->handles[handle_slot(q, old[i].key)] = old[i];
+    free(old);
+    return 1;
+}
+
+// Coloca o nó no mapa (espaço já reservado por handle_reserve)
+static void handle_link(PatientQueue *q, QueueNode *node) {
+    node->same_prev = node->same_next = NULL;
+    if (!node->cpf_key) return;
+    QueueHandle *h = &q->handles[handle_slot(q, node->cpf_key)];
+    if (h->key) { // CPF já na fila: entra na corrente daquele CPF
+        node->same_next = h->node;
+        h->node->same_prev = node;
     } else {
-        // Caso 2: Percorre a fila para encontrar a posição correta.
-        QueueNode *current = q->front;
-        // # O loop agora avança 'current' até encontrar o nó ANTES do qual devemos inserir.
-        while (current->next != NULL && current->next->patient->priority <= p->priority) {
-            current = current->next;
-        }
-        // Insere o novo nó depois de 'current'.
-        newNode->next = current->next;
-        current->next = newNode;
+        h->key = node->cpf_key;
+        q->handle_count++;
     }
+    h->node = node;
+}
 
-    // --- GERENCIAMENTO DO PONTEIRO 'rear' ---
-    // # A lógica para atualizar o 'rear'.
-    // Se o 'rear' original era o nó onde inserimos depois, ou se o novo nó é o último, atualizamos 'rear'.
-    if (newNode->next == NULL) {
-        q->rear = newNode;
+static void handle_unlink(PatientQueue *q, QueueNode *node) {
+    if (!node->cpf_key) return;
+    if (node->same_prev) {
+        node->same_prev->same_next = node->same_next;
+        if (node->same_next) node->same_next->same_prev = node->same_prev;
+        return;
     }
-    // Se a fila estava vazia, o 'rear' precisa ser inicializado.
-    if (is_queue_empty(q)) {
-        q->rear = q->front;
+    size_t i = handle_slot(q, node->cpf_key);
+    if (node->same_next) {
+        node->same_next->same_prev = NULL;
+        q->handles[i].node = node->same_next;
+        return;
+    }
+    // Último nó do CPF: apaga o slot puxando para trás quem sondou por ele
+    size_t mask = q->handle_cap - 1;
+    for (size_t j = (i + 1) & mask; q->handles[j].key; j = (j + 1) & mask) {
+        size_t home = handle_home(q, q->handles[j].key);
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            q->handles[i] = q->handles[j];
+            i = j;
+        }
     }
+    q->handles[i].key = 0;
+    q->handles[i].node = NULL;
+    q->handle_count--;
 }
 
-// Remove paciente da fila e retorna ponteiro (lembre-se de liberar depois)
-Patient* dequeue(PatientQueue *q) {
-    if (q->front == NULL) return NULL;
+/* ---------- nós ---------- */
 
-    QueueNode *temp = q->front;
-    Patient *p = temp->patient;
+// Aloca o nó no pool (NULL se faltar memória)
+static QueueNode* new_node(PatientQueue *q, const Patient *p) {
+    QueueNode *newNode = slab_pool_alloc(&q->node_pool);
+    if (!newNode) return NULL;
+    newNode->patient = p;
+    newNode->level = (unsigned char)queue_level_of(p);
+    newNode->next = newNode->prev = NULL;
+    newNode->enqueued_ns = q->clock();
+    if (!cpf_pack_key(p->cpf, &newNode->cpf_key)) newNode->cpf_key = 0;
+    return newNode;
+}
 
-    q->front = q->front->next;
-    if (q->front == NULL) q->rear = NULL;
+// Reserva mapa e slot para o nó novo; em falta de memória descarta o nó.
+static int prepare_node(PatientQueue *q, QueueNode *node, int lv, int back) {
+    size_t slot;
+    if ((node->cpf_key && !handle_reserve(q)) || !rank_reserve(q, lv, back, &slot)) {
+        slab_pool_free(&q->node_pool, node);
+        return 0;
+    }
+    node->slot = (uint32_t)slot;
+    return 1;
+}
 
-    free(temp);
+// Contabiliza o nó já encadeado no nível lv
+static void account_node(PatientQueue *q, QueueNode *node, int lv) {
+    handle_link(q, node);
+    q->count[lv]++;
+    q->occupancy |= 1u << lv;
+    q->size++;
+}
+
+// Tira o nó do nível (início, meio ou fim) e de todos os índices, em O(1)
+// (+ O(log n) da árvore se saiu do meio). O nó volta ao pool.
+static const Patient* unlink_node(PatientQueue *q, QueueNode *node) {
+    int lv = node->level;
+    if (node->prev) { // não era o primeiro: o slot vira buraco marcado
+        rank_add(&q->rank[lv], node->slot, 1);
+        q->rank[lv].cancelled++;
+    }
+    if (node->prev) node->prev->next = node->next;
+    else            q->front[lv] = node->next;
+    if (node->next) node->next->prev = node->prev;
+    else            q->rear[lv] = node->prev;
+    if (!q->front[lv]) q->occupancy &= ~(1u << lv); // nível esvaziou
+
+    handle_unlink(q, node);
+    q->count[lv]--;
+    q->size--;
+
+    const Patient *p = node->patient;
+    slab_pool_free(&q->node_pool, node);
     return p;
 }
 
+// Adiciona o paciente no fim do seu nível (O(1))
+int enqueue(PatientQueue *q, const Patient *p) {
+    QueueNode *newNode = new_node(q, p);
+    if (!newNode) return 0;
+
+    int lv = newNode->level;
+    if (!prepare_node(q, newNode, lv, 1)) return 0;
+    newNode->prev = q->rear[lv];
+    if (q->rear[lv]) q->rear[lv]->next = newNode;
+    else             q->front[lv] = newNode;
+    q->rear[lv] = newNode;
+
+    account_node(q, newNode, lv);
+    q->stats.arrivals[lv]++;
+    return 1;
+}
+
+// Adiciona o paciente no início do seu nível (O(1), sem percorrer).
+// Como dequeue só remove do início, devolver ali o último atendido
+// restaura exatamente a ordem anterior ao atendimento.
+int enqueue_front(PatientQueue *q, const Patient *p) {
+    return enqueue_front_at(q, p, 0);
+}
+
+int enqueue_front_at(PatientQueue *q, const Patient *p, uint64_t enqueued_ns) {
+    QueueNode *newNode = new_node(q, p);
+    if (!newNode) return 0;
+    if (enqueued_ns) newNode->enqueued_ns = enqueued_ns;
+
+    int lv = newNode->level;
+    if (!prepare_node(q, newNode, lv, 0)) return 0;
+    newNode->next = q->front[lv];
+    if (q->front[lv]) q->front[lv]->prev = newNode;
+    else              q->rear[lv] = newNode;
+    q->front[lv] = newNode;
+
+    account_node(q, newNode, lv);
+    return 1;
+}
+
+// Nível a atender com envelhecimento: o primeiro atrasado (prazo mais
+// antigo) entre os níveis com limite; lv (o estrito) se ninguém passou.
+static int aged_level(const PatientQueue *q, int lv, uint64_t now) {
+    int best = lv;
+    uint64_t best_deadline = UINT64_MAX;
+    unsigned candidates = q->aging.mask & q->occupancy;
+    for (int i = lv; i < QUEUE_LEVELS; i++) {
+        if (!(candidates & (1u << i))) continue;
+        uint64_t deadline = q->front[i]->enqueued_ns + q->aging.max_wait_ns[i];
+        if (deadline <= now && deadline < best_deadline) {
+            best = i;
+            best_deadline = deadline;
+        }
+    }
+    return best;
+}
+
+// Tira o primeiro do nível lv, registrando a espera
+static const Patient* serve_level(PatientQueue *q, int lv, uint64_t now, uint64_t *enqueued_ns) {
+    QueueNode *node = q->front[lv];
+    if (enqueued_ns) *enqueued_ns = node->enqueued_ns;
+    latency_hist_record(&q->stats.wait[lv], now > node->enqueued_ns ? now - node->enqueued_ns : 0);
+    if (q->occupancy & ((1u << lv) - 1)) q->stats.promoted[lv]++; // havia nível acima
+    return unlink_node(q, node);
+}
+
+// Remove paciente da fila e retorna o handle do cadastro
+const Patient* dequeue(PatientQueue *q) {
+    return dequeue_timed(q, NULL);
+}
+
+const QueueNode* queue_peek(const PatientQueue *q, uint64_t now) {
+    int lv = lowest_level[q->occupancy];
+    if (lv < 0) return NULL;
+    // Só há o que decidir se algum nível abaixo tem limite e gente esperando
+    if (q->aging.mask & q->occupancy & ~((2u << lv) - 1)) lv = aged_level(q, lv, now);
+    return q->front[lv];
+}
+
+const Patient* dequeue_timed(PatientQueue *q, uint64_t *enqueued_ns) {
+    uint64_t now = q->clock();
+    const QueueNode *node = queue_peek(q, now);
+    if (!node) return NULL;
+    return serve_level(q, node->level, now, enqueued_ns);
+}
+
+const Patient* dequeue_level(PatientQueue *q, int level) {
+    if (level < 0 || level >= QUEUE_LEVELS || !q->front[level]) return NULL;
+    return serve_level(q, level, q->clock(), NULL);
+}
+
 // Verifica se a fila está vazia
 int is_queue_empty(const PatientQueue *q) {
-    return q->front == NULL;
+    return q->occupancy == 0;
 }
 
-// Libera toda a fila (útil ao encerrar)
-void free_queue(PatientQueue *q) {
-    while (!is_queue_empty(q)) {
-        Patient *p = dequeue(q);
-        free(p); // libera cada paciente copiado
+// Com o mesmo CPF mais de uma vez na fila, vale a entrada atendida primeiro
+static int served_before(const QueueNode *a, const QueueNode *b) {
+    return a->level != b->level ? a->level < b->level : a->slot < b->slot;
+}
+
+const QueueNode* queue_find_cpf(const PatientQueue *q, const char *cpf) {
+    uint64_t key;
+    if (!q->handle_count || !cpf_pack_key(cpf, &key)) return NULL;
+    const QueueHandle *h = &q->handles[handle_slot(q, key)];
+    if (!h->key) return NULL;
+    const QueueNode *best = h->node;
+    for (const QueueNode *n = best->same_next; n; n = n->same_next)
+        if (served_before(n, best)) best = n;
+    return best;
+}
+
+const Patient* queue_remove_cpf(PatientQueue *q, const char *cpf) {
+    QueueNode *node = (QueueNode *)queue_find_cpf(q, cpf);
+    if (!node) return NULL;
+    q->stats.cancels[node->level]++;
+    return unlink_node(q, node);
+}
+
+size_t queue_position_of(const PatientQueue *q, const QueueNode *node) {
+    int lv = node->level;
+    size_t ahead = 0;
+    for (int i = 0; i < lv; i++) ahead += q->count[i];
+    return ahead + rank_of(q, lv, node);
+}
+
+size_t queue_position(const PatientQueue *q, const char *cpf) {
+    const QueueNode *node = queue_find_cpf(q, cpf);
+    return node ? queue_position_of(q, node) : 0;
+}
+
+const QueueNode* queue_first(const PatientQueue *q) {
+    int lv = lowest_level[q->occupancy];
+    return lv < 0 ? NULL : q->front[lv];
+}
+
+const QueueNode* queue_next(const PatientQueue *q, const QueueNode *node) {
+    if (!node) return NULL;
+    if (node->next) return node->next;
+    // Fim do nível: salta para o próximo nível não vazio
+    for (int lv = node->level + 1; lv < QUEUE_LEVELS; lv++)
+        if (q->front[lv]) return q->front[lv];
+    return NULL;
+}
+
+size_t print_queue_page(const PatientQueue *q, OutBuffer *out, size_t offset, size_t limit) {
+    size_t end = out_page_end(offset, limit);
+    size_t i = 0, written = 0;
+    for (const QueueNode *node = queue_first(q); node && i < end; node = queue_next(q, node), i++) {
+        if (i < offset) continue;
+        out_u64(out, (uint64_t)i + 1); // posição na fila
+        out_str(out, ") ");
+        out_patient_line(out, node->patient);
+        written++;
+    }
+    return written;
+}
+
+// Décimos como "N.d"
+static void out_tenths(OutBuffer *out, uint64_t tenths) {
+    out_u64(out, tenths / 10);
+    out_char(out, '.');
+    out_char(out, (char)('0' + tenths % 10));
+}
+
+// Duração com uma casa na maior unidade que cabe (min, s, ms, µs)
+static void out_duration(OutBuffer *out, uint64_t ns) {
+    static const struct { uint64_t ns; const char *name; } units[] = {
+        { 60000000000ull, " min" }, { 1000000000ull, " s" }, { 1000000ull, " ms" }, { 1000ull, " µs" }
+    };
+    size_t u = 0;
+    while (u + 1 < sizeof units / sizeof units[0] && ns < units[u].ns) u++;
+    out_tenths(out, ns / (units[u].ns / 10));
+    out_str(out, units[u].name);
+}
+
+// Eventos por minuto na janela, com uma casa
+static void out_rate(OutBuffer *out, uint64_t events, uint64_t window_ns) {
+    double per_min = window_ns ? (double)events * 60e9 / (double)window_ns : 0.0;
+    out_tenths(out, (uint64_t)(per_min * 10.0 + 0.5));
+    out_str(out, "/min");
+}
+
+size_t print_queue_stats(const PatientQueue *q, OutBuffer *out) {
+    const QueueStats *st = &q->stats;
+    uint64_t now = q->clock();
+    uint64_t window = now > st->since_ns ? now - st->since_ns : 0;
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        const LatencyHist *h = &st->wait[lv];
+        out_str(out, "Prioridade ");
+        out_int(out, lv + 1);
+        out_str(out, ": chegadas ");
+        out_u64(out, st->arrivals[lv]);
+        out_str(out, " (");
+        out_rate(out, st->arrivals[lv], window);
+        out_str(out, ") | atendidos ");
+        out_u64(out, h->total);
+        out_str(out, " (");
+        out_rate(out, h->total, window);
+        out_str(out, ") | desistências ");
+        out_u64(out, st->cancels[lv]);
+        if (q->aging.mask) {
+            out_str(out, " | promovidos ");
+            out_u64(out, st->promoted[lv]);
+        }
+        out_str(out, " | na fila ");
+        out_u64(out, q->count[lv]);
+        if (!h->total) { // ninguém atendido ainda: sem percentis
+            out_str(out, " | espera -\n");
+            continue;
+        }
+        out_str(out, " | espera p50 ");
+        out_duration(out, latency_hist_percentile(h, 0.50));
+        out_str(out, ", p90 ");
+        out_duration(out, latency_hist_percentile(h, 0.90));
+        out_str(out, ", p99 ");
+        out_duration(out, latency_hist_percentile(h, 0.99));
+        out_str(out, ", máx ");
+        out_duration(out, h->max);
+        out_char(out, '\n');
     }
+    return QUEUE_LEVELS;
 }
 
+// Libera toda a fila (útil ao encerrar): os nós saem em bloco
+void free_queue(PatientQueue *q) {
+    slab_pool_destroy(&q->node_pool);
+    for (int i = 0; i < QUEUE_LEVELS; i++) {
+        q->front[i] = q->rear[i] = NULL;
+        free(q->rank[i].tree);
+        q->rank[i].tree = NULL;
+        q->rank[i].cap = q->rank[i].hi = 0;
+        q->rank[i].cancelled = 0;
+        q->count[i] = 0;
+    }
+    free(q->handles);
+    q->handles = NULL;
+    q->handle_cap = q->handle_count = 0;
+    q->occupancy = 0;
+    q->size = 0;
+}
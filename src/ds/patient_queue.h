@@ -2,20 +2,89 @@
 #define PATIENT_QUEUE_H
 
 #include "../model/patient.h"
+#include "util/slab_pool.h"
+#include "util/out_buffer.h"
+#include "util/latency_hist.h"
 #include <stdlib.h> // Para NULL
+#include <stdint.h> // uint64_t
+
+// Número de níveis de prioridade (1=Alta, 2=Média, 3=Baixa; ver patient_validate)
+#define QUEUE_LEVELS 3
 
 // Estrutura do Nó da Fila (QueueNode)
-// Cada "caixinha" da fila que guarda um paciente.
+// Cada "caixinha" da fila aponta para um paciente do CADASTRO (handle, como
+// no HistoryRecord): nada é copiado ao enfileirar. Os Patient vivem nos nós
+// da PatientList, com endereço estável até free_list.
 typedef struct QueueNode {
-    Patient *patient;           // Ponteiro para os dados do paciente (a cópia alocada)
+    const Patient *patient;     // Handle para o paciente no cadastro
     struct QueueNode *next;     // Ponteiro para o próximo nó na fila
+    struct QueueNode *prev;     // Anterior no nível (remoção do meio em O(1))
+    struct QueueNode *same_next; // Outras entradas com o mesmo CPF (raro:
+    struct QueueNode *same_prev; // ex. desfazer com o paciente já de volta)
+    uint64_t cpf_key;           // CPF compacto (0 => fora do mapa de CPF)
+    uint64_t enqueued_ns;       // Chegada na fila (relógio monotônico)
+    uint32_t slot;              // Posição no contador de ordem do nível
+    unsigned char level;        // Nível (prioridade - 1) ao entrar na fila
 } QueueNode;
 
+// Mapa CPF -> nó (endereçamento aberto, remoção sem lápide)
+typedef struct {
+    uint64_t key;               // 0 => slot vazio
+    QueueNode *node;            // uma das entradas daquele CPF
+} QueueHandle;
+
+// Contador de ordem de um nível: cada nó ocupa um slot crescente na ordem
+// FIFO; a posição no nível é a distância de slots até o início menos as
+// desistências no caminho (árvore de Fenwick), em O(log n).
+typedef struct {
+    uint32_t *tree;             // Fenwick 1-based: 1 por slot desistente
+    size_t cap;                 // slots disponíveis (potência de 2)
+    size_t hi;                  // próximo slot livre no fim
+    size_t cancelled;           // marcas na árvore (0 => nem consulta)
+} QueueRank;
+
+// Estatísticas de espera por nível, desde init_queue/queue_stats_reset.
+// Tudo em vetores fixos: registrar não aloca.
+typedef struct {
+    LatencyHist wait[QUEUE_LEVELS];  // chegada -> atendimento (dequeue)
+    uint64_t arrivals[QUEUE_LEVELS]; // enqueue (o retorno do desfazer não conta)
+    uint64_t cancels[QUEUE_LEVELS];  // desistências (queue_remove_cpf)
+    uint64_t promoted[QUEUE_LEVELS]; // atendidos na frente de um nível acima (envelhecimento)
+    uint64_t since_ns;               // início da janela
+} QueueStats;
+
+// Política de envelhecimento (anti-inanição). Sem limites (mask == 0) a
+// ordem é estritamente por prioridade. Com limite no nível, quem está no
+// início dele e já esperou mais que max_wait_ns passa na frente dos níveis
+// acima; entre vários atrasados vence o prazo (chegada + limite) mais antigo.
+// Como cada nível é FIFO, só os primeiros de cada nível são candidatos:
+// escolher o próximo continua O(QUEUE_LEVELS).
+typedef struct {
+    uint64_t max_wait_ns[QUEUE_LEVELS]; // 0 => nível sem limite
+    unsigned mask;                      // bit (nivel - 1) => nível com limite
+} QueueAging;
+
+// Relógio da fila em ns (padrão: latency_now_ns; simulações usam um virtual)
+typedef uint64_t (*QueueClock)(void);
+
 // Estrutura principal da Fila (PatientQueue)
-// Controla o início e o fim da fila.
+// Uma FIFO por nível de prioridade + máscara de ocupação:
+// o bit (nivel - 1) fica ligado enquanto aquele nível tiver alguém esperando.
+// Assim enqueue e dequeue são O(1), sem percorrer a fila.
 typedef struct {
-    QueueNode *front; // Ponteiro para o primeiro paciente da fila
-    QueueNode *rear;  // Ponteiro para o último paciente da fila
+    QueueNode *front[QUEUE_LEVELS]; // Primeiro paciente de cada nível
+    QueueNode *rear[QUEUE_LEVELS];  // Último paciente de cada nível
+    unsigned occupancy;             // Bitmask de níveis não vazios
+    size_t size;                    // Total de pacientes na fila
+    size_t count[QUEUE_LEVELS];     // Pacientes em cada nível
+    QueueRank rank[QUEUE_LEVELS];   // Ordem dentro de cada nível
+    QueueHandle *handles;           // Mapa CPF -> nó
+    size_t handle_cap;              // Slots do mapa (potência de 2 ou 0)
+    size_t handle_count;            // CPFs distintos no mapa
+    SlabPool node_pool;             // Pool dos QueueNode
+    QueueStats stats;               // Tempos de espera e chegadas/saídas
+    QueueAging aging;               // Política de escolha do próximo
+    QueueClock clock;               // Fonte de tempo (chegada, espera, prazos)
 } PatientQueue;
 
 // --- Protótipos das Funções ---
@@ -23,16 +92,85 @@ typedef struct {
 // Inicializa uma fila vazia
 void init_queue(PatientQueue *q);
 
+// Liga o envelhecimento com um limite de espera por nível (ns; 0 = sem
+// limite) ou volta à ordem estrita com max_wait_ns == NULL.
+void queue_set_aging(PatientQueue *q, const uint64_t max_wait_ns[QUEUE_LEVELS]);
+
+// Nível (0 = prioridade 1) em que o paciente entra na fila
+int queue_level_of(const Patient *p);
+
 // Verifica se a fila está vazia
 int is_queue_empty(const PatientQueue *q);
 
-// Adiciona um paciente ao FIM da fila
-void enqueue(PatientQueue *q, Patient *p);
+// Adiciona o paciente (handle do cadastro, não copiado) ao FIM do seu nível
+// de prioridade. p precisa continuar válido enquanto estiver na fila.
+// Retorna 1 em sucesso, 0 se faltar memória.
+int enqueue(PatientQueue *q, const Patient *p);
+
+// Adiciona o paciente no INÍCIO do seu nível de prioridade (O(1)).
+// Usado pelo "desfazer atendimento": o paciente volta a ser o próximo do nível.
+// Retorna 1 em sucesso, 0 se faltar memória.
+int enqueue_front(PatientQueue *q, const Patient *p);
+
+// Como enqueue_front, mas com a chegada original (enqueued_ns de
+// dequeue_timed): quem volta pelo "desfazer" não perde o tempo já esperado
+// para o envelhecimento. enqueued_ns == 0 => chegada agora.
+int enqueue_front_at(PatientQueue *q, const Patient *p, uint64_t enqueued_ns);
+
+// Remove o próximo paciente e retorna o handle do cadastro (NULL se vazia).
+// Ordem estrita: o mais antigo do nível mais prioritário; com
+// envelhecimento, um atrasado de nível abaixo pode vir antes (QueueAging).
+const Patient* dequeue(PatientQueue *q);
+
+// Como dequeue; enqueued_ns (opcional) recebe a chegada do atendido.
+const Patient* dequeue_timed(PatientQueue *q, uint64_t *enqueued_ns);
+
+// Nó que dequeue atenderia no instante now (com envelhecimento), sem
+// remover; NULL se a fila estiver vazia. O(QUEUE_LEVELS).
+const QueueNode* queue_peek(const PatientQueue *q, uint64_t now);
+
+// Remove o primeiro do nível dado (NULL se o nível estiver vazio). Usado no
+// replay do WAL para repetir a escolha feita com o relógio da época.
+const Patient* dequeue_level(PatientQueue *q, int level);
+
+// Entrada do CPF na fila (a que seria atendida primeiro), ou NULL.
+// Mapa de CPF: O(1), sem percorrer a fila.
+const QueueNode* queue_find_cpf(const PatientQueue *q, const char *cpf);
+
+// Tira da fila o paciente com esse CPF (desistência), em O(1) + O(log n)
+// para o contador de ordem. Retorna o handle do cadastro ou NULL se o CPF
+// não estiver na fila.
+const Patient* queue_remove_cpf(PatientQueue *q, const char *cpf);
+
+// Posição do nó na ordem de atendimento (1 = próximo), em O(log n).
+// É a ordem estrita: com envelhecimento, atrasados de níveis abaixo podem
+// passar na frente.
+size_t queue_position_of(const PatientQueue *q, const QueueNode *node);
+
+// Posição do CPF na ordem de atendimento (1 = próximo), 0 se não estiver na fila.
+size_t queue_position(const PatientQueue *q, const char *cpf);
+
+// Primeiro nó da fila na ordem de atendimento (NULL se vazia)
+const QueueNode* queue_first(const PatientQueue *q);
+
+// Próximo nó na ordem de atendimento, atravessando os níveis (NULL no fim)
+const QueueNode* queue_next(const PatientQueue *q, const QueueNode *node);
+
+// Modo página: acumula em out as posições [offset, offset + limit) na ordem
+// de atendimento, numeradas a partir de 1 ("N) ID: ..."), sem flush.
+// Retorna quantas linhas foram escritas.
+size_t print_queue_page(const PatientQueue *q, OutBuffer *out, size_t offset, size_t limit);
+
+// Zera as estatísticas e começa uma nova janela agora. Quem já está na fila
+// mantém o horário de chegada.
+void queue_stats_reset(PatientQueue *q);
 
-// Remove e retorna o paciente do INÍCIO da fila
-Patient* dequeue(PatientQueue *q);
+// Acumula em out uma linha por nível: chegadas e atendidos (total e por
+// minuto na janela), desistências e espera p50/p90/p99/máx, sem flush.
+// Retorna quantas linhas foram escritas.
+size_t print_queue_stats(const PatientQueue *q, OutBuffer *out);
 
-// Libera toda a memória usada pela fila
+// Libera toda a memória usada pela fila (nós em bloco; o cadastro não muda)
 void free_queue(PatientQueue *q);
 
-#endif // PATIENT_QUEUE_H
\ No newline at end of file
+#endif // PATIENT_QUEUE_H
@@ -0,0 +1,164 @@
+/*
+ Módulo: room_dispatch.c
+ Papel:  Uma fila por sala, rota na chegada e roubo de trabalho (ver .h).
+
+ Roubo: o candidato de cada sala é quem o dequeue dela atenderia agora
+ (queue_peek, já com o envelhecimento). Entre as salas vale a mesma regra
+ do dequeue: atrasado de prazo mais antigo primeiro; sem atrasados, nível
+ mais alto e chegada mais antiga. Comparar é O(salas) e tirar o escolhido
+ é dequeue_level no nível dele.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "room_dispatch.h"
+
+int dispatch_init(RoomDispatch* d, size_t rooms, DispatchPolicy policy) {
+    d->rooms = NULL;
+    d->count = 0;
+    if (rooms == 0) return 0;
+    d->rooms = calloc(rooms, sizeof *d->rooms);
+    if (!d->rooms) return 0;
+    d->count = rooms;
+    d->policy = policy;
+    d->stealing = 1;
+    for (size_t i = 0; i < rooms; i++) init_queue(&d->rooms[i].queue);
+    return 1;
+}
+
+int dispatch_set_specialty(RoomDispatch* d, size_t room, const char* keyword) {
+    if (room >= d->count) return 0;
+    char* dst = d->rooms[room].specialty;
+    size_t n = keyword ? strlen(keyword) : 0;
+    if (n > DISPATCH_SPECIALTY_CAP - 1) n = DISPATCH_SPECIALTY_CAP - 1;
+    memcpy(dst, keyword ? keyword : "", n);
+    dst[n] = '\0';
+    return 1;
+}
+
+void dispatch_set_clock(RoomDispatch* d, QueueClock clock) {
+    for (size_t i = 0; i < d->count; i++) {
+        d->rooms[i].queue.clock = clock;
+        queue_stats_reset(&d->rooms[i].queue);
+    }
+}
+
+/* ---------- rota ---------- */
+
+static char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+// keyword aparece em text? (ASCII sem diferenciar maiúsculas; keyword não vazia)
+static int mentions(const char* text, const char* keyword) {
+    for (; *text; text++) {
+        size_t i = 0;
+        while (keyword[i] && text[i] && ascii_lower(text[i]) == ascii_lower(keyword[i])) i++;
+        if (!keyword[i]) return 1;
+    }
+    return 0;
+}
+
+static size_t load_of(const Room* r) {
+    return r->queue.size + (size_t)r->in_service;
+}
+
+typedef enum { PICK_ALL, PICK_MATCH, PICK_GENERAL } RoomFilter;
+
+// Menos carregada entre as salas do filtro; count se nenhuma passar
+static size_t least_loaded(const RoomDispatch* d, RoomFilter filter, const char* condition) {
+    size_t best = d->count, best_load = 0;
+    for (size_t i = 0; i < d->count; i++) {
+        const Room* r = &d->rooms[i];
+        if (filter == PICK_MATCH && (!r->specialty[0] || !mentions(condition, r->specialty))) continue;
+        if (filter == PICK_GENERAL && r->specialty[0]) continue;
+        size_t load = load_of(r);
+        if (best == d->count || load < best_load) {
+            best = i;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+size_t dispatch_route(const RoomDispatch* d, const Patient* p) {
+    if (d->policy == DISPATCH_SPECIALTY) {
+        size_t room = least_loaded(d, PICK_MATCH, p->condition);
+        if (room == d->count) room = least_loaded(d, PICK_GENERAL, p->condition);
+        if (room != d->count) return room;
+    }
+    return least_loaded(d, PICK_ALL, p->condition);
+}
+
+int dispatch_enqueue(RoomDispatch* d, const Patient* p) {
+    size_t room = dispatch_route(d, p);
+    if (!enqueue(&d->rooms[room].queue, p)) return -1;
+    d->rooms[room].routed++;
+    return (int)room;
+}
+
+/* ---------- atendimento ---------- */
+
+// Prazo do nó se já venceu na política da fila dele; UINT64_MAX se não
+static uint64_t overdue(const PatientQueue* q, const QueueNode* n, uint64_t now) {
+    uint64_t limit = q->aging.max_wait_ns[n->level];
+    if (!limit || n->enqueued_ns + limit > now) return UINT64_MAX;
+    return n->enqueued_ns + limit;
+}
+
+// Sala (diferente de self) com o paciente que o dequeue escolheria primeiro
+// se as filas fossem uma só; count se nenhuma. *level recebe o nível dele.
+static size_t steal_victim(const RoomDispatch* d, size_t self, uint64_t now, int* level) {
+    size_t victim = d->count;
+    const QueueNode* best = NULL;
+    uint64_t best_deadline = UINT64_MAX;
+    for (size_t i = 0; i < d->count; i++) {
+        if (i == self) continue;
+        const PatientQueue* q = &d->rooms[i].queue;
+        const QueueNode* cand = queue_peek(q, now);
+        if (!cand) continue;
+        uint64_t deadline = overdue(q, cand, now);
+        int better;
+        if (!best)                               better = 1;
+        else if (deadline != best_deadline)      better = deadline < best_deadline;
+        else if (cand->level != best->level)     better = cand->level < best->level;
+        else                                     better = cand->enqueued_ns < best->enqueued_ns;
+        if (better) {
+            best = cand;
+            best_deadline = deadline;
+            victim = i;
+        }
+    }
+    if (best) *level = best->level;
+    return victim;
+}
+
+const Patient* dispatch_next(RoomDispatch* d, size_t room, size_t* from) {
+    if (room >= d->count) return NULL;
+    Room* r = &d->rooms[room];
+    size_t source = room;
+    const Patient* p = dequeue(&r->queue);
+    if (!p && d->stealing) {
+        int level = 0;
+        source = steal_victim(d, room, r->queue.clock(), &level);
+        if (source == d->count) return NULL;
+        p = dequeue_level(&d->rooms[source].queue, level);
+        r->stolen++;
+    }
+    if (!p) return NULL;
+    r->in_service = 1;
+    r->served++;
+    if (from) *from = source;
+    return p;
+}
+
+void dispatch_finish(RoomDispatch* d, size_t room) {
+    if (room < d->count) d->rooms[room].in_service = 0;
+}
+
+void dispatch_free(RoomDispatch* d) {
+    for (size_t i = 0; i < d->count; i++) free_queue(&d->rooms[i].queue);
+    free(d->rooms);
+    d->rooms = NULL;
+    d->count = 0;
+}
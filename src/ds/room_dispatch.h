@@ -0,0 +1,84 @@
+#ifndef ROOM_DISPATCH_H
+#define ROOM_DISPATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "patient_queue.h"
+
+/*
+  Várias salas (médicos) atendendo em paralelo, cada uma com a sua fila.
+
+  Chegada: dispatch_enqueue escolhe a sala pela política e põe o paciente
+  na PatientQueue dela (mesma ordem por prioridade, estatísticas e
+  envelhecimento de sempre).
+    - DISPATCH_LEAST_LOADED: a sala com menos pacientes (fila + em
+      atendimento); empate fica com a de menor índice.
+    - DISPATCH_SPECIALTY: entre as salas cuja especialidade aparece em
+      condition (sem diferenciar maiúsculas), a menos carregada; sem
+      nenhuma, a menos carregada entre as de clínico geral (especialidade
+      vazia) ou, se não houver, entre todas.
+  Atendimento: dispatch_next serve a própria fila. Com roubo ligado, uma
+  sala sem ninguém pega de outra quem o dequeue escolheria se as filas
+  fossem uma só: o atrasado de prazo mais antigo (envelhecimento da fila
+  de cada sala) ou, sem atrasados, o de nível mais alto que chegou antes.
+  A especialidade só decide a rota: qualquer sala pode atender qualquer
+  paciente. Cada paciente está em exatamente uma fila; roubar é tirá-lo
+  de lá, então ninguém é atendido duas vezes.
+
+  Single-thread, como a PatientQueue: as salas são atendidas pelo laço de
+  quem controla a clínica (ou pelo simulador).
+*/
+
+#define DISPATCH_SPECIALTY_CAP 32
+
+typedef enum {
+    DISPATCH_LEAST_LOADED = 0,
+    DISPATCH_SPECIALTY
+} DispatchPolicy;
+
+typedef struct {
+    char specialty[DISPATCH_SPECIALTY_CAP]; // palavra em condition ("" = clínico geral)
+    PatientQueue queue;
+    int in_service;          // 1 entre dispatch_next e dispatch_finish
+    uint64_t routed;         // chegadas encaminhadas para cá
+    uint64_t served;         // atendidos (inclui os roubados)
+    uint64_t stolen;         // atendidos que vieram da fila de outra sala
+} Room;
+
+typedef struct {
+    Room* rooms;
+    size_t count;
+    DispatchPolicy policy;
+    int stealing;            // 1 => sala ociosa rouba das outras
+} RoomDispatch;
+
+/* rooms >= 1 salas vazias, sem especialidade, roubo ligado.
+   Returns: 1 ok, 0 sem memória. */
+int dispatch_init(RoomDispatch* d, size_t rooms, DispatchPolicy policy);
+
+/* Especialidade da sala (copiada, cortada em DISPATCH_SPECIALTY_CAP - 1;
+   NULL ou "" = clínico geral). Returns: 0 se a sala não existe. */
+int dispatch_set_specialty(RoomDispatch* d, size_t room, const char* keyword);
+
+/* Mesmo relógio em todas as filas (simulações usam um virtual). */
+void dispatch_set_clock(RoomDispatch* d, QueueClock clock);
+
+/* Sala que a política escolheria para p agora (sem enfileirar). */
+size_t dispatch_route(const RoomDispatch* d, const Patient* p);
+
+/* Encaminha p (handle do cadastro, como no enqueue). Returns: índice da
+   sala, ou -1 se faltar memória. */
+int dispatch_enqueue(RoomDispatch* d, const Patient* p);
+
+/* Próximo paciente da sala (própria fila; vazia => roubo, se ligado), ou
+   NULL se não há ninguém para ela. Marca a sala como em atendimento.
+   from (opcional) recebe a sala de cuja fila o paciente saiu. */
+const Patient* dispatch_next(RoomDispatch* d, size_t room, size_t* from);
+
+/* Fim do atendimento da sala (volta a contar como livre na rota). */
+void dispatch_finish(RoomDispatch* d, size_t room);
+
+/* Libera as filas (o cadastro não muda). */
+void dispatch_free(RoomDispatch* d);
+
+#endif /* ROOM_DISPATCH_H */
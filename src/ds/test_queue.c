@@ -42,7 +42,7 @@ int main() {
     printf("Fila inicializada e pacientes enfileirados.\n");
 
     // Desenfileira e mostra os pacientes
-    Patient *p;
+    const Patient *p;
     while (!is_queue_empty(&queue)) {
         p = dequeue(&queue);
         printf("Atendendo paciente: %s (ID: %d, Prioridade: %d)\n", p->name, p->id, p->priority);
@@ -0,0 +1,262 @@
+/*
+ Módulo: clinic.c
+ Papel:  Handle da libclinic (ver clinic.h): as estruturas do cadastro,
+         da fila e do histórico de uma sessão, mais snapshot/WAL. Cada
+         mutação aplicada é registrada no WAL aqui, na mesma ordem.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "clinic.h"
+
+struct clinic_ctx {
+    PatientList list;
+    PatientQueue queue;
+    HistoryStack history;
+    Persistence ps;
+};
+
+clinic_options clinic_default_options(void) {
+    clinic_options opt;
+    memset(&opt, 0, sizeof opt);
+    opt.persistence = persistence_default_options();
+    opt.history_max = CLINIC_DEFAULT_HISTORY_MAX;
+    return opt;
+}
+
+clinic_status clinic_create(const clinic_options* opt, clinic_ctx** out) {
+    clinic_options def = clinic_default_options();
+    if (!opt) opt = &def;
+    *out = NULL;
+    clinic_ctx* ctx = malloc(sizeof *ctx);
+    if (!ctx) return CLINIC_ERR_NOMEM;
+
+    init_patient_list(&ctx->list);
+    init_queue(&ctx->queue);
+    queue_set_aging(&ctx->queue, opt->max_wait_ns);
+    init_history_stack_bounded(&ctx->history, opt->history_max);
+
+    *out = ctx;
+    if (!persistence_open(&ctx->ps, &opt->persistence, &ctx->list, &ctx->queue, &ctx->history)) {
+        const PersistenceReport* r = &ctx->ps.report;
+        int snapshot_ok = !ctx->ps.opt.snapshot_path || r->snapshot == SNAP_OK || r->snapshot_missing;
+        return snapshot_ok ? CLINIC_ERR_WAL : CLINIC_ERR_SNAPSHOT;
+    }
+    return CLINIC_OK;
+}
+
+void clinic_destroy(clinic_ctx* ctx) {
+    if (!ctx) return;
+    persistence_close(&ctx->ps);
+    free_list(&ctx->list);
+    free_queue(&ctx->queue);
+    free_history(&ctx->history);
+    free(ctx);
+}
+
+const Persistence* clinic_persistence(const clinic_ctx* ctx) {
+    return &ctx->ps;
+}
+
+const char* clinic_strerror(clinic_status st) {
+    switch (st) {
+        case CLINIC_OK:                return "ok";
+        case CLINIC_ERR_ARG:           return "argumento inválido";
+        case CLINIC_ERR_INVALID:       return "paciente inválido";
+        case CLINIC_ERR_DUPLICATE:     return "CPF/ID já existente";
+        case CLINIC_ERR_NOT_FOUND:     return "CPF não encontrado";
+        case CLINIC_ERR_NOT_QUEUED:    return "CPF não está na fila";
+        case CLINIC_ERR_QUEUE_EMPTY:   return "fila vazia";
+        case CLINIC_ERR_HISTORY_EMPTY: return "histórico vazio";
+        case CLINIC_ERR_STALE:         return "paciente não está no cadastro";
+        case CLINIC_ERR_NOMEM:         return "erro de memória";
+        case CLINIC_ERR_WAL:           return "WAL indisponível";
+        case CLINIC_ERR_SNAPSHOT:      return "falha no snapshot";
+        case CLINIC_ERR_IMPORT:        return "importação interrompida";
+        case CLINIC_ERR_IO:            return "aplicado, mas não gravado no WAL";
+    }
+    return "erro desconhecido";
+}
+
+/* ---------- cadastro ---------- */
+
+clinic_status clinic_register(clinic_ctx* ctx, const Patient* p,
+                              const Patient** out, PatientError* why) {
+    if (!p) return CLINIC_ERR_ARG;
+    Patient copy = *p;
+    patient_normalize(&copy);
+    PatientError err = patient_check(&copy);
+    if (why) *why = err;
+    if (err != PATIENT_OK) return CLINIC_ERR_INVALID;
+
+    /* insert_patient não diz por que recusou: duplicata é conferida antes */
+    if (search_patient_by_CPF(&ctx->list, copy.cpf) || search_patient_by_id(&ctx->list, copy.id))
+        return CLINIC_ERR_DUPLICATE;
+    if (!insert_patient(&ctx->list, &copy)) return CLINIC_ERR_NOMEM;
+    if (out) *out = search_patient_by_CPF(&ctx->list, copy.cpf);
+    return wal_log_register(&ctx->ps.wal, &copy) ? CLINIC_OK : CLINIC_ERR_IO;
+}
+
+const Patient* clinic_find_cpf(const clinic_ctx* ctx, const char* cpf) {
+    return cpf ? search_patient_by_CPF(&ctx->list, cpf) : NULL;
+}
+
+const Patient* clinic_find_id(const clinic_ctx* ctx, int id) {
+    return search_patient_by_id(&ctx->list, id);
+}
+
+IdCursor clinic_id_range(const clinic_ctx* ctx, int lo, int hi) {
+    return patient_id_range(&ctx->list, lo, hi);
+}
+
+void clinic_name_search(clinic_ctx* ctx, const char* query, NameCursor* cur) {
+    patient_name_search(&ctx->list, query, cur);
+}
+
+/* Sink da importação: WAL primeiro, depois o sink de quem chamou */
+typedef struct {
+    clinic_ctx* ctx;
+    const ImportSink* user;
+    int wal_failed;
+} ImportRelay;
+
+static void relay_error(void* arg, size_t line, const char* msg) {
+    const ImportRelay* r = arg;
+    r->user->on_error(r->user->ctx, line, msg);
+}
+
+static void relay_patient(void* arg, const Patient* p) {
+    ImportRelay* r = arg;
+    if (!wal_log_register(&r->ctx->ps.wal, p)) r->wal_failed = 1;
+    if (r->user && r->user->on_patient) r->user->on_patient(r->user->ctx, p);
+}
+
+clinic_status clinic_import(clinic_ctx* ctx, FILE* in, const ImportOptions* opt,
+                            const ImportSink* sink, ImportStats* stats) {
+    if (!in) return CLINIC_ERR_ARG;
+    ImportRelay relay = { ctx, sink, 0 };
+    ImportSink wrapped = { &relay, (sink && sink->on_error) ? relay_error : NULL, relay_patient };
+    if (!import_patients(in, &ctx->list, opt, &wrapped, stats)) return CLINIC_ERR_IMPORT;
+    return relay.wal_failed ? CLINIC_ERR_IO : CLINIC_OK;
+}
+
+/* ---------- fila e histórico ---------- */
+
+clinic_status clinic_enqueue(clinic_ctx* ctx, const char* cpf, const Patient** out) {
+    const Patient* p = clinic_find_cpf(ctx, cpf);
+    if (!p) return CLINIC_ERR_NOT_FOUND;
+    /* A fila guarda só o handle do paciente no cadastro */
+    if (!enqueue(&ctx->queue, p)) return CLINIC_ERR_NOMEM;
+    if (out) *out = p;
+    return wal_log_enqueue(&ctx->ps.wal, p->cpf) ? CLINIC_OK : CLINIC_ERR_IO;
+}
+
+clinic_status clinic_dequeue(clinic_ctx* ctx, const Patient** out) {
+    uint64_t arrived;
+    const Patient* p = dequeue_timed(&ctx->queue, &arrived);
+    if (!p) return CLINIC_ERR_QUEUE_EMPTY;
+    /* A fila já entrega o handle do CADASTRO: vai direto para o histórico */
+    HistoryRecord rec = make_history_record(p);
+    rec.level = (unsigned char)p->priority;
+    rec.enqueued_ns = arrived;
+    if (!push_history(&ctx->history, rec)) {
+        /* Sem histórico não há undo: desfaz o atendimento (o nó acabou de
+           voltar ao pool, a volta à frente reaproveita o lugar dele) */
+        enqueue_front_at(&ctx->queue, p, arrived);
+        return CLINIC_ERR_NOMEM;
+    }
+    if (out) *out = p;
+    /* Os dois registros sempre: um sem o outro desalinha o replay */
+    int logged = wal_log_dequeue(&ctx->ps.wal, queue_level_of(p));
+    logged = wal_log_history_push(&ctx->ps.wal, &rec) && logged;
+    return logged ? CLINIC_OK : CLINIC_ERR_IO;
+}
+
+clinic_status clinic_cancel(clinic_ctx* ctx, const char* cpf, const Patient** out) {
+    if (!cpf) return CLINIC_ERR_ARG;
+    /* Mapa CPF -> nó da fila: sai direto, sem percorrer */
+    const Patient* p = queue_remove_cpf(&ctx->queue, cpf);
+    if (!p) return CLINIC_ERR_NOT_QUEUED;
+    if (out) *out = p;
+    return wal_log_cancel(&ctx->ps.wal, p->cpf) ? CLINIC_OK : CLINIC_ERR_IO;
+}
+
+size_t clinic_position(const clinic_ctx* ctx, const char* cpf) {
+    return cpf ? queue_position(&ctx->queue, cpf) : 0;
+}
+
+clinic_status clinic_undo(clinic_ctx* ctx, HistoryRecord* out) {
+    HistoryRecord rec;
+    UndoStatus st = undo_last_service(&ctx->history, &ctx->queue, &rec);
+    if (st == UNDO_EMPTY) return CLINIC_ERR_HISTORY_EMPTY;
+    if (st == UNDO_NOMEM) return CLINIC_ERR_NOMEM;
+    /* O registro saiu do histórico nos dois casos: o replay também o tira */
+    int logged = wal_log_undo(&ctx->ps.wal);
+    if (st == UNDO_NO_PATIENT) return CLINIC_ERR_STALE;
+    if (out) *out = rec;
+    return logged ? CLINIC_OK : CLINIC_ERR_IO;
+}
+
+/* ---------- iteração ---------- */
+
+size_t clinic_each_patient(const clinic_ctx* ctx, clinic_visit_fn fn, void* user) {
+    size_t n = 0;
+    for (const Node* node = ctx->list.head; node; node = node->next) {
+        n++;
+        if (!fn(user, &node->data)) break;
+    }
+    return n;
+}
+
+size_t clinic_each_queued(const clinic_ctx* ctx, clinic_visit_fn fn, void* user) {
+    size_t n = 0;
+    for (const QueueNode* node = queue_first(&ctx->queue); node;
+         node = queue_next(&ctx->queue, node)) {
+        n++;
+        if (!fn(user, node->patient)) break;
+    }
+    return n;
+}
+
+const PatientList* clinic_patients(const clinic_ctx* ctx)  { return &ctx->list; }
+const PatientQueue* clinic_queue(const clinic_ctx* ctx)    { return &ctx->queue; }
+const HistoryStack* clinic_history(const clinic_ctx* ctx)  { return &ctx->history; }
+
+/* ---------- persistência ---------- */
+
+clinic_status clinic_save(clinic_ctx* ctx, const char* path, SnapshotStatus* snap) {
+    if (!path) path = ctx->ps.opt.snapshot_path;
+    if (!path || !*path) return CLINIC_ERR_ARG;
+    SnapshotStatus st = persistence_checkpoint(&ctx->ps, path, &ctx->list,
+                                               &ctx->queue, &ctx->history);
+    if (snap) *snap = st;
+    return st == SNAP_OK ? CLINIC_OK : CLINIC_ERR_SNAPSHOT;
+}
+
+clinic_status clinic_load(clinic_ctx* ctx, const char* path, SnapshotStatus* snap) {
+    if (!path || !*path) return CLINIC_ERR_ARG;
+    /* O WAL antigo não vale para o novo estado: precisa de onde fazer checkpoint */
+    if (ctx->ps.wal.f && !ctx->ps.opt.snapshot_path) return CLINIC_ERR_ARG;
+    /* Pendentes no disco antes de trocar o estado; se nem isso dá, nada muda */
+    if (!wal_sync(&ctx->ps.wal)) {
+        if (snap) *snap = SNAP_ERR_IO;
+        return CLINIC_ERR_WAL;
+    }
+    SnapshotStatus st = snapshot_load(path, &ctx->list, &ctx->queue, &ctx->history, NULL);
+    if (snap) *snap = st;
+    if (st != SNAP_OK) return CLINIC_ERR_SNAPSHOT;
+    if (!ctx->ps.wal.f) return CLINIC_OK;
+
+    st = persistence_checkpoint(&ctx->ps, NULL, &ctx->list, &ctx->queue, &ctx->history);
+    if (snap) *snap = st;
+    if (st == SNAP_OK) return CLINIC_OK;
+    /* Estado novo só em memória: no disco vale o antigo (snapshot + WAL) ou
+       o novo snapshot, que já cobre o WAL. Mutações do estado novo no WAL
+       antigo estragariam o replay: o WAL recusa até o próximo checkpoint */
+    ctx->ps.wal.broken = 1;
+    return CLINIC_ERR_IO;
+}
+
+clinic_status clinic_sync(clinic_ctx* ctx) {
+    return wal_sync(&ctx->ps.wal) ? CLINIC_OK : CLINIC_ERR_WAL;
+}
@@ -0,0 +1,161 @@
+#ifndef CLINIC_H
+#define CLINIC_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "model/patient.h"
+#include "model/history.h"
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+#include "util/patient_import.h"
+#include "lib/persistence.h"
+
+/*
+  libclinic: o motor da clínica (cadastro, fila, histórico, snapshot/WAL)
+  atrás de um handle, sem estado global. O menu, o batch, o servidor e os
+  benchmarks linkam libclinic.a (ou libclinic.so).
+
+  Nenhuma função clinic_* lê do console nem imprime: o resultado volta em
+  clinic_status (texto em clinic_strerror) e os dados em ponteiros para o
+  cadastro. Um clinic_ctx não é thread-safe; cada handle é independente.
+
+  CLINIC_ERR_IO nas mutações: a operação foi aplicada em memória (e os
+  ponteiros de saída preenchidos), mas o WAL não a gravou; ela pode não
+  voltar no replay. Os demais erros não mudam o estado.
+
+  Todo Patient devolvido aponta para o cadastro e vale até clinic_destroy
+  (ou até um clinic_load, que substitui o estado).
+
+  Uso mínimo:
+      clinic_ctx* c;
+      clinic_options opt = clinic_default_options();
+      if (clinic_create(&opt, &c) != CLINIC_OK) ...
+      clinic_register(c, &p, NULL, NULL);
+      clinic_enqueue(c, p.cpf, NULL);
+      clinic_dequeue(c, &next);
+      clinic_destroy(c);
+*/
+
+#define CLINIC_DEFAULT_HISTORY_MAX 10000u
+
+typedef struct clinic_ctx clinic_ctx;
+
+typedef enum {
+    CLINIC_OK = 0,
+    CLINIC_ERR_ARG,           // argumento nulo/vazio ou operação sem configuração
+    CLINIC_ERR_INVALID,       // paciente recusado por patient_validate (ver why)
+    CLINIC_ERR_DUPLICATE,     // CPF ou id já cadastrado
+    CLINIC_ERR_NOT_FOUND,     // CPF/id fora do cadastro
+    CLINIC_ERR_NOT_QUEUED,    // CPF fora da fila
+    CLINIC_ERR_QUEUE_EMPTY,
+    CLINIC_ERR_HISTORY_EMPTY,
+    CLINIC_ERR_STALE,         // undo de um registro sem paciente (descartado)
+    CLINIC_ERR_NOMEM,
+    CLINIC_ERR_WAL,           // WAL inválido ou sem abrir (handle segue válido, sem WAL)
+    CLINIC_ERR_SNAPSHOT,      // snapshot não gravado/carregado (ver SnapshotStatus)
+    CLINIC_ERR_IMPORT,        // importação interrompida (cabeçalho ou memória)
+    CLINIC_ERR_IO             // aplicada em memória, mas fora do WAL (E/S ou WAL quebrado)
+} clinic_status;
+
+typedef struct {
+    PersistenceOptions persistence;     // snapshot / WAL restaurados em clinic_create
+    size_t history_max;                 // K do histórico em anel (0 = ilimitado)
+    uint64_t max_wait_ns[QUEUE_LEVELS]; // envelhecimento da fila (tudo 0 = estrita)
+} clinic_options;
+
+/* Sem snapshot, sem WAL, histórico de CLINIC_DEFAULT_HISTORY_MAX, fila estrita. */
+clinic_options clinic_default_options(void);
+
+/* Cria o estado e restaura snapshot/WAL de opt (NULL => padrão).
+   Returns: CLINIC_OK; CLINIC_ERR_WAL com *out válido (estado restaurado até
+   onde deu, mutações não vão para o WAL); CLINIC_ERR_SNAPSHOT com *out
+   válido e vazio se o snapshot existe e não carregou (WAL nem lido: não
+   siga, um save apagaria o snapshot bom); CLINIC_ERR_NOMEM com *out NULL. */
+clinic_status clinic_create(const clinic_options* opt, clinic_ctx** out);
+
+/* Sincroniza o WAL e libera tudo (NULL é aceito). */
+void clinic_destroy(clinic_ctx* ctx);
+
+/* Opções efetivas e o que aconteceu na partida (report). */
+const Persistence* clinic_persistence(const clinic_ctx* ctx);
+
+/* Texto curto do status (o mesmo das respostas "ERR" do batch). */
+const char* clinic_strerror(clinic_status st);
+
+/* ---------- cadastro ---------- */
+
+/* Normaliza uma cópia de p, valida e insere (e registra no WAL).
+   out (opcional): o paciente no cadastro. why (opcional): a regra violada
+   quando CLINIC_ERR_INVALID. */
+clinic_status clinic_register(clinic_ctx* ctx, const Patient* p,
+                              const Patient** out, PatientError* why);
+
+/* NULL se não cadastrado. */
+const Patient* clinic_find_cpf(const clinic_ctx* ctx, const char* cpf);
+const Patient* clinic_find_id(const clinic_ctx* ctx, int id);
+
+/* Cursores do cadastro (ver patient_id_range / patient_name_search). A
+   busca por nome não é const: depois de um snapshot ela completa o índice. */
+IdCursor clinic_id_range(const clinic_ctx* ctx, int lo, int hi);
+void clinic_name_search(clinic_ctx* ctx, const char* query, NameCursor* cur);
+
+/* Importação em massa (patient_import.h); cada inserido também vai para o
+   WAL antes de sink->on_patient. sink pode ser NULL. */
+clinic_status clinic_import(clinic_ctx* ctx, FILE* in, const ImportOptions* opt,
+                            const ImportSink* sink, ImportStats* stats);
+
+/* ---------- fila e histórico ---------- */
+
+clinic_status clinic_enqueue(clinic_ctx* ctx, const char* cpf, const Patient** out);
+
+/* Atende o próximo: sai da fila e entra no histórico (permite undo).
+   CLINIC_ERR_NOMEM: o histórico não cresceu e o paciente volta à frente
+   da fila (nada muda). */
+clinic_status clinic_dequeue(clinic_ctx* ctx, const Patient** out);
+
+/* Desistência: sai da fila sem passar pelo histórico. */
+clinic_status clinic_cancel(clinic_ctx* ctx, const char* cpf, const Patient** out);
+
+/* Posição na fila (1 = próximo); 0 se o CPF não está na fila. */
+size_t clinic_position(const clinic_ctx* ctx, const char* cpf);
+
+/* Desfaz o último atendimento: o paciente volta ao início do seu nível.
+   out (opcional) recebe o registro desfeito. */
+clinic_status clinic_undo(clinic_ctx* ctx, HistoryRecord* out);
+
+/* ---------- iteração ---------- */
+
+/* fn devolve 0 para parar. Returns: quantos pacientes fn recebeu. */
+typedef int (*clinic_visit_fn)(void* user, const Patient* p);
+
+/* Cadastro, na ordem da lista. */
+size_t clinic_each_patient(const clinic_ctx* ctx, clinic_visit_fn fn, void* user);
+
+/* Fila, na ordem de atendimento estrita (prioridade, depois chegada). */
+size_t clinic_each_queued(const clinic_ctx* ctx, clinic_visit_fn fn, void* user);
+
+/* Estruturas para leitura (listagens em página, estatísticas da fila). */
+const PatientList* clinic_patients(const clinic_ctx* ctx);
+const PatientQueue* clinic_queue(const clinic_ctx* ctx);
+const HistoryStack* clinic_history(const clinic_ctx* ctx);
+
+/* ---------- persistência ---------- */
+
+/* Checkpoint: grava snapshot em path (NULL => o snapshot das opções) e,
+   se for o das opções, esvazia o WAL. snap (opcional) recebe o detalhe. */
+clinic_status clinic_save(clinic_ctx* ctx, const char* path, SnapshotStatus* snap);
+
+/* Substitui o estado pelo snapshot em path. Com WAL ligado faz um
+   checkpoint logo em seguida (exige snapshot nas opções: CLINIC_ERR_ARG).
+   Returns: CLINIC_ERR_WAL/CLINIC_ERR_SNAPSHOT sem mudar o estado;
+   CLINIC_ERR_IO se carregou mas o checkpoint falhou: o estado novo fica
+   só em memória e o WAL recusa registros (mutações => CLINIC_ERR_IO) até
+   um clinic_save no snapshot das opções dar certo. */
+clinic_status clinic_load(clinic_ctx* ctx, const char* path, SnapshotStatus* snap);
+
+/* Grava no disco o que o WAL tem pendente (group commit). */
+clinic_status clinic_sync(clinic_ctx* ctx);
+
+#endif /* CLINIC_H */
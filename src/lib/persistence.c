@@ -0,0 +1,98 @@
+#include <errno.h>
+#include <string.h>
+#include "persistence.h"
+
+PersistenceOptions persistence_default_options(void) {
+    PersistenceOptions opt;
+    opt.snapshot_path = NULL;
+    opt.wal_path = NULL;
+    opt.wal_cfg = wal_default_config();
+    return opt;
+}
+
+/* Primeira partida (arquivo ainda não criado) x snapshot que não abre */
+static int file_missing(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f) {
+        fclose(f);
+        return 0;
+    }
+    return errno == ENOENT;
+}
+
+int persistence_open(Persistence* ps, const PersistenceOptions* opt,
+                     PatientList* list, PatientQueue* queue, HistoryStack* history) {
+    ps->opt = opt ? *opt : persistence_default_options();
+    wal_init_disabled(&ps->wal);
+    memset(&ps->report, 0, sizeof ps->report);
+
+    uint64_t lsn = 0;
+    if (ps->opt.snapshot_path) {
+        ps->report.snapshot = snapshot_load(ps->opt.snapshot_path, list, queue, history, &lsn);
+        ps->report.patients = list->size;
+        ps->report.queued = queue->size;
+        /* Reaplicar o WAL num estado vazio (e depois gravar o snapshot por
+           cima do bom) perderia tudo: quem chama não deve seguir */
+        if (ps->report.snapshot != SNAP_OK) {
+            ps->report.snapshot_missing = file_missing(ps->opt.snapshot_path);
+            if (!ps->report.snapshot_missing) return 0;
+        }
+    }
+
+    if (!ps->opt.wal_path) return 1;
+
+    if (!wal_replay(ps->opt.wal_path, lsn, list, queue, history, &lsn, &ps->report.wal_applied)) {
+        ps->report.wal = PERSIST_WAL_INVALID;
+        return 0;
+    }
+    if (!wal_open(&ps->wal, ps->opt.wal_path, ps->opt.wal_cfg, lsn + 1)) {
+        ps->report.wal = PERSIST_WAL_OPEN_FAILED;
+        return 0;
+    }
+    return 1;
+}
+
+void persistence_print_report(const Persistence* ps, FILE* log) {
+    const PersistenceReport* r = &ps->report;
+    if (ps->opt.snapshot_path) {
+        if (r->snapshot == SNAP_OK)
+            fprintf(log, "-> Snapshot '%s' carregado: %zu pacientes, %zu na fila.\n",
+                    ps->opt.snapshot_path, r->patients, r->queued);
+        else if (r->snapshot_missing)
+            fprintf(log, "-> Snapshot '%s' ainda não existe; começando vazio.\n",
+                    ps->opt.snapshot_path);
+        else {
+            fprintf(log, "-> Snapshot '%s' não carregado (%s); WAL não reaplicado.\n",
+                    ps->opt.snapshot_path, snapshot_strerror(r->snapshot));
+            return;
+        }
+    }
+    if (!ps->opt.wal_path) return;
+    if (r->wal == PERSIST_WAL_INVALID)
+        fprintf(log, "-> WAL '%s' inválido ou não reaplicado por inteiro (%zu operações aplicadas).\n",
+                ps->opt.wal_path, r->wal_applied);
+    else if (r->wal_applied)
+        fprintf(log, "-> WAL '%s': %zu operações reaplicadas.\n", ps->opt.wal_path, r->wal_applied);
+    if (r->wal == PERSIST_WAL_OPEN_FAILED)
+        fprintf(log, "-> Não foi possível abrir o WAL '%s'.\n", ps->opt.wal_path);
+}
+
+SnapshotStatus persistence_checkpoint(Persistence* ps, const char* path,
+                                      const PatientList* list, const PatientQueue* queue,
+                                      const HistoryStack* history) {
+    if (!path) path = ps->opt.snapshot_path;
+    if (!path) return SNAP_ERR_IO;
+
+    if (!wal_sync(&ps->wal)) return SNAP_ERR_IO;
+    SnapshotStatus st = snapshot_save(path, list, queue, history, ps->wal.next_lsn - 1);
+    if (st != SNAP_OK) return st;
+
+    /* Só esvazia o WAL quando o snapshot é o "oficial" lido na partida */
+    if (ps->opt.snapshot_path && strcmp(path, ps->opt.snapshot_path) == 0 && !wal_reset(&ps->wal))
+        return SNAP_ERR_IO;
+    return SNAP_OK;
+}
+
+void persistence_close(Persistence* ps) {
+    wal_close(&ps->wal);
+}
@@ -0,0 +1,67 @@
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include <stdio.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+#include "util/snapshot.h"
+#include "util/wal.h"
+
+/*
+  Cola entre snapshot e WAL, usada pela libclinic (lib/clinic.h).
+
+  Partida:    snapshot (se houver) -> replay do WAL acima do LSN do snapshot
+              -> WAL aberto para append. Snapshot que existe mas não carrega
+              para a partida: o WAL é dele e o próximo checkpoint o apagaria.
+  Checkpoint: wal_sync -> snapshot com o último LSN -> WAL esvaziado.
+*/
+
+typedef struct {
+    const char* snapshot_path;  // NULL => sem snapshot
+    const char* wal_path;       // NULL => sem WAL
+    WalConfig wal_cfg;
+} PersistenceOptions;
+
+/* O que aconteceu na partida (persistence_open não imprime nada). */
+typedef enum {
+    PERSIST_WAL_OK = 0,         // reaplicado e aberto (ou sem WAL)
+    PERSIST_WAL_INVALID,        // arquivo inválido ou replay interrompido
+    PERSIST_WAL_OPEN_FAILED     // reaplicado, mas não abriu para append
+} PersistWalStatus;
+
+typedef struct {
+    SnapshotStatus snapshot;    // resultado do snapshot_load (com snapshot_path)
+    int snapshot_missing;       // snapshot_path ainda não existe (primeira partida)
+    size_t patients, queued;    // estado logo após o snapshot
+    size_t wal_applied;         // operações reaplicadas do WAL
+    PersistWalStatus wal;
+} PersistenceReport;
+
+typedef struct {
+    PersistenceOptions opt;
+    Wal wal;                    // desligado se opt.wal_path == NULL
+    PersistenceReport report;   // preenchido por persistence_open
+} Persistence;
+
+/* Opções sem snapshot e sem WAL (janela de group commit padrão). */
+PersistenceOptions persistence_default_options(void);
+
+/* Restaura o estado e abre o WAL; o resultado fica em ps->report.
+   Returns: 1 ok, 0 se o snapshot existe e não carregou (WAL nem lido) ou
+   se o WAL não pôde ser reaplicado/aberto. */
+int persistence_open(Persistence* ps, const PersistenceOptions* opt,
+                     PatientList* list, PatientQueue* queue, HistoryStack* history);
+
+/* Mensagens da partida ("-> Snapshot ... carregado", ...) em log. */
+void persistence_print_report(const Persistence* ps, FILE* log);
+
+/* Grava snapshot em path (NULL => opt.snapshot_path) e esvazia o WAL. */
+SnapshotStatus persistence_checkpoint(Persistence* ps, const char* path,
+                                      const PatientList* list, const PatientQueue* queue,
+                                      const HistoryStack* history);
+
+/* Sincroniza pendentes do WAL e fecha. */
+void persistence_close(Persistence* ps);
+
+#endif /* PERSISTENCE_H */
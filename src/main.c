@@ -1,7 +1,113 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "controller/main_controller.h"
+#include "controller/batch_controller.h"
+#include "controller/server_controller.h"
+#include "controller/app_options.h"
 
-int main(void) {
-    // Apenas executa o menu principal por enquanto.
-    run_main_menu();
-    return 0;
-}
\ No newline at end of file
+static int usage(const char* prog) {
+    fprintf(stderr,
+            "Uso: %s [--snapshot arquivo] [--wal arquivo [--wal-window ms]]"
+            " [--history-max K] [--import-gender M|F] [--max-wait m1,m2,m3]"
+            " [--batch [arquivo|-] | --server socket [--tcp porta]]\n", prog);
+    return 2;
+}
+
+/* Valor de opção que não passou em parse_uint: diz qual e mostra o uso */
+static int bad_value(const char* prog, const char* name, const char* value) {
+    fprintf(stderr, "%s: valor inválido para %s: '%s'\n", prog, name, value);
+    return usage(prog);
+}
+
+/* Inteiro sem sinal só com dígitos, sem estouro e <= max (strtoul sozinho
+   aceitaria "-1", " 5", "5ms" e valores fora da faixa) */
+static int parse_uint(const char* s, unsigned long max, unsigned long* out) {
+    if (*s < '0' || *s > '9') return 0;
+    char* end;
+    errno = 0;
+    unsigned long v = strtoul(s, &end, 10);
+    if (*end || errno == ERANGE || v > max) return 0;
+    *out = v;
+    return 1;
+}
+
+/* "m1,m2,m3": minutos por prioridade (campos faltando => 0) */
+static int parse_max_wait(const char* s, uint64_t out[QUEUE_LEVELS]) {
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) {
+        out[lv] = 0;
+        if (!*s) continue;
+        char* end;
+        unsigned long minutes = strtoul(s, &end, 10);
+        if (end == s || (*end && *end != ',')) return 0;
+        out[lv] = (uint64_t)minutes * 60u * 1000000000u;
+        s = *end ? end + 1 : end;
+    }
+    return *s == '\0';
+}
+
+int main(int argc, char** argv) {
+    AppOptions opt;
+    opt.persistence = persistence_default_options();
+    opt.history_max = APP_DEFAULT_HISTORY_MAX;
+    opt.import_gender = 0;
+    for (int lv = 0; lv < QUEUE_LEVELS; lv++) opt.max_wait_ns[lv] = 0;
+    opt.server_socket = NULL;
+    opt.server_port = 0;
+    const char* batch_path = NULL;
+    int batch = 0, server = 0;
+
+    for (int i = 1; i < argc; i++) {
+        unsigned long n;
+        if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            opt.persistence.snapshot_path = argv[++i];
+        } else if (strcmp(argv[i], "--wal") == 0 && i + 1 < argc) {
+            opt.persistence.wal_path = argv[++i];
+        } else if (strcmp(argv[i], "--wal-window") == 0 && i + 1 < argc) {
+            // Janela de group commit em ms (0 => fsync a cada operação)
+            if (!parse_uint(argv[++i], UINT_MAX, &n)) return bad_value(argv[0], argv[i - 1], argv[i]);
+            opt.persistence.wal_cfg.group_window_ms = (unsigned)n;
+        } else if (strcmp(argv[i], "--history-max") == 0 && i + 1 < argc) {
+            // Tamanho do histórico em anel (0 => ilimitado)
+            if (!parse_uint(argv[++i], SIZE_MAX < ULONG_MAX ? (unsigned long)SIZE_MAX : ULONG_MAX, &n))
+                return bad_value(argv[0], argv[i - 1], argv[i]);
+            opt.history_max = (size_t)n;
+        } else if (strcmp(argv[i], "--import-gender") == 0 && i + 1 < argc) {
+            // Sexo assumido ao importar arquivos sem essa coluna (sistema antigo)
+            opt.import_gender = argv[++i][0];
+        } else if (strcmp(argv[i], "--max-wait") == 0 && i + 1 < argc) {
+            // Espera máxima por prioridade em minutos (0 = sem limite): quem
+            // passa dela é atendido antes dos níveis acima (envelhecimento)
+            if (!parse_max_wait(argv[++i], opt.max_wait_ns)) return usage(argv[0]);
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+            // Arquivo opcional (sem arquivo ou "-" => stdin)
+            if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+                batch_path = argv[++i];
+        } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+            // Servidor: muitos balcões num só estado, pelo socket Unix dado
+            opt.server_socket = argv[++i];
+            server = 1;
+        } else if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            // Servidor também (ou só) em TCP, apenas em 127.0.0.1
+            if (!parse_uint(argv[++i], 65535, &n) || n == 0) return bad_value(argv[0], argv[i - 1], argv[i]);
+            opt.server_port = (unsigned)n;
+            server = 1;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (batch && server) return usage(argv[0]);
+
+    // Modo servidor: protocolo do batch sobre sockets, até SIGINT/SIGTERM
+    if (server) return run_server(&opt);
+
+    // Modo batch: comandos sem prompts
+    if (batch) return run_batch(batch_path, &opt);
+
+    // Sem --batch: menu interativo.
+    return run_main_menu(&opt);
+}
@@ -0,0 +1,104 @@
+#include "cpf.h"
+
+/*
+ * Regras de CPF (sem I/O).
+ *
+ * Dígitos verificadores (módulo 11):
+ *   DV1 = (soma d[i] * (10 - i), i = 0..8) * 10 % 11, e 10 vira 0;
+ *   DV2 = (soma d[i] * (11 - i), i = 0..9) * 10 % 11, e 10 vira 0.
+ * Sequências repetidas (000.000.000-00, 111.111.111-11, ...) passam na
+ * conta mas não são CPFs emitidos: também são recusadas.
+ */
+
+int cpf_normalize_key(const char* cpf, char out[CPF_KEY_CAP]) {
+    int n = 0;
+    if (!cpf) { out[0] = '\0'; return 0; }
+    for (; *cpf && n < CPF_KEY_CAP - 1; cpf++) {
+        char c = *cpf;
+        if (c == '.' || c == '-' || c == '/' || c == ' ' ||
+            c == '\t' || c == '\n' || c == '\r')
+            continue;
+        out[n++] = c;
+    }
+    out[n] = '\0';
+    return n > 0;
+}
+
+/* Mesmo resultado de cpf_normalize_key seguido da conversão, numa passada
+   só (a chave normalizada guarda no máximo CPF_KEY_CAP - 1 caracteres). */
+int cpf_pack_key(const char* cpf, uint64_t* out) {
+    if (!cpf) return 0;
+    uint64_t v = 0;
+    int n = 0;
+    for (; *cpf && n < CPF_KEY_CAP - 1; cpf++) {
+        char c = *cpf;
+        if (c == '.' || c == '-' || c == '/' || c == ' ' ||
+            c == '\t' || c == '\n' || c == '\r')
+            continue;
+        unsigned digit = (unsigned)(unsigned char)c - '0';
+        if (digit > 9) return 0;
+        v = v * 10 + digit;
+        n++;
+    }
+    if (n == 0) return 0;
+    *out = ((uint64_t)n << 56) | v; /* 14 dígitos < 2^47: não invade o tamanho */
+    return 1;
+}
+
+void cpf_unpack_key(uint64_t key, char out[CPF_KEY_CAP]) {
+    int n = (int)(key >> 56);
+    uint64_t v = key & ((1ULL << 56) - 1);
+    if (n > CPF_KEY_CAP - 1) n = CPF_KEY_CAP - 1;
+    out[n] = '\0';
+    while (n-- > 0) {
+        out[n] = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+
+/*
+ * Uma passada só: separadores (os mesmos de cpf_normalize_key) são pulados,
+ * os dígitos vão para d[] e formam a chave, e os dois somatórios dos DVs
+ * são feitos sem divisão. Mesmo resultado de cpf_pack_key + conferência.
+ */
+CpfStatus cpf_canonicalize(const char* cpf, uint64_t* key) {
+    if (!cpf) return CPF_ERR_FORMAT;
+    int d[11];
+    int n = 0;
+    uint64_t v = 0;
+    for (; *cpf; cpf++) {
+        char c = *cpf;
+        if (c == '.' || c == '-' || c == '/' || c == ' ' ||
+            c == '\t' || c == '\n' || c == '\r')
+            continue;
+        unsigned digit = (unsigned)(unsigned char)c - '0';
+        if (digit > 9 || n == 11) return CPF_ERR_FORMAT;
+        d[n++] = (int)digit;
+        v = v * 10 + digit;
+    }
+    if (n != 11) return CPF_ERR_FORMAT;
+
+    int s1 = 0, s2 = 0, diff = 0;
+    for (int i = 0; i < 9; i++) {
+        s1 += d[i] * (10 - i);
+        s2 += d[i] * (11 - i);
+        diff |= d[i] ^ d[0];
+    }
+    int dv1 = s1 * 10 % 11 % 10;   /* resto 10 vira 0 */
+    s2 += dv1 * 2;
+    int dv2 = s2 * 10 % 11 % 10;
+    diff |= (d[9] ^ d[0]) | (d[10] ^ d[0]);
+    if (!diff || dv1 != d[9] || dv2 != d[10]) return CPF_ERR_CHECK;
+
+    if (key) *key = ((uint64_t)11 << 56) | v;
+    return CPF_OK;
+}
+
+const char* cpf_strerror(CpfStatus st) {
+    switch (st) {
+        case CPF_OK:         return "ok";
+        case CPF_ERR_FORMAT: return "cpf deve ter 11 dígitos.";
+        case CPF_ERR_CHECK:  return "cpf com dígito verificador inválido.";
+    }
+    return "cpf inválido.";
+}
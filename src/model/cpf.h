@@ -0,0 +1,44 @@
+#ifndef CPF_H
+#define CPF_H
+
+#include <stdint.h>  /* uint64_t */
+
+/*
+  CPF: canonicalização, dígitos verificadores e chave compacta de 64 bits.
+
+  O texto digitado ("111.444.777-35", "11144477735", " 111 444 777 35 ")
+  vira UMA chave inteira: o valor decimal dos dígitos nos bits baixos e a
+  quantidade de dígitos nos 8 bits altos (assim "011" e "11" continuam
+  diferentes e a chave nunca é 0). Índices comparam essa chave com uma
+  instrução em vez de strcmp byte a byte.
+*/
+
+/* Tamanho máximo da chave normalizada em texto (cabe no cpf[15] do Patient). */
+#define CPF_KEY_CAP 15
+
+typedef enum {
+    CPF_OK = 0,
+    CPF_ERR_FORMAT,  // não tem exatamente 11 dígitos (após tirar pontuação)
+    CPF_ERR_CHECK    // dígitos verificadores não conferem (ou todos iguais)
+} CpfStatus;
+
+/* Normaliza um CPF para chave: remove '.', '-', '/' e espaços.
+   Returns: 1 se sobrou algo na chave, 0 se vazia/inválida. */
+int cpf_normalize_key(const char* cpf, char out[CPF_KEY_CAP]);
+
+/* Chave compacta da forma normalizada (1..14 dígitos, sem checar DV).
+   Returns: 1 se a chave normalizada tem só dígitos, 0 caso contrário. */
+int cpf_pack_key(const char* cpf, uint64_t* out);
+
+/* Inverso de cpf_pack_key: escreve a chave normalizada (com zeros à esquerda). */
+void cpf_unpack_key(uint64_t key, char out[CPF_KEY_CAP]);
+
+/* Forma canônica de um CPF de cadastro: 11 dígitos com os dois dígitos
+   verificadores corretos. Em CPF_OK, *key recebe a chave compacta
+   (a mesma de cpf_pack_key). */
+CpfStatus cpf_canonicalize(const char* cpf, uint64_t* key);
+
+/* Mensagem curta para o status (cabe nos buffers de erro de 64 bytes). */
+const char* cpf_strerror(CpfStatus st);
+
+#endif /* CPF_H */
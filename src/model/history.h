@@ -1,11 +1,15 @@
 #ifndef HISTORY_H
 #define HISTORY_H
 
+#include <stdint.h>
 #include "model/patient.h" // Import da struct de pacientes
 
 /*
   Define o tipo de ação e o registro do histórico.
-  Snapshot por valor para permitir "desfazer" mesmo após liberar a cópia da fila.
+  Registro compacto (32 bytes): em vez de copiar o Patient inteiro (~340 bytes)
+  e um timestamp em texto, guarda só um handle para o paciente no cadastro,
+  o horário em segundos desde a época e, para o "desfazer", o nível e a
+  chegada na fila.
 */
 
 typedef enum{
@@ -13,9 +17,11 @@ typedef enum{
 } HistoryAction;
 
 typedef struct {
-    char timestamp[20]; // YYYY-MM-DD HH:MM
-    HistoryAction action; // Tipo de ação
-    Patient patient;    // Paciente
+    int64_t timestamp;       // Segundos desde a época (formatado só ao exibir)
+    const Patient* patient;  // Handle: paciente dentro da PatientList (estável)
+    HistoryAction action;    // Tipo de ação
+    unsigned char level;     // Prioridade (1..3) da fila de onde saiu => onde voltar no undo
+    uint64_t enqueued_ns;    // Chegada na fila (relógio da fila; 0 = desconhecida)
 } HistoryRecord;
 
-#endif
\ No newline at end of file
+#endif
@@ -1,7 +1,17 @@
 #include "patient.h"
+#include "cpf.h"
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#include "util/thread_pool.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* Registros por pedaço nas versões em lote (abaixo disso não compensa
+   acordar as threads do pool). */
+#define PATIENT_BATCH_CHUNK 4096
 
 /*
  * Retorna 1 se a string for NULL, vazia ou apenas espaços; caso contrário 0.
@@ -16,6 +26,40 @@ static int is_blank(const char* s) {
     return 1;
 }
 
+/*
+ * is_blank para um campo de tamanho fixo (name[100]): com SSE2 olha 16
+ * bytes por vez. Em cada bloco, "conteúdo" = byte que não é espaço
+ * (' ', \t..\r) nem '\0'; o campo é branco se nenhum conteúdo aparece
+ * antes do primeiro '\0'. O fim do vetor conta como terminador.
+ */
+static int field_blank(const char* f, size_t cap) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    for (; i + 16 <= cap; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(f + i));
+        __m128i t = _mm_sub_epi8(x, tab);  /* \t..\r => 0..4 (sem sinal) */
+        __m128i ws = _mm_or_si128(_mm_cmpeq_epi8(x, space),
+                                  _mm_cmpeq_epi8(_mm_min_epu8(t, four), t));
+        unsigned nul = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero));
+        unsigned content = ~((unsigned)_mm_movemask_epi8(ws) | nul) & 0xFFFFu;
+        if (nul) return (content & ((nul & (0u - nul)) - 1u)) == 0;
+        if (content) return 0;
+    }
+#endif
+    for (; i < cap && f[i]; i++)
+        if (!isspace((unsigned char)f[i])) return 0;
+    return 1;
+}
+
+/* Sem desvio: devolve code se bad (0/1), senão keep. */
+static unsigned pick(unsigned bad, unsigned code, unsigned keep) {
+    return keep ^ ((keep ^ code) & (0u - bad));
+}
+
 /*
  * Normalização de campos do Patient.
  * Objetivo: padronizar valores para reduzir falhas de validação/negócio.
@@ -31,6 +75,56 @@ void patient_normalize(Patient* p) {
         p->gender = (char)toupper((unsigned char)p->gender);
 }
 
+/*
+ * Regras de patient_validate, em forma de código.
+ *
+ * As faixas (id, age, gender, priority) são comparações sem desvio,
+ * combinadas por pick() de trás para a frente: o código final é o da
+ * PRIMEIRA regra violada, igual à ordem dos ifs originais. Só os campos
+ * de texto (name, cpf) precisam de laço.
+ */
+PatientError patient_check(const Patient* p) {
+    if (!p) return PATIENT_ERR_NULL;
+
+    unsigned code = PATIENT_OK;
+    if (is_blank(p->cpf)) {
+        code = PATIENT_ERR_CPF_BLANK;
+    } else {
+        CpfStatus st = cpf_canonicalize(p->cpf, NULL);
+        code = st == CPF_ERR_FORMAT ? PATIENT_ERR_CPF_FORMAT
+             : st == CPF_ERR_CHECK  ? PATIENT_ERR_CPF_CHECK : PATIENT_OK;
+    }
+
+    unsigned bad_priority = (unsigned)(p->priority - 1) > 2u;
+    unsigned bad_gender = (unsigned)(p->gender != 'M') & (unsigned)(p->gender != 'F');
+    unsigned bad_age = (unsigned)p->age > 130u;
+    unsigned bad_name = (unsigned)field_blank(p->name, sizeof p->name);
+    unsigned bad_id = (unsigned)(p->id <= 0);
+
+    code = pick(bad_priority, PATIENT_ERR_PRIORITY, code);
+    code = pick(bad_gender, PATIENT_ERR_GENDER, code);
+    code = pick(bad_age, PATIENT_ERR_AGE, code);
+    code = pick(bad_name, PATIENT_ERR_NAME, code);
+    code = pick(bad_id, PATIENT_ERR_ID, code);
+    return (PatientError)code;
+}
+
+const char* patient_strerror(PatientError err) {
+    switch (err) {
+        case PATIENT_OK:             return "ok";
+        case PATIENT_ERR_NULL:       return "Paciente NULL.";
+        case PATIENT_ERR_ID:         return "id deve ser > 0.";
+        case PATIENT_ERR_NAME:       return "name vazio.";
+        case PATIENT_ERR_AGE:        return "age fora de faixa [0..130].";
+        case PATIENT_ERR_GENDER:     return "gender deve ser 'M' ou 'F'.";
+        case PATIENT_ERR_PRIORITY:   return "priority deve ser 1..3.";
+        case PATIENT_ERR_CPF_BLANK:  return "cpf vazio.";
+        case PATIENT_ERR_CPF_FORMAT: return cpf_strerror(CPF_ERR_FORMAT);
+        case PATIENT_ERR_CPF_CHECK:  return cpf_strerror(CPF_ERR_CHECK);
+    }
+    return "registro inválido.";
+}
+
 /*
  * Validação de domínio do Patient.
  *
@@ -42,48 +136,56 @@ void patient_normalize(Patient* p) {
  * Returns:
  *   1 se válido, 0 caso inválido (errbuf recebe motivo quando possível).
  *
- * Regras atuais:
+ * Regras atuais (nesta ordem; vale a primeira violada):
  *   - id > 0
  *   - name não vazio/branco
  *   - age no intervalo [0..130]
  *   - gender ∈ {'M','F'}
  *   - priority ∈ {1,2,3}
- *   - cpf não vazio/branco (não valida dígitos/algoritmo ainda)
+ *   - cpf com 11 dígitos (pontuação livre) e dígitos verificadores
+ *     corretos (ver model/cpf.h)
  *
  * Observações:
  *   - errbuf é “melhor esforço”: mensagem curta e objetiva.
- *   - Validação completa de CPF (dígitos/algoritmo) pode ser adicionada
- *     futuramente sem alterar a assinatura.
  */
 int patient_validate(const Patient* p, char* errbuf, size_t errcap) {
-    if (!p) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "Paciente NULL.");
-        return 0;
-    }
-    if (p->id <= 0) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "id deve ser > 0.");
-        return 0;
-    }
-    if (is_blank(p->name)) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "name vazio.");
-        return 0;
-    }
-    if (p->age < 0 || p->age > 130) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "age fora de faixa [0..130].");
-        return 0;
-    }
-    if (!(p->gender == 'M' || p->gender == 'F')) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "gender deve ser 'M' ou 'F'.");
-        return 0;
-    }
-    if (p->priority < 1 || p->priority > 3) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "priority deve ser 1..3.");
-        return 0;
-    }
-    /* CPF: apenas obriga não-vazio por enquanto */
-    if (is_blank(p->cpf)) {
-        if (errbuf && errcap) snprintf(errbuf, errcap, "cpf vazio.");
-        return 0;
+    PatientError err = patient_check(p);
+    if (err == PATIENT_OK) return 1;
+    if (errbuf && errcap) snprintf(errbuf, errcap, "%s", patient_strerror(err));
+    return 0;
+}
+
+/* ---------- lote ---------- */
+
+typedef struct {
+    const Patient* ps;
+    uint8_t* codes;
+} ValidateJob;
+
+static void validate_range(void* ctx, size_t begin, size_t end) {
+    ValidateJob* job = ctx;
+    for (size_t i = begin; i < end; i++) job->codes[i] = (uint8_t)patient_check(&job->ps[i]);
+}
+
+size_t patient_validate_batch(const Patient* ps, size_t n, uint8_t* errcodes) {
+    if (!ps || !errcodes) return n;
+    ValidateJob job = { ps, errcodes };
+    thread_pool_parallel_for(thread_pool_default(), n, PATIENT_BATCH_CHUNK, validate_range, &job);
+    size_t rejected = 0;
+    for (size_t i = 0; i < n; i++) rejected += errcodes[i] != PATIENT_OK;
+    return rejected;
+}
+
+/* Maiúscula do gender sem desvio: subtrai 32 só de 'a'..'z'. */
+static void normalize_range(void* ctx, size_t begin, size_t end) {
+    Patient* ps = ctx;
+    for (size_t i = begin; i < end; i++) {
+        unsigned char g = (unsigned char)ps[i].gender;
+        ps[i].gender = (char)(g - 32u * ((unsigned char)(g - 'a') < 26u));
     }
-    return 1;
+}
+
+void patient_normalize_batch(Patient* ps, size_t n) {
+    if (!ps) return;
+    thread_pool_parallel_for(thread_pool_default(), n, PATIENT_BATCH_CHUNK, normalize_range, ps);
 }
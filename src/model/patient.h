@@ -2,6 +2,7 @@
 #define PATIENT_H
 
 #include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint8_t */
 
 typedef struct {
     int id;
@@ -13,11 +14,38 @@ typedef struct {
     int priority;          /* 1=Alta, 2=Média, 3=Baixa */
 } Patient;
 
+/* Motivo de recusa (primeira regra violada, na ordem de patient_validate). */
+typedef enum {
+    PATIENT_OK = 0,
+    PATIENT_ERR_NULL,
+    PATIENT_ERR_ID,
+    PATIENT_ERR_NAME,
+    PATIENT_ERR_AGE,
+    PATIENT_ERR_GENDER,
+    PATIENT_ERR_PRIORITY,
+    PATIENT_ERR_CPF_BLANK,
+    PATIENT_ERR_CPF_FORMAT,
+    PATIENT_ERR_CPF_CHECK
+} PatientError;
+
 /* Valida regras de domínio (sem I/O).
    Returns: 1 se válido, 0 se inválido. Se errbuf != NULL, escreve mensagem. */
 int patient_validate(const Patient* p, char* errbuf, size_t errcap);
 
+/* Mesmas regras, devolvendo o código em vez da mensagem. */
+PatientError patient_check(const Patient* p);
+
+/* Mensagem de patient_validate para o código. */
+const char* patient_strerror(PatientError err);
+
 /* Normaliza campos simples (ex.: uppercase do gender). */
 void patient_normalize(Patient* p);
 
+/* Versões em lote (importação em massa). Lotes grandes são divididos
+   entre as threads do pool padrão (util/thread_pool.h).
+   errcodes[i] recebe o PatientError de ps[i] (o mesmo de patient_check).
+   Returns: quantos registros foram recusados. */
+size_t patient_validate_batch(const Patient* ps, size_t n, uint8_t* errcodes);
+void patient_normalize_batch(Patient* ps, size_t n);
+
 #endif
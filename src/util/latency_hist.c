@@ -0,0 +1,85 @@
+/*
+ Módulo: latency_hist.c
+ Papel:  Histograma log-linear de durações (tempo de espera na fila) e o
+         relógio monotônico usado para medi-las.
+
+ Índice do balde para v >= 32: com m = posição do bit mais alto de v, o
+ deslocamento s = m - 4 deixa v >> s em [16, 31]; o balde é
+ 32 + (s - 1) * 16 + ((v >> s) - 16). Largura do balde = 2^s <= v / 16.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <string.h>
+#include <time.h>
+#include "latency_hist.h"
+
+uint64_t latency_now_ns(void) {
+    struct timespec ts;
+#if defined(_WIN32)
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static unsigned high_bit(uint64_t v) {
+#if defined(__GNUC__)
+    return 63u - (unsigned)__builtin_clzll(v);
+#else
+    unsigned m = 0;
+    while (v >>= 1) m++;
+    return m;
+#endif
+}
+
+static unsigned bucket_of(uint64_t v) {
+    if (v < LATENCY_HIST_SUB) return (unsigned)v;
+    unsigned shift = high_bit(v) - (LATENCY_HIST_SUB_BITS - 1);
+    return LATENCY_HIST_SUB + (shift - 1) * LATENCY_HIST_HALF
+         + (unsigned)(v >> shift) - LATENCY_HIST_HALF;
+}
+
+// Maior valor que cai no balde b
+static uint64_t bucket_high(unsigned b) {
+    if (b < LATENCY_HIST_SUB) return b;
+    unsigned k = b - LATENCY_HIST_SUB;
+    unsigned shift = k / LATENCY_HIST_HALF + 1;
+    uint64_t low = (uint64_t)(k % LATENCY_HIST_HALF + LATENCY_HIST_HALF) << shift;
+    return low + ((uint64_t)1 << shift) - 1;
+}
+
+void latency_hist_reset(LatencyHist* h) {
+    memset(h, 0, sizeof *h);
+}
+
+void latency_hist_record(LatencyHist* h, uint64_t ns) {
+    h->counts[bucket_of(ns)]++;
+    h->total++;
+    if (ns > h->max) h->max = ns;
+}
+
+void latency_hist_merge(LatencyHist* dst, const LatencyHist* src) {
+    for (unsigned b = 0; b < LATENCY_HIST_BUCKETS; b++) dst->counts[b] += src->counts[b];
+    dst->total += src->total;
+    if (src->max > dst->max) dst->max = src->max;
+}
+
+uint64_t latency_hist_percentile(const LatencyHist* h, double q) {
+    if (!h->total) return 0;
+    if (q >= 1.0) return h->max;
+    uint64_t rank = (uint64_t)(q * (double)h->total);
+    if ((double)rank < q * (double)h->total || rank == 0) rank++;  // ceil, >= 1
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < LATENCY_HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint64_t v = bucket_high(b);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
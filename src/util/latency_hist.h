@@ -0,0 +1,43 @@
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>  /* uint64_t */
+
+/*
+  Histograma log-linear (estilo HDR) de durações em nanossegundos.
+
+  Valores abaixo de 32 ns têm um balde cada; daí para cima cada potência de
+  2 é dividida em 16 baldes iguais. Todo o intervalo de 64 bits cabe em
+  LATENCY_HIST_BUCKETS contadores fixos: registrar é achar o bit mais alto
+  e somar 1, sem alocação. Os percentis saem com erro relativo < 1/16
+  (nunca abaixo do valor real).
+*/
+
+#define LATENCY_HIST_SUB_BITS 5
+#define LATENCY_HIST_SUB      (1u << LATENCY_HIST_SUB_BITS)  /* baldes exatos no início */
+#define LATENCY_HIST_HALF     (LATENCY_HIST_SUB / 2)         /* baldes por potência de 2 */
+#define LATENCY_HIST_BUCKETS  (LATENCY_HIST_SUB + (64 - LATENCY_HIST_SUB_BITS) * LATENCY_HIST_HALF)
+
+typedef struct {
+    uint64_t counts[LATENCY_HIST_BUCKETS];
+    uint64_t total;  // amostras registradas
+    uint64_t max;    // maior valor exato
+} LatencyHist;
+
+/* Relógio monotônico em ns (origem arbitrária; só diferenças valem). */
+uint64_t latency_now_ns(void);
+
+/* Zera o histograma. */
+void latency_hist_reset(LatencyHist* h);
+
+/* Registra uma duração (ns). O(1), sem alocação. */
+void latency_hist_record(LatencyHist* h, uint64_t ns);
+
+/* Soma src em dst (ex.: histogramas por thread juntados no fim). */
+void latency_hist_merge(LatencyHist* dst, const LatencyHist* src);
+
+/* Valor no percentil q (0..1]: o maior valor do balde que contém a amostra
+   de ordem ceil(q * total), limitado ao máximo exato. 0 se vazio. */
+uint64_t latency_hist_percentile(const LatencyHist* h, double q);
+
+#endif /* LATENCY_HIST_H */
@@ -0,0 +1,80 @@
+#include "line_reader.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_READER_DEFAULT_CAP (1u << 20)
+
+int line_reader_open(LineReader* r, FILE* in, size_t cap) {
+    if (!r || !in) return 0;
+    if (cap < 2) cap = LINE_READER_DEFAULT_CAP;
+    r->buf = malloc(cap);
+    if (!r->buf) return 0;
+    r->in = in;
+    r->cap = cap;
+    r->start = r->end = 0;
+    r->eof = 0;
+    r->line_no = 0;
+    r->truncated = 0;
+    return 1;
+}
+
+/* Move o resto não consumido para o início e completa o buffer com fread. */
+static void refill(LineReader* r) {
+    size_t rest = r->end - r->start;
+    if (r->start > 0 && rest > 0) memmove(r->buf, r->buf + r->start, rest);
+    r->start = 0;
+    r->end = rest;
+    /* Reserva 1 byte para o '\0' da última linha sem '\n' */
+    size_t room = r->cap - 1 - r->end;
+    if (room > 0 && !r->eof) {
+        size_t got = fread(r->buf + r->end, 1, room, r->in);
+        if (got < room) r->eof = 1;
+        r->end += got;
+    }
+}
+
+/* Finaliza a linha [start, stop) no lugar e avança o cursor para next. */
+static char* finish_line(LineReader* r, size_t stop, size_t next, size_t* len) {
+    char* line = r->buf + r->start;
+    size_t n = stop - r->start;
+    if (n > 0 && line[n - 1] == '\r') n--;
+    line[n] = '\0';
+    r->start = next;
+    r->line_no++;
+    if (len) *len = n;
+    return line;
+}
+
+char* line_reader_next(LineReader* r, size_t* len) {
+    if (!r || !r->buf) return NULL;
+    r->truncated = 0;
+
+    for (int refilled = 0;; refilled = 1) {
+        char* nl = memchr(r->buf + r->start, '\n', r->end - r->start);
+        if (nl) {
+            size_t stop = (size_t)(nl - r->buf);
+            return finish_line(r, stop, stop + 1, len);
+        }
+        if (r->eof) {
+            if (r->start == r->end) return NULL;
+            return finish_line(r, r->end, r->end, len); /* última linha sem '\n' */
+        }
+        if (refilled && r->start == 0 && r->end == r->cap - 1) {
+            /* Linha maior que o buffer: devolve o pedaço e descarta o resto */
+            size_t stop = r->end;
+            char* line = finish_line(r, stop, stop, len);
+            int c;
+            while ((c = fgetc(r->in)) != EOF && c != '\n') { /* descarta */ }
+            if (c == EOF) r->eof = 1;
+            r->truncated = 1;
+            return line;
+        }
+        refill(r);
+    }
+}
+
+void line_reader_close(LineReader* r) {
+    if (!r) return;
+    free(r->buf);
+    r->buf = NULL;
+}
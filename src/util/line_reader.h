@@ -0,0 +1,34 @@
+#ifndef LINE_READER_H
+#define LINE_READER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+  Leitor de linhas com buffer grande (fread em blocos).
+
+  Diferente de read_line/fgets, não copia a linha: devolve um ponteiro para
+  dentro do buffer interno, já terminado em '\0' (sem '\n' nem '\r').
+  O ponteiro só vale até a próxima chamada de line_reader_next.
+*/
+
+typedef struct {
+    FILE* in;
+    char* buf;
+    size_t cap;       // capacidade do buffer
+    size_t start;     // início da próxima linha não consumida
+    size_t end;       // fim dos dados válidos
+    int eof;          // 1 quando fread já chegou ao fim
+    size_t line_no;   // número da última linha devolvida (1-based)
+    int truncated;    // 1 se a última linha excedeu o buffer e foi cortada
+} LineReader;
+
+/* Returns: 1 em sucesso, 0 se faltar memória. cap = 0 usa o padrão (1 MiB). */
+int line_reader_open(LineReader* r, FILE* in, size_t cap);
+
+/* Próxima linha ou NULL no fim. *len (opcional) recebe o tamanho. */
+char* line_reader_next(LineReader* r, size_t* len);
+
+void line_reader_close(LineReader* r);
+
+#endif /* LINE_READER_H */
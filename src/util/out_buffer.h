@@ -0,0 +1,59 @@
+#ifndef OUT_BUFFER_H
+#define OUT_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+  Camada de saída com buffer grande e reutilizável.
+
+  Os textos e números são copiados/formatados direto no buffer (sem printf)
+  e cada out_flush faz UM write(2) com tudo o que acumulou. Usado pelas
+  listagens (cadastro, fila, histórico) e pelas respostas do modo batch.
+
+  Mistura com stdio: antes de escrever no fd 1, out_flush dá fflush(stdout),
+  então o que já foi impresso com printf/puts sai antes. Quem imprime com
+  stdio DEPOIS de usar o buffer deve chamar out_flush primeiro.
+
+  fd < 0: buffer só em memória (respostas do servidor). Cheio, ele dobra
+  em vez de descarregar; out_flush não faz nada e o dono envia
+  buf[0, len) por conta própria.
+*/
+
+#define OUT_DEFAULT_CAP (1u << 20)   /* 1 MiB */
+
+/* limit de "tudo" no modo página */
+#define OUT_ALL SIZE_MAX
+
+typedef struct {
+    int fd;          // descritor de destino
+    char* buf;
+    size_t cap;
+    size_t len;      // bytes pendentes
+    size_t flushes;  // write(2) feitos (estatística)
+    int error;       // 1 após uma falha de escrita (o resto é descartado)
+} OutBuffer;
+
+/* Returns: 1 em sucesso, 0 se faltar memória. cap = 0 usa OUT_DEFAULT_CAP.
+   fd < 0 => só em memória (ver acima). */
+int out_open(OutBuffer* o, int fd, size_t cap);
+
+/* Descarrega e libera o buffer (não fecha o fd). */
+void out_close(OutBuffer* o);
+
+/* Buffer compartilhado da saída padrão (criado no primeiro uso). */
+OutBuffer* out_stdout(void);
+
+/* Escreve tudo o que está pendente. Returns: 1 ok, 0 erro de escrita. */
+int out_flush(OutBuffer* o);
+
+void out_write(OutBuffer* o, const char* data, size_t n);
+void out_str(OutBuffer* o, const char* s);
+void out_char(OutBuffer* o, char c);
+void out_int(OutBuffer* o, int v);
+void out_u64(OutBuffer* o, uint64_t v);
+
+/* Fim (exclusivo) da página [offset, offset + limit), sem estourar size_t. */
+size_t out_page_end(size_t offset, size_t limit);
+
+#endif /* OUT_BUFFER_H */
@@ -0,0 +1,488 @@
+/*
+ Módulo: patient_import.c
+ Papel:  Carga em massa do cadastro a partir de CSV/JSONL (migração noturna
+         do sistema antigo), sem passar pelo console campo a campo.
+
+ Caminho de cada linha:
+   LineReader (ponteiro para dentro do buffer de 1 MiB)
+     -> parser marca os campos como Span (início, tamanho, tipo de escape)
+     -> campos de texto decodificados direto no Patient de destino (um
+        lote de IMPORT_BATCH linhas)
+     -> patient_normalize_batch / patient_validate_batch (lote inteiro,
+        dividido entre as threads do pool)
+     -> dedupe pelo índice de CPF -> insert_patient, na ordem do arquivo
+ Nenhuma alocação por linha: o lote é alocado uma vez por importação.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "patient_import.h"
+#include "util/line_reader.h"
+
+enum {
+    F_ID, F_NAME, F_CPF, F_AGE, F_GENDER, F_CONDITION, F_PRIORITY, F_COUNT,
+    F_IGNORE = -1
+};
+
+#define MAX_CSV_COLUMNS 32
+
+/* Linhas parseadas antes de validar/inserir (~3 MiB de Patient) */
+#define IMPORT_BATCH 8192
+
+/* Como o texto do campo está escrito na linha */
+typedef enum {
+    SPAN_RAW,     // literal
+    SPAN_CSV,     // entre aspas CSV ("" => ")
+    SPAN_JSON     // string JSON (\" \\ \n \uXXXX ...)
+} SpanKind;
+
+typedef struct {
+    const char* s;
+    size_t n;
+    SpanKind kind;
+} Span;
+
+typedef struct {
+    const ImportOptions* opt;
+    const ImportSink* sink;
+    ImportStats* stats;
+    PatientList* list;
+    int next_id;
+    /* CSV: coluna -> campo */
+    char delim;
+    int columns;
+    int column_field[MAX_CSV_COLUMNS];
+    /* Lote pendente: linha i vem de lines[i]; errs[i] != NULL => erro de parse */
+    Patient* batch;
+    uint8_t* codes;
+    size_t* lines;
+    const char** errs;
+    size_t pending;
+} Importer;
+
+/* ---------- nomes de campo ---------- */
+
+static int name_eq(const char* s, size_t n, const char* lit) {
+    size_t i = 0;
+    for (; i < n && lit[i]; i++)
+        if (tolower((unsigned char)s[i]) != (unsigned char)lit[i]) return 0;
+    return i == n && lit[i] == '\0';
+}
+
+static int field_of(const char* s, size_t n) {
+    static const struct { const char* name; int field; } aliases[] = {
+        {"id", F_ID},
+        {"name", F_NAME}, {"nome", F_NAME},
+        {"cpf", F_CPF},
+        {"age", F_AGE}, {"idade", F_AGE},
+        {"gender", F_GENDER}, {"sexo", F_GENDER},
+        {"condition", F_CONDITION}, {"condicao", F_CONDITION}, {"condição", F_CONDITION},
+        {"priority", F_PRIORITY}, {"prioridade", F_PRIORITY},
+    };
+    for (size_t i = 0; i < sizeof aliases / sizeof aliases[0]; i++)
+        if (name_eq(s, n, aliases[i].name)) return aliases[i].field;
+    return F_IGNORE;
+}
+
+/* ---------- decodificação dos campos ---------- */
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = (char)tolower((unsigned char)c);
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* Codifica cp em UTF-8 em out (até 3 bytes: só BMP). Returns: bytes. */
+static size_t utf8_encode(unsigned cp, char out[3]) {
+    if (cp < 0x80) { out[0] = (char)cp; return 1; }
+    if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    out[0] = (char)(0xE0 | (cp >> 12));
+    out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    out[2] = (char)(0x80 | (cp & 0x3F));
+    return 3;
+}
+
+/*
+ Copia o campo para dst (capacidade cap, sempre termina em '\0'),
+ resolvendo os escapes do formato. Texto além de cap-1 é truncado.
+*/
+static void span_copy(const Span* sp, char* dst, size_t cap) {
+    size_t o = 0;
+    if (sp->kind == SPAN_RAW) {
+        o = sp->n < cap - 1 ? sp->n : cap - 1;
+        memcpy(dst, sp->s, o);
+        dst[o] = '\0';
+        return;
+    }
+    for (size_t i = 0; i < sp->n && o < cap - 1; i++) {
+        char c = sp->s[i];
+        if (sp->kind == SPAN_CSV) {
+            if (c == '"' && i + 1 < sp->n && sp->s[i + 1] == '"') i++;
+            dst[o++] = c;
+            continue;
+        }
+        if (c != '\\' || i + 1 >= sp->n) { dst[o++] = c; continue; }
+        c = sp->s[++i];
+        switch (c) {
+            case 'n': dst[o++] = '\n'; break;
+            case 't': dst[o++] = '\t'; break;
+            case 'r': dst[o++] = '\r'; break;
+            case 'b': dst[o++] = '\b'; break;
+            case 'f': dst[o++] = '\f'; break;
+            case 'u': {
+                unsigned cp = 0;
+                int ok = i + 4 < sp->n;
+                for (int k = 1; ok && k <= 4; k++) {
+                    int h = hex_value(sp->s[i + k]);
+                    if (h < 0) ok = 0;
+                    else cp = cp * 16 + (unsigned)h;
+                }
+                if (!ok) { dst[o++] = '?'; break; }
+                i += 4;
+                if (cp >= 0xD800 && cp <= 0xDFFF) cp = '?'; /* fora do BMP: não suportado */
+                char enc[3];
+                size_t k = utf8_encode(cp, enc);
+                if (o + k > cap - 1) { i = sp->n; break; }
+                memcpy(dst + o, enc, k);
+                o += k;
+                break;
+            }
+            default: dst[o++] = c; /* \" \\ \/ */
+        }
+    }
+    dst[o] = '\0';
+}
+
+static int span_int(const Span* sp, int* out) {
+    char tmp[24];
+    span_copy(sp, tmp, sizeof tmp);
+    char* p = tmp;
+    while (*p == ' ') p++;
+    if (!*p) return 0;
+    char* end;
+    long v = strtol(p, &end, 10);
+    while (*end == ' ') end++;
+    if (*end != '\0' || v < -2147483647L || v > 2147483647L) return 0;
+    *out = (int)v;
+    return 1;
+}
+
+/* Prioridade numérica (1..3) ou em texto, como no sistema antigo. */
+static int span_priority(const Span* sp, int* out) {
+    if (span_int(sp, out)) return 1;
+    char tmp[16];
+    span_copy(sp, tmp, sizeof tmp);
+    size_t n = strlen(tmp);
+    if (name_eq(tmp, n, "urgente") || name_eq(tmp, n, "alta"))  { *out = 1; return 1; }
+    if (name_eq(tmp, n, "media") || name_eq(tmp, n, "média"))   { *out = 2; return 1; }
+    if (name_eq(tmp, n, "normal") || name_eq(tmp, n, "baixa"))  { *out = 3; return 1; }
+    return 0;
+}
+
+/* Aplica um campo ao paciente. Returns: NULL ok, ou mensagem de erro. */
+static const char* apply_field(Patient* p, int field, const Span* sp, unsigned* seen) {
+    if (field == F_IGNORE) return NULL;
+    if (sp->n == 0) return NULL; /* vazio = ausente */
+    *seen |= 1u << field;
+    switch (field) {
+        case F_ID:        return span_int(sp, &p->id) ? NULL : "id inválido";
+        case F_NAME:      span_copy(sp, p->name, sizeof p->name); return NULL;
+        case F_CPF:       span_copy(sp, p->cpf, sizeof p->cpf); return NULL;
+        case F_AGE:       return span_int(sp, &p->age) ? NULL : "idade inválida";
+        case F_GENDER:    p->gender = sp->s[0]; return NULL;
+        case F_CONDITION: span_copy(sp, p->condition, sizeof p->condition); return NULL;
+        case F_PRIORITY:  return span_priority(sp, &p->priority) ? NULL : "prioridade inválida";
+    }
+    return NULL;
+}
+
+/* ---------- parsers de linha ---------- */
+
+/* Próximo campo CSV a partir de *pos. Returns: NULL ok, ou erro. */
+static const char* csv_next(const char** pos, char delim, Span* sp) {
+    const char* s = *pos;
+    while (*s == ' ' || *s == '\t') s++;
+    if (*s == '"') {
+        const char* start = ++s;
+        int escaped = 0;
+        for (;;) {
+            if (*s == '\0') return "aspas não fechadas";
+            if (*s == '"') {
+                if (s[1] == '"') { escaped = 1; s += 2; continue; }
+                break;
+            }
+            s++;
+        }
+        sp->s = start;
+        sp->n = (size_t)(s - start);
+        sp->kind = escaped ? SPAN_CSV : SPAN_RAW;
+        s++;
+        while (*s == ' ' || *s == '\t') s++;
+        if (*s != delim && *s != '\0') return "texto após aspas";
+    } else {
+        const char* start = s;
+        while (*s != delim && *s != '\0') s++;
+        const char* stop = s;
+        while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t')) stop--;
+        sp->s = start;
+        sp->n = (size_t)(stop - start);
+        sp->kind = SPAN_RAW;
+    }
+    *pos = *s == delim ? s + 1 : s;
+    return NULL;
+}
+
+static int parse_csv_header(Importer* im, const char* line) {
+    /* Separador: o que aparecer mais no cabeçalho entre ',' e ';' */
+    size_t commas = 0, semis = 0;
+    for (const char* c = line; *c; c++) {
+        if (*c == ',') commas++;
+        else if (*c == ';') semis++;
+    }
+    im->delim = semis > commas ? ';' : ',';
+
+    unsigned seen = 0;
+    const char* pos = line;
+    /* Ignora BOM UTF-8 de planilhas */
+    if ((unsigned char)pos[0] == 0xEF && (unsigned char)pos[1] == 0xBB &&
+        (unsigned char)pos[2] == 0xBF)
+        pos += 3;
+    im->columns = 0;
+    while (*pos && im->columns < MAX_CSV_COLUMNS) {
+        Span sp;
+        if (csv_next(&pos, im->delim, &sp)) return 0;
+        int f = field_of(sp.s, sp.n);
+        if (f != F_IGNORE) seen |= 1u << f;
+        im->column_field[im->columns++] = f;
+    }
+    return (seen & (1u << F_NAME)) && (seen & (1u << F_CPF));
+}
+
+static const char* parse_csv_row(Importer* im, const char* line, Patient* p, unsigned* seen) {
+    const char* pos = line;
+    for (int col = 0;; col++) {
+        Span sp;
+        const char* err = csv_next(&pos, im->delim, &sp);
+        if (err) return err;
+        /* Colunas além do cabeçalho são ignoradas */
+        if (col < im->columns && (err = apply_field(p, im->column_field[col], &sp, seen)))
+            return err;
+        if (!*pos) return NULL;
+    }
+}
+
+static const char* skip_ws(const char* s) {
+    while (*s == ' ' || *s == '\t') s++;
+    return s;
+}
+
+/* String JSON começando em s (no '"'). Returns: ponteiro após o fechamento ou NULL. */
+static const char* json_string(const char* s, Span* sp) {
+    const char* start = ++s;
+    int escaped = 0;
+    while (*s != '"') {
+        if (*s == '\0') return NULL;
+        if (*s == '\\') {
+            escaped = 1;
+            if (*++s == '\0') return NULL;
+        }
+        s++;
+    }
+    sp->s = start;
+    sp->n = (size_t)(s - start);
+    sp->kind = escaped ? SPAN_JSON : SPAN_RAW;
+    return s + 1;
+}
+
+static const char* parse_jsonl_row(const char* line, Patient* p, unsigned* seen) {
+    const char* s = skip_ws(line);
+    if (*s != '{') return "esperado objeto JSON";
+    s = skip_ws(s + 1);
+    if (*s == '}') return NULL;
+    for (;;) {
+        Span key, val;
+        if (*s != '"' || !(s = json_string(s, &key))) return "chave JSON inválida";
+        s = skip_ws(s);
+        if (*s != ':') return "esperado ':'";
+        s = skip_ws(s + 1);
+        if (*s == '"') {
+            if (!(s = json_string(s, &val))) return "string JSON não fechada";
+        } else if (*s == '{' || *s == '[') {
+            return "valor aninhado não suportado";
+        } else {
+            const char* start = s;
+            while (*s && *s != ',' && *s != '}' && *s != ' ' && *s != '\t') s++;
+            val.s = start;
+            val.n = (size_t)(s - start);
+            val.kind = SPAN_RAW;
+            if (name_eq(val.s, val.n, "null")) val.n = 0;
+        }
+        /* Chaves com escape são raras: decodifica num buffer pequeno */
+        char kbuf[32];
+        span_copy(&key, kbuf, sizeof kbuf);
+        const char* err = apply_field(p, field_of(kbuf, strlen(kbuf)), &val, seen);
+        if (err) return err;
+
+        s = skip_ws(s);
+        if (*s == ',') { s = skip_ws(s + 1); continue; }
+        if (*s == '}') return *skip_ws(s + 1) ? "texto após o objeto" : NULL;
+        return "esperado ',' ou '}'";
+    }
+}
+
+/* ---------- importação ---------- */
+
+static void report(Importer* im, size_t line_no, const char* msg) {
+    im->stats->rejected++;
+    if (im->sink && im->sink->on_error) im->sink->on_error(im->sink->ctx, line_no, msg);
+}
+
+/* Parseia a linha para o próximo slot do lote (validação fica para flush_batch). */
+static void parse_row(Importer* im, const char* line, size_t line_no) {
+    size_t i = im->pending++;
+    Patient* p = &im->batch[i];
+    memset(p, 0, sizeof *p);
+    unsigned seen = 0;
+    im->stats->rows++;
+    im->lines[i] = line_no;
+
+    const char* err = im->opt->format == IMPORT_JSONL
+                    ? parse_jsonl_row(line, p, &seen)
+                    : parse_csv_row(im, line, p, &seen);
+    if (!err) {
+        if (!(seen & (1u << F_ID))) p->id = im->next_id++;
+        if (!(seen & (1u << F_GENDER))) p->gender = im->opt->default_gender;
+        if (!(seen & (1u << F_PRIORITY))) err = "prioridade ausente";
+    }
+    im->errs[i] = err;
+}
+
+/* Slot do lote que só carrega um erro (não conta como registro lido). */
+static void queue_error(Importer* im, size_t line_no, const char* msg) {
+    size_t i = im->pending++;
+    memset(&im->batch[i], 0, sizeof im->batch[i]);
+    im->lines[i] = line_no;
+    im->errs[i] = msg;
+}
+
+/* Valida o lote de uma vez e insere na ordem do arquivo. */
+static void flush_batch(Importer* im) {
+    size_t n = im->pending;
+    im->pending = 0;
+    if (n == 0) return;
+
+    patient_normalize_batch(im->batch, n);
+    patient_validate_batch(im->batch, n, im->codes);
+
+    for (size_t i = 0; i < n; i++) {
+        Patient* p = &im->batch[i];
+        if (im->errs[i]) { report(im, im->lines[i], im->errs[i]); continue; }
+        if (im->codes[i] != PATIENT_OK) {
+            report(im, im->lines[i], patient_strerror((PatientError)im->codes[i]));
+            continue;
+        }
+        /* insert_patient já recusa CPF repetido pelo índice; só no caminho de
+           erro uma segunda busca separa "duplicado" de "sem memória" */
+        if (!insert_patient(im->list, p)) {
+            report(im, im->lines[i], search_patient_by_CPF(im->list, p->cpf) ? "CPF duplicado"
+                                   : search_patient_by_id(im->list, p->id)   ? "id duplicado"
+                                                                             : "erro de memória");
+            continue;
+        }
+
+        im->stats->imported++;
+        if (im->sink && im->sink->on_patient)
+            im->sink->on_patient(im->sink->ctx, &im->list->head->data); /* inserido na cabeça */
+    }
+}
+
+static void free_batch(Importer* im) {
+    free(im->batch);
+    free(im->codes);
+    free(im->lines);
+    free(im->errs);
+}
+
+ImportOptions import_default_options(void) {
+    ImportOptions opt;
+    opt.format = IMPORT_CSV;
+    opt.default_gender = 0;
+    opt.next_id = 0;
+    return opt;
+}
+
+ImportFormat import_format_from_path(const char* path) {
+    const char* dot = path ? strrchr(path, '.') : NULL;
+    if (dot && (name_eq(dot, strlen(dot), ".jsonl") || name_eq(dot, strlen(dot), ".json") ||
+                name_eq(dot, strlen(dot), ".ndjson")))
+        return IMPORT_JSONL;
+    return IMPORT_CSV;
+}
+
+int import_patients(FILE* in, PatientList* list, const ImportOptions* opt,
+                    const ImportSink* sink, ImportStats* stats) {
+    ImportOptions defaults = import_default_options();
+    ImportStats local;
+    Importer im;
+    memset(&im, 0, sizeof im);
+    im.opt = opt ? opt : &defaults;
+    im.sink = sink;
+    im.stats = stats ? stats : &local;
+    im.list = list;
+    memset(im.stats, 0, sizeof *im.stats);
+
+    im.next_id = im.opt->next_id;
+    if (im.next_id <= 0) {
+        /* Ids gerados continuam depois do maior já cadastrado */
+        im.next_id = id_index_max(&list->id_index) + 1;
+        if (im.next_id <= 0) im.next_id = 1;
+    }
+
+    im.batch = malloc(IMPORT_BATCH * sizeof *im.batch);
+    im.codes = malloc(IMPORT_BATCH * sizeof *im.codes);
+    im.lines = malloc(IMPORT_BATCH * sizeof *im.lines);
+    im.errs = malloc(IMPORT_BATCH * sizeof *im.errs);
+    LineReader reader;
+    if (!im.batch || !im.codes || !im.lines || !im.errs || !line_reader_open(&reader, in, 0)) {
+        free_batch(&im);
+        return 0;
+    }
+
+    int header_done = im.opt->format == IMPORT_JSONL;
+    size_t len;
+    char* line;
+    while ((line = line_reader_next(&reader, &len)) != NULL) {
+        im.stats->bytes += len + 1;
+        if (reader.truncated) {
+            /* Entra no lote só para o erro sair na ordem das linhas */
+            queue_error(&im, reader.line_no, "linha longa demais");
+            if (im.pending == IMPORT_BATCH) flush_batch(&im);
+            continue;
+        }
+        if (*skip_ws(line) == '\0') continue;
+
+        if (!header_done) {
+            if (!parse_csv_header(&im, line)) {
+                if (sink && sink->on_error)
+                    sink->on_error(sink->ctx, reader.line_no, "cabeçalho CSV sem colunas nome/cpf");
+                line_reader_close(&reader);
+                free_batch(&im);
+                return 0;
+            }
+            header_done = 1;
+            continue;
+        }
+        parse_row(&im, line, reader.line_no);
+        if (im.pending == IMPORT_BATCH) flush_batch(&im);
+    }
+    flush_batch(&im);
+    line_reader_close(&reader);
+    free_batch(&im);
+    return 1;
+}
@@ -0,0 +1,77 @@
+#ifndef PATIENT_IMPORT_H
+#define PATIENT_IMPORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "ds/patient_list.h"
+
+/*
+  Importação em massa de pacientes (CSV ou JSONL) direto para a PatientList.
+
+  Streaming: o arquivo é lido em blocos de 1 MiB (LineReader) e cada linha
+  é parseada no próprio buffer; os campos são copiados uma única vez, já
+  no Patient de destino. A memória do parser não depende do tamanho do
+  arquivo.
+
+  As linhas são parseadas em lotes; cada lote passa por
+  patient_normalize_batch + patient_validate_batch (em paralelo no pool de
+  threads) e os registros entram por insert_patient na ordem do arquivo
+  (dedupe pelo índice de CPF). Linhas ruins são reportadas (on_error, em
+  ordem) e puladas; a importação continua.
+
+  CSV: primeira linha = cabeçalho; separador ',' ou ';' (detectado no
+  cabeçalho); campos podem vir entre aspas ("" escapa aspas). Colunas
+  reconhecidas (qualquer ordem, maiúsc./minúsc.):
+      id | name, nome | cpf | age, idade | gender, sexo |
+      condition, condicao, condição | priority, prioridade
+  JSONL: um objeto plano por linha com as mesmas chaves.
+
+  Layout do sistema antigo (clinic-manager.c/work.c: nome, idade, cpf,
+  prioridade "normal"/"urgente") é aceito: prioridade em texto é mapeada
+  (urgente/alta=1, media/média=2, normal/baixa=3), id ausente é gerado e
+  sexo ausente usa ImportOptions.default_gender.
+*/
+
+typedef enum {
+    IMPORT_CSV = 0,
+    IMPORT_JSONL = 1
+} ImportFormat;
+
+typedef struct {
+    ImportFormat format;
+    char default_gender; // sexo quando a coluna não existe/vem vazia (0 = obrigatório)
+    int next_id;         // primeiro id gerado quando falta id (0 => maior id atual + 1)
+} ImportOptions;
+
+typedef struct {
+    size_t rows;       // registros lidos (sem cabeçalho e linhas vazias)
+    size_t imported;   // inseridos no cadastro
+    size_t rejected;   // com erro (reportados em on_error)
+    size_t bytes;      // bytes consumidos do arquivo
+} ImportStats;
+
+/* Destino dos eventos da importação (callbacks opcionais). */
+typedef struct {
+    void* ctx;
+    /* linha: número da linha no arquivo (1-based) */
+    void (*on_error)(void* ctx, size_t line, const char* msg);
+    /* chamado após cada insert (ex.: registrar no WAL) */
+    void (*on_patient)(void* ctx, const Patient* p);
+} ImportSink;
+
+/* Opções padrão: CSV, sexo obrigatório, ids a partir do maior atual + 1. */
+ImportOptions import_default_options(void);
+
+/* Formato pela extensão: .jsonl/.json/.ndjson => JSONL, senão CSV. */
+ImportFormat import_format_from_path(const char* path);
+
+/*
+  Importa tudo de in para list.
+
+  Returns: 1 se o arquivo foi processado até o fim (mesmo com linhas
+  rejeitadas), 0 se não deu para ler (sem memória, cabeçalho CSV inválido).
+*/
+int import_patients(FILE* in, PatientList* list, const ImportOptions* opt,
+                    const ImportSink* sink, ImportStats* stats);
+
+#endif /* PATIENT_IMPORT_H */
@@ -85,7 +85,22 @@ int read_cpf_from_console(char* cpf, size_t cap) {
  * Evita acesso nulo verificando ponteiro antes.
  */
 void print_patient_line(const Patient* p) {
-    if (!p) { puts("(Patient=NULL)"); return; }
-    printf("ID: %d | Nome: %s | CPF: %s | Idade: %d | Prioridade: %d\n",
-           p->id, p->name, p->cpf, p->age, p->priority);
+    OutBuffer* out = out_stdout();
+    out_patient_line(out, p);
+    out_flush(out);
+}
+
+/*
+ * Formata a linha do paciente direto no buffer de saída
+ * ("ID: 1 | Nome: ... | CPF: ... | Idade: 30 | Prioridade: 2").
+ * As listagens chamam em laço e dão um único flush no final.
+ */
+void out_patient_line(OutBuffer* out, const Patient* p) {
+    if (!p) { out_str(out, "(Patient=NULL)\n"); return; }
+    out_str(out, "ID: ");           out_int(out, p->id);
+    out_str(out, " | Nome: ");      out_str(out, p->name);
+    out_str(out, " | CPF: ");       out_str(out, p->cpf);
+    out_str(out, " | Idade: ");     out_int(out, p->age);
+    out_str(out, " | Prioridade: "); out_int(out, p->priority);
+    out_char(out, '\n');
 }
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include "model/patient.h"
+#include "util/out_buffer.h"
 
 /* Lê um Patient do console (stdin). Retorna 1 se OK, 0 se erro/cancelado. */
 int read_patient_from_console(Patient* p);
@@ -13,4 +14,7 @@ int read_cpf_from_console(char* cpf, size_t cap);
 /* Imprime uma linha resumida do paciente. */
 void print_patient_line(const Patient* p);
 
+/* Mesma linha de print_patient_line, acumulada em out (sem flush). */
+void out_patient_line(OutBuffer* out, const Patient* p);
+
 #endif
@@ -0,0 +1,98 @@
+/*
+ Módulo: slab_pool.c
+ Papel:  Alocador de objetos de tamanho fixo por tipo de nó.
+
+ Como funciona:
+   - Um slab é um bloco único de malloc com cabeçalho + per_slab objetos.
+   - Objetos novos saem do slab atual por "bump" (ponteiro que avança).
+   - slab_pool_free encadeia o objeto numa free-list intrusiva (o próprio
+     objeto guarda o ponteiro para o próximo livre), então não há custo
+     extra de memória por objeto.
+   - slab_pool_destroy percorre só os slabs (poucos), não os objetos.
+*/
+
+#include <stdlib.h>
+#include <stddef.h>
+#include "slab_pool.h"
+
+/* Alvo de tamanho de cada slab: grande o bastante para amortizar o malloc. */
+#define SLAB_TARGET_BYTES (64u * 1024u)
+#define SLAB_MIN_OBJS     16u
+
+struct SlabChunk {
+    SlabChunk* next;
+    max_align_t align; /* garante alinhamento dos objetos que vêm depois */
+};
+
+/* Cabeçalho real do slab: objetos começam logo após o campo align. */
+#define SLAB_HEADER offsetof(SlabChunk, align)
+
+static size_t round_up(size_t n, size_t a) {
+    return (n + a - 1) / a * a;
+}
+
+void slab_pool_init(SlabPool* pool, size_t obj_size) {
+    if (!pool) return;
+    if (obj_size < sizeof(void*)) obj_size = sizeof(void*);
+    pool->obj_size = round_up(obj_size, _Alignof(max_align_t));
+    pool->per_slab = SLAB_TARGET_BYTES / pool->obj_size;
+    if (pool->per_slab < SLAB_MIN_OBJS) pool->per_slab = SLAB_MIN_OBJS;
+
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+    pool->bump = pool->bump_end = NULL;
+    pool->slab_count = 0;
+    pool->bytes_reserved = 0;
+    pool->allocs = 0;
+    pool->live = 0;
+}
+
+static int add_slab(SlabPool* pool) {
+    size_t bytes = SLAB_HEADER + pool->obj_size * pool->per_slab;
+    SlabChunk* slab = malloc(bytes);
+    if (!slab) return 0;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->bump = (char*)slab + SLAB_HEADER;
+    pool->bump_end = pool->bump + pool->obj_size * pool->per_slab;
+
+    pool->slab_count++;
+    pool->bytes_reserved += bytes;
+    return 1;
+}
+
+void* slab_pool_alloc(SlabPool* pool) {
+    void* obj;
+    if (!pool) return NULL;
+
+    if (pool->free_list) {
+        obj = pool->free_list;
+        pool->free_list = *(void**)obj;
+    } else {
+        if (pool->bump == pool->bump_end && !add_slab(pool)) return NULL;
+        obj = pool->bump;
+        pool->bump += pool->obj_size;
+    }
+    pool->allocs++;
+    pool->live++;
+    return obj;
+}
+
+void slab_pool_free(SlabPool* pool, void* obj) {
+    if (!pool || !obj) return;
+    *(void**)obj = pool->free_list;
+    pool->free_list = obj;
+    pool->live--;
+}
+
+void slab_pool_destroy(SlabPool* pool) {
+    if (!pool) return;
+    SlabChunk* slab = pool->slabs;
+    while (slab) {
+        SlabChunk* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    slab_pool_init(pool, pool->obj_size);
+}
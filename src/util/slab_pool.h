@@ -0,0 +1,44 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <stddef.h>  /* size_t */
+
+/*
+  Alocador de blocos de tamanho fixo ("slab").
+
+  Cada estrutura (lista, fila, histórico) tem o seu pool por tipo de nó.
+  Os nós são cortados de slabs grandes e contíguos (menos chamadas a malloc,
+  nós vizinhos na mesma linha de cache) e os liberados voltam para uma
+  free-list interna para reuso. slab_pool_destroy devolve tudo de uma vez.
+*/
+
+typedef struct SlabChunk SlabChunk; /* slab bruto (definido no .c) */
+
+typedef struct {
+    size_t obj_size;       // tamanho de cada objeto (já alinhado)
+    size_t per_slab;       // objetos por slab
+    SlabChunk* slabs;      // lista de slabs alocados
+    void* free_list;       // objetos liberados, prontos para reuso
+    char* bump;            // próximo objeto nunca usado do slab atual
+    char* bump_end;        // fim do slab atual
+
+    /* Estatísticas (para benchmarks/diagnóstico) */
+    size_t slab_count;     // slabs alocados (== chamadas a malloc)
+    size_t bytes_reserved; // bytes pedidos ao malloc
+    size_t allocs;         // total de slab_pool_alloc
+    size_t live;           // objetos em uso agora
+} SlabPool;
+
+/* Prepara o pool para objetos de obj_size bytes (não aloca nada ainda). */
+void slab_pool_init(SlabPool* pool, size_t obj_size);
+
+/* Retorna um objeto (não zerado) ou NULL se faltar memória. */
+void* slab_pool_alloc(SlabPool* pool);
+
+/* Devolve um objeto ao pool (NULL é ignorado). */
+void slab_pool_free(SlabPool* pool, void* obj);
+
+/* Libera TODOS os slabs de uma vez; o pool volta ao estado de init. */
+void slab_pool_destroy(SlabPool* pool);
+
+#endif /* SLAB_POOL_H */
@@ -0,0 +1,276 @@
+/*
+ Módulo: snapshot.c
+ Papel:  Persistência do estado em arquivo binário versionado.
+
+ Gravação: escreve tudo em "<path>.tmp", força para o disco (fsync) e só
+           então faz rename sobre o arquivo final. Um crash no meio deixa o
+           snapshot anterior intacto.
+ Leitura:  mapeia o arquivo com mmap (POSIX) e percorre os vetores de passo
+           fixo uma única vez reconstruindo lista + índice de CPF, fila e
+           pilha. No Windows (MSYS2) cai para leitura completa com fread.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "snapshot.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_WRITE_BUF (1u << 20)
+
+/* ---------- Arquivo somente leitura (mmap ou buffer) ---------- */
+
+typedef struct {
+    const unsigned char* data;
+    size_t size;
+    int mapped;   // 1 => munmap; 0 => free
+} MappedFile;
+
+static int map_file(const char* path, MappedFile* mf) {
+    mf->data = NULL;
+    mf->size = 0;
+    mf->mapped = 0;
+#if defined(_WIN32)
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    if (fseek(f, 0, SEEK_END) != 0) { fclose(f); return 0; }
+    long len = ftell(f);
+    rewind(f);
+    if (len <= 0) { fclose(f); return 0; }
+    unsigned char* buf = malloc((size_t)len);
+    if (!buf || fread(buf, 1, (size_t)len, f) != (size_t)len) {
+        free(buf);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+    mf->data = buf;
+    mf->size = (size_t)len;
+    return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { close(fd); return 0; }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); /* o mapeamento continua válido após fechar o descritor */
+    if (p == MAP_FAILED) return 0;
+#if defined(POSIX_MADV_SEQUENTIAL)
+    posix_madvise(p, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+    mf->data = p;
+    mf->size = (size_t)st.st_size;
+    mf->mapped = 1;
+    return 1;
+#endif
+}
+
+static void unmap_file(MappedFile* mf) {
+#if !defined(_WIN32)
+    if (mf->mapped) {
+        munmap((void*)mf->data, mf->size);
+        return;
+    }
+#endif
+    free((void*)mf->data);
+}
+
+/* Vetor [offset, offset + count*stride) cabe no arquivo? (sem overflow) */
+static int section_ok(const MappedFile* mf, uint64_t offset, uint64_t count, uint64_t stride) {
+    if (offset > mf->size) return 0;
+    if (count > (mf->size - offset) / stride) return 0;
+    return 1;
+}
+
+/* ---------- Gravação ---------- */
+
+static int flush_to_disk(FILE* f) {
+    if (fflush(f) != 0) return 0;
+#if defined(_WIN32)
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+SnapshotStatus snapshot_save(const char* path, const PatientList* list,
+                             const PatientQueue* queue, const HistoryStack* history,
+                             uint64_t wal_lsn) {
+    if (!path || !list || !queue || !history) return SNAP_ERR_IO;
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof h);
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof h.magic);
+    h.version = SNAPSHOT_VERSION;
+    h.endian_tag = SNAPSHOT_ENDIAN_TAG;
+    h.patient_size = (uint32_t)sizeof(Patient);
+    h.history_size = (uint32_t)sizeof(SnapshotHistoryRecord);
+    h.patient_count = list->size;
+    h.queue_count = queue->size;
+    h.history_count = history->size;
+    h.patient_offset = sizeof h;
+    h.queue_offset = h.patient_offset + h.patient_count * sizeof(Patient);
+    h.history_offset = h.queue_offset + h.queue_count * sizeof(SnapshotQueueRecord);
+    h.wal_lsn = wal_lsn;
+
+    size_t plen = strlen(path);
+    char* tmp = malloc(plen + 5);
+    if (!tmp) return SNAP_ERR_NOMEM;
+    memcpy(tmp, path, plen);
+    memcpy(tmp + plen, ".tmp", 5);
+
+    FILE* f = fopen(tmp, "wb");
+    if (!f) { free(tmp); return SNAP_ERR_IO; }
+    setvbuf(f, NULL, _IOFBF, SNAPSHOT_WRITE_BUF);
+
+    int ok = fwrite(&h, sizeof h, 1, f) == 1;
+    for (const Node* n = list->head; ok && n; n = n->next)
+        ok = fwrite(&n->data, sizeof(Patient), 1, f) == 1;
+    for (const QueueNode* n = queue_first(queue); ok && n; n = queue_next(queue, n)) {
+        SnapshotQueueRecord disk;
+        memset(&disk, 0, sizeof disk);
+        memcpy(disk.cpf, n->patient->cpf, sizeof n->patient->cpf);
+        ok = fwrite(&disk, sizeof disk, 1, f) == 1;
+    }
+    for (size_t i = 0; ok && i < history->size; i++) {
+        const HistoryRecord* rec = history_at(history, i);
+        SnapshotHistoryRecord disk;
+        memset(&disk, 0, sizeof disk);
+        disk.timestamp = rec->timestamp;
+        disk.action = (int32_t)rec->action;
+        disk.level = rec->level;
+        if (rec->patient) memcpy(disk.cpf, rec->patient->cpf, sizeof rec->patient->cpf);
+        ok = fwrite(&disk, sizeof disk, 1, f) == 1;
+    }
+    ok = ok && flush_to_disk(f);
+    ok = (fclose(f) == 0) && ok;
+
+#if defined(_WIN32)
+    /* rename do Windows não sobrescreve: remove o destino antes */
+    if (ok) remove(path);
+#endif
+    if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        free(tmp);
+        return SNAP_ERR_IO;
+    }
+    free(tmp);
+    return SNAP_OK;
+}
+
+/* ---------- Leitura ---------- */
+
+SnapshotStatus snapshot_load(const char* path, PatientList* list,
+                             PatientQueue* queue, HistoryStack* history,
+                             uint64_t* wal_lsn) {
+    if (!path || !list || !queue || !history) return SNAP_ERR_IO;
+
+    MappedFile mf;
+    if (!map_file(path, &mf)) return SNAP_ERR_IO;
+
+    SnapshotHeader h;
+    if (mf.size < sizeof h) { unmap_file(&mf); return SNAP_ERR_FORMAT; }
+    memcpy(&h, mf.data, sizeof h);
+
+    if (memcmp(h.magic, SNAPSHOT_MAGIC, sizeof h.magic) != 0 ||
+        h.version != SNAPSHOT_VERSION ||
+        h.endian_tag != SNAPSHOT_ENDIAN_TAG ||
+        h.patient_size != sizeof(Patient) ||
+        h.history_size != sizeof(SnapshotHistoryRecord) ||
+        !section_ok(&mf, h.patient_offset, h.patient_count, sizeof(Patient)) ||
+        !section_ok(&mf, h.queue_offset, h.queue_count, sizeof(SnapshotQueueRecord)) ||
+        !section_ok(&mf, h.history_offset, h.history_count, sizeof(SnapshotHistoryRecord))) {
+        unmap_file(&mf);
+        return SNAP_ERR_FORMAT;
+    }
+
+    /* Reconstrói em estruturas novas; só troca se tudo der certo */
+    PatientList new_list;
+    PatientQueue new_queue;
+    HistoryStack new_history;
+    init_patient_list(&new_list);
+    init_queue(&new_queue);
+    init_history_stack_bounded(&new_history, history->max_records);
+
+    SnapshotStatus st = SNAP_OK;
+    if (!reserve_patient_list(&new_list, (size_t)h.patient_count)) st = SNAP_ERR_NOMEM;
+    patient_list_defer_names(&new_list); /* trie de nomes só na primeira busca */
+
+    /* memcpy para um Patient local: o mmap não garante alinhamento do struct */
+    Patient p;
+    const unsigned char* base = mf.data + h.patient_offset;
+    /* insert_patient insere na cabeça: percorre de trás para frente */
+    for (uint64_t i = h.patient_count; st == SNAP_OK && i-- > 0;) {
+        memcpy(&p, base + i * sizeof(Patient), sizeof p);
+        if (!insert_patient(&new_list, &p)) st = SNAP_ERR_FORMAT; /* CPF repetido */
+    }
+
+    SnapshotQueueRecord qdisk;
+    base = mf.data + h.queue_offset;
+    for (uint64_t i = 0; st == SNAP_OK && i < h.queue_count; i++) {
+        memcpy(&qdisk, base + i * sizeof qdisk, sizeof qdisk);
+        qdisk.cpf[sizeof qdisk.cpf - 1] = '\0';
+        /* A fila aponta para o cadastro: CPF fora dele => arquivo inconsistente */
+        const Patient* qp = search_patient_by_CPF(&new_list, qdisk.cpf);
+        if (!qp) st = SNAP_ERR_FORMAT;
+        else if (!enqueue(&new_queue, qp)) st = SNAP_ERR_NOMEM;
+    }
+    queue_stats_reset(&new_queue); /* restaurados não contam como chegadas */
+
+    SnapshotHistoryRecord disk;
+    base = mf.data + h.history_offset;
+    /* Gravado do topo para a base: empilha da base para o topo */
+    for (uint64_t i = h.history_count; st == SNAP_OK && i-- > 0;) {
+        memcpy(&disk, base + i * sizeof disk, sizeof disk);
+        disk.cpf[sizeof disk.cpf - 1] = '\0';
+        HistoryRecord rec;
+        rec.timestamp = disk.timestamp;
+        rec.action = (HistoryAction)disk.action;
+        rec.level = (unsigned char)disk.level;
+        rec.enqueued_ns = 0; /* como a fila restaurada: chegada = agora */
+        rec.patient = search_patient_by_CPF(&new_list, disk.cpf); /* handle refeito */
+        if (!push_history(&new_history, rec)) st = SNAP_ERR_NOMEM;
+    }
+    unmap_file(&mf);
+
+    if (st != SNAP_OK) {
+        free_list(&new_list);
+        free_queue(&new_queue);
+        free_history(&new_history);
+        return st;
+    }
+
+    /* Política e relógio são configuração da fila, não conteúdo do arquivo */
+    new_queue.aging = queue->aging;
+    new_queue.clock = queue->clock;
+    free_list(list);
+    free_queue(queue);
+    free_history(history);
+    *list = new_list;
+    *queue = new_queue;
+    *history = new_history;
+    if (wal_lsn) *wal_lsn = h.wal_lsn;
+    return SNAP_OK;
+}
+
+const char* snapshot_strerror(SnapshotStatus st) {
+    switch (st) {
+        case SNAP_OK:         return "ok";
+        case SNAP_ERR_IO:     return "erro de E/S no arquivo de snapshot";
+        case SNAP_ERR_FORMAT: return "snapshot inválido ou incompatível";
+        case SNAP_ERR_NOMEM:  return "memória insuficiente";
+    }
+    return "erro desconhecido";
+}
@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+
+/*
+  Snapshot binário do estado (cadastro, fila e histórico).
+
+  Layout do arquivo (inteiros no formato nativo da máquina; endian_tag
+  detecta arquivo gerado em arquitetura diferente):
+    SnapshotHeader
+    Patient[patient_count]        cadastro, da cabeça para a cauda da lista
+    SnapshotQueueRecord[queue_count]      fila, na ordem de atendimento
+    SnapshotHistoryRecord[history_count]  histórico, do topo para a base
+
+  Registros com passo fixo (sizeof do struct) permitem carregar via mmap
+  e reconstruir os índices numa única passada.
+*/
+
+#define SNAPSHOT_MAGIC      "CLINSNAP"
+#define SNAPSHOT_VERSION    4u   /* v2: campo wal_lsn; v3: histórico compacto; v4: fila compacta */
+#define SNAPSHOT_ENDIAN_TAG 0x01020304u
+
+typedef struct {
+    char magic[8];            // "CLINSNAP" (sem '\0')
+    uint32_t version;         // SNAPSHOT_VERSION
+    uint32_t endian_tag;      // SNAPSHOT_ENDIAN_TAG
+    uint32_t patient_size;    // sizeof(Patient) de quem gravou
+    uint32_t history_size;    // sizeof(SnapshotHistoryRecord) de quem gravou
+    uint64_t patient_count;
+    uint64_t queue_count;
+    uint64_t history_count;
+    uint64_t patient_offset;  // offsets em bytes desde o início do arquivo
+    uint64_t queue_offset;
+    uint64_t history_offset;
+    uint64_t wal_lsn;         // último LSN do WAL já refletido neste snapshot
+} SnapshotHeader;
+
+/* Fila em disco: o handle para o cadastro vira o CPF, resolvido na carga. */
+typedef struct {
+    char cpf[16];
+} SnapshotQueueRecord;
+
+/* Histórico em disco: o handle (ponteiro) vira o CPF, resolvido na carga. */
+typedef struct {
+    int64_t timestamp;
+    int32_t action;
+    int32_t level;
+    char cpf[16];
+} SnapshotHistoryRecord;
+
+typedef enum {
+    SNAP_OK = 0,
+    SNAP_ERR_IO,        // falha ao abrir/ler/gravar/renomear
+    SNAP_ERR_FORMAT,    // magic/versão/tamanhos incompatíveis ou arquivo truncado
+    SNAP_ERR_NOMEM      // memória insuficiente para reconstruir as estruturas
+} SnapshotStatus;
+
+/* Grava o estado em path de forma atômica (path.tmp + fsync + rename).
+   wal_lsn: último registro do WAL já aplicado ao estado (0 sem WAL). */
+SnapshotStatus snapshot_save(const char* path, const PatientList* list,
+                             const PatientQueue* queue, const HistoryStack* history,
+                             uint64_t wal_lsn);
+
+/* Carrega path e SUBSTITUI o conteúdo das estruturas (já inicializadas).
+   Em caso de erro, as estruturas ficam como estavam.
+   wal_lsn (opcional) recebe o LSN gravado no snapshot. */
+SnapshotStatus snapshot_load(const char* path, PatientList* list,
+                             PatientQueue* queue, HistoryStack* history,
+                             uint64_t* wal_lsn);
+
+/* Mensagem curta para um status (para o controller exibir). */
+const char* snapshot_strerror(SnapshotStatus st);
+
+#endif /* SNAPSHOT_H */
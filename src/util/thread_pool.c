@@ -0,0 +1,183 @@
+/*
+ Módulo: thread_pool.c
+ Papel:  Threads fixas para dividir laços longos (parallel for).
+
+ Como funciona:
+   - Cada trabalho tem um número de geração; as threads dormem em work_cv
+     até a geração mudar, pegam pedaços por um contador atômico (sem lock
+     por pedaço) e a última a terminar acorda a chamadora (done_cv).
+   - A chamadora também pega pedaços, então um pool de N threads usa N + 1
+     núcleos e um pool vazio degrada para um laço comum.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include "thread_pool.h"
+
+#if !defined(_WIN32)
+#define THREAD_POOL_PTHREADS 1
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+struct ThreadPool {
+    unsigned n_threads;
+#if defined(THREAD_POOL_PTHREADS)
+    pthread_t* threads;
+    pthread_mutex_t mu;        // protege gen/stop/busy
+    pthread_mutex_t job_mu;    // um trabalho por vez
+    pthread_cond_t work_cv;
+    pthread_cond_t done_cv;
+    unsigned long gen;
+    int stop;
+    unsigned busy;             // auxiliares ainda no trabalho atual
+
+    /* Trabalho atual (escrito antes de gen++, sob mu) */
+    ParallelFn fn;
+    void* ctx;
+    size_t n, chunk, n_chunks;
+    atomic_size_t next;        // próximo pedaço livre
+#endif
+};
+
+#if defined(THREAD_POOL_PTHREADS)
+static void run_chunks(ThreadPool* pool) {
+    for (;;) {
+        size_t c = atomic_fetch_add(&pool->next, 1);
+        if (c >= pool->n_chunks) return;
+        size_t begin = c * pool->chunk;
+        size_t end = begin + pool->chunk < pool->n ? begin + pool->chunk : pool->n;
+        pool->fn(pool->ctx, begin, end);
+    }
+}
+
+static void* worker(void* arg) {
+    ThreadPool* pool = arg;
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool->mu);
+    for (;;) {
+        while (!pool->stop && pool->gen == seen) pthread_cond_wait(&pool->work_cv, &pool->mu);
+        if (pool->stop) break;
+        seen = pool->gen;
+        pthread_mutex_unlock(&pool->mu);
+
+        run_chunks(pool);
+
+        pthread_mutex_lock(&pool->mu);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->done_cv);
+    }
+    pthread_mutex_unlock(&pool->mu);
+    return NULL;
+}
+#endif
+
+ThreadPool* thread_pool_create(unsigned n_threads) {
+    ThreadPool* pool = calloc(1, sizeof *pool);
+    if (!pool) return NULL;
+#if defined(THREAD_POOL_PTHREADS)
+    pthread_mutex_init(&pool->mu, NULL);
+    pthread_mutex_init(&pool->job_mu, NULL);
+    pthread_cond_init(&pool->work_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    atomic_init(&pool->next, 0);
+    if (n_threads) {
+        pool->threads = malloc(n_threads * sizeof *pool->threads);
+        if (!pool->threads) n_threads = 0;
+    }
+    /* Se o sistema negar alguma thread, fica com as que conseguiu */
+    for (unsigned i = 0; i < n_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, worker, pool) != 0) break;
+        pool->n_threads++;
+    }
+#else
+    (void)n_threads;
+#endif
+    return pool;
+}
+
+#if defined(THREAD_POOL_PTHREADS)
+static ThreadPool* g_default;
+static pthread_once_t g_default_once = PTHREAD_ONCE_INIT;
+
+static void destroy_default(void) {
+    thread_pool_destroy(g_default);
+    g_default = NULL;
+}
+
+static void create_default(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (cpus > THREAD_POOL_MAX_DEFAULT) cpus = THREAD_POOL_MAX_DEFAULT;
+    g_default = thread_pool_create((unsigned)cpus - 1);
+    if (g_default) atexit(destroy_default);
+}
+#endif
+
+ThreadPool* thread_pool_default(void) {
+#if defined(THREAD_POOL_PTHREADS)
+    pthread_once(&g_default_once, create_default);
+    if (g_default) return g_default;
+#endif
+    static ThreadPool serial; /* sem threads: roda tudo na chamadora */
+    return &serial;
+}
+
+void thread_pool_parallel_for(ThreadPool* pool, size_t n, size_t min_chunk,
+                              ParallelFn fn, void* ctx) {
+    if (min_chunk == 0) min_chunk = 1;
+    if (!pool || pool->n_threads == 0 || n < 2 * min_chunk) {
+        if (n) fn(ctx, 0, n);
+        return;
+    }
+#if defined(THREAD_POOL_PTHREADS)
+    /* ~4 pedaços por participante equilibram pedaços lentos sem muito contador */
+    size_t width = (size_t)pool->n_threads + 1;
+    size_t chunk = (n + width * 4 - 1) / (width * 4);
+    if (chunk < min_chunk) chunk = min_chunk;
+
+    pthread_mutex_lock(&pool->job_mu);
+    pthread_mutex_lock(&pool->mu);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->n = n;
+    pool->chunk = chunk;
+    pool->n_chunks = (n + chunk - 1) / chunk;
+    atomic_store(&pool->next, 0);
+    pool->busy = pool->n_threads;
+    pool->gen++;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->mu);
+
+    run_chunks(pool);
+
+    pthread_mutex_lock(&pool->mu);
+    while (pool->busy) pthread_cond_wait(&pool->done_cv, &pool->mu);
+    pthread_mutex_unlock(&pool->mu);
+    pthread_mutex_unlock(&pool->job_mu);
+#endif
+}
+
+unsigned thread_pool_width(const ThreadPool* pool) {
+    return pool ? pool->n_threads + 1 : 1;
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) return;
+#if defined(THREAD_POOL_PTHREADS)
+    pthread_mutex_lock(&pool->mu);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_cv);
+    pthread_mutex_unlock(&pool->mu);
+    for (unsigned i = 0; i < pool->n_threads; i++) pthread_join(pool->threads[i], NULL);
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->mu);
+    pthread_mutex_destroy(&pool->job_mu);
+    pthread_cond_destroy(&pool->work_cv);
+    pthread_cond_destroy(&pool->done_cv);
+#endif
+    free(pool);
+}
@@ -0,0 +1,42 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>  /* size_t */
+
+/*
+  Pool pequeno de threads para laços "parallel for" (validação em lote etc.).
+
+  As threads são criadas uma vez e ficam dormindo numa variável de condição
+  entre os trabalhos. thread_pool_parallel_for divide [0, n) em pedaços de
+  pelo menos min_chunk itens; as threads do pool E a thread chamadora pegam
+  pedaços até acabar, e a chamada só retorna quando todos terminaram.
+
+  Sem pthreads (_WIN32) o pool tem 0 threads e tudo roda na chamadora.
+*/
+
+typedef void (*ParallelFn)(void* ctx, size_t begin, size_t end);
+
+typedef struct ThreadPool ThreadPool; /* definido no .c */
+
+/* Cria um pool com n_threads auxiliares (0 => só a chamadora).
+   Returns: pool ou NULL se faltar memória/threads. */
+ThreadPool* thread_pool_create(unsigned n_threads);
+
+/* Pool compartilhado do processo (criado no primeiro uso; uma thread por
+   núcleo, até THREAD_POOL_MAX_DEFAULT contando a chamadora). Nunca NULL. */
+ThreadPool* thread_pool_default(void);
+
+#define THREAD_POOL_MAX_DEFAULT 8
+
+/* Roda fn(ctx, begin, end) sobre [0, n) em paralelo. Com pool NULL ou n
+   pequeno (< 2 * min_chunk), roda direto na chamadora. Chamadas
+   concorrentes no mesmo pool são serializadas. */
+void thread_pool_parallel_for(ThreadPool* pool, size_t n, size_t min_chunk,
+                              ParallelFn fn, void* ctx);
+
+/* Threads que participam de um trabalho (auxiliares + chamadora). */
+unsigned thread_pool_width(const ThreadPool* pool);
+
+void thread_pool_destroy(ThreadPool* pool);
+
+#endif /* THREAD_POOL_H */
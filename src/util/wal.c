@@ -0,0 +1,427 @@
+/*
+ Módulo: wal.c
+ Papel:  Log de escrita antecipada (append-only) para não perder o dia de
+         atendimentos num crash. Junto com o snapshot: ao iniciar, carrega o
+         snapshot e reaplica aqui os registros com LSN maior que o dele.
+
+ Group commit (processo single-thread):
+   - wal_log_* só serializa o registro no buffer em memória;
+   - se a janela (group_window_ms) do registro pendente mais antigo já
+     passou, ou o buffer passou de group_max_bytes, faz UM write + UM fsync
+     para todos os pendentes;
+   - o controller chama wal_sync antes de ficar ocioso (ex.: esperar o
+     usuário) para não deixar nada pendente por tempo indeterminado.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "wal.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define WAL_MAGIC       "CLINWAL"   /* 7 chars + '\0' = 8 bytes no arquivo */
+#define WAL_VERSION     2u          /* v2: histórico compacto (epoch + nível) */
+#define WAL_ENDIAN_TAG  0x01020304u
+#define WAL_FILE_HEADER 16u
+#define WAL_REC_HEADER  13u         /* u32 len + u8 type + u64 lsn */
+#define WAL_REC_TRAILER 4u          /* u32 checksum */
+#define WAL_MAX_PAYLOAD 1024u
+
+/* ---------- utilidades ---------- */
+
+static double mono_now(void) {
+    struct timespec ts;
+#if defined(_WIN32)
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint32_t checksum(const unsigned char* data, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static int file_sync(FILE* f) {
+    if (fflush(f) != 0) return 0;
+#if defined(_WIN32)
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+static int file_truncate(FILE* f, long size) {
+    if (fflush(f) != 0) return 0;
+#if defined(_WIN32)
+    return _chsize(_fileno(f), size) == 0;
+#else
+    return ftruncate(fileno(f), (off_t)size) == 0;
+#endif
+}
+
+/* Serializador simples de payload (campos nativos + strings com u8 de tamanho). */
+typedef struct {
+    unsigned char data[WAL_MAX_PAYLOAD];
+    size_t len;
+} Payload;
+
+static void put_bytes(Payload* pl, const void* src, size_t n) {
+    memcpy(pl->data + pl->len, src, n);
+    pl->len += n;
+}
+
+static void put_i32(Payload* pl, int32_t v) { put_bytes(pl, &v, sizeof v); }
+static void put_i64(Payload* pl, int64_t v) { put_bytes(pl, &v, sizeof v); }
+
+static void put_str(Payload* pl, const char* s, size_t cap) {
+    size_t n = strnlen(s, cap - 1);
+    unsigned char n8 = (unsigned char)n;
+    put_bytes(pl, &n8, 1);
+    put_bytes(pl, s, n);
+}
+
+/* Leitor do payload: retorna 0 se os dados acabarem antes do esperado. */
+typedef struct {
+    const unsigned char* p;
+    size_t left;
+} Cursor;
+
+static int get_bytes(Cursor* c, void* dst, size_t n) {
+    if (c->left < n) return 0;
+    memcpy(dst, c->p, n);
+    c->p += n;
+    c->left -= n;
+    return 1;
+}
+
+static int get_i32(Cursor* c, int32_t* v) { return get_bytes(c, v, sizeof *v); }
+static int get_i64(Cursor* c, int64_t* v) { return get_bytes(c, v, sizeof *v); }
+
+static int get_str(Cursor* c, char* dst, size_t cap) {
+    unsigned char n8;
+    if (!get_bytes(c, &n8, 1) || n8 >= cap) return 0;
+    if (!get_bytes(c, dst, n8)) return 0;
+    dst[n8] = '\0';
+    return 1;
+}
+
+/* ---------- escrita ---------- */
+
+WalConfig wal_default_config(void) {
+    WalConfig cfg;
+    cfg.group_window_ms = 5;
+    cfg.group_max_bytes = 256u * 1024u;
+    return cfg;
+}
+
+void wal_init_disabled(Wal* w) {
+    memset(w, 0, sizeof *w);
+    w->next_lsn = 1;
+}
+
+int wal_open(Wal* w, const char* path, WalConfig cfg, uint64_t next_lsn) {
+    wal_init_disabled(w);
+    if (!path) return 0;
+    if (cfg.group_max_bytes < WAL_MAX_PAYLOAD * 2) cfg.group_max_bytes = WAL_MAX_PAYLOAD * 2;
+
+    w->buf = malloc(cfg.group_max_bytes + WAL_REC_HEADER + WAL_MAX_PAYLOAD + WAL_REC_TRAILER);
+    if (!w->buf) return 0;
+    w->f = fopen(path, "ab");
+    if (!w->f) { free(w->buf); w->buf = NULL; return 0; }
+    setvbuf(w->f, NULL, _IONBF, 0); /* o buffer é o nosso (group commit) */
+
+    w->cfg = cfg;
+    w->cap = cfg.group_max_bytes;
+    w->next_lsn = next_lsn ? next_lsn : 1;
+
+    if (fseek(w->f, 0, SEEK_END) == 0 && ftell(w->f) == 0) {
+        unsigned char hdr[WAL_FILE_HEADER];
+        uint32_t v = WAL_VERSION, tag = WAL_ENDIAN_TAG;
+        memset(hdr, 0, sizeof hdr);
+        memcpy(hdr, WAL_MAGIC, sizeof WAL_MAGIC);
+        memcpy(hdr + 8, &v, 4);
+        memcpy(hdr + 12, &tag, 4);
+        if (fwrite(hdr, 1, sizeof hdr, w->f) != sizeof hdr || !file_sync(w->f)) {
+            wal_close(w);
+            return 0;
+        }
+    }
+    w->durable_end = ftell(w->f);
+    if (w->durable_end < 0) {
+        wal_close(w);
+        return 0;
+    }
+    return 1;
+}
+
+int wal_sync(Wal* w) {
+    if (!w || !w->f || w->len == 0) return 1;
+    w->syncs++;
+    if (fwrite(w->buf, 1, w->len, w->f) != w->len || !file_sync(w->f)) {
+        /* Um write curto deixaria um registro rasgado no MEIO do arquivo (o
+           replay cortaria tudo o que viesse depois): volta ao último fim
+           durável e mantém os pendentes para a próxima tentativa */
+        clearerr(w->f);
+        file_truncate(w->f, w->durable_end);
+        return 0;
+    }
+    w->durable_end += (long)w->len;
+    w->len = 0;
+    return 1;
+}
+
+static int append(Wal* w, WalRecordType type, const Payload* pl) {
+    if (!w || !w->f) return 1; /* WAL desligado */
+    if (w->broken) return 0;
+
+    /* Buffer cheio de pendentes que não foram para o disco: sem espaço para
+       este registro. Perder só ele abriria um buraco no log, então o WAL
+       para de aceitar registros até o próximo checkpoint */
+    if (w->len >= w->cap && !wal_sync(w)) {
+        w->broken = 1;
+        return 0;
+    }
+
+    unsigned char* rec = w->buf + w->len;
+    uint32_t n = (uint32_t)pl->len;
+    uint8_t t = (uint8_t)type;
+    uint64_t lsn = w->next_lsn++;
+    memcpy(rec, &n, 4);
+    memcpy(rec + 4, &t, 1);
+    memcpy(rec + 5, &lsn, 8);
+    memcpy(rec + WAL_REC_HEADER, pl->data, pl->len);
+    uint32_t sum = checksum(rec + 4, WAL_REC_HEADER - 4 + pl->len);
+    memcpy(rec + WAL_REC_HEADER + pl->len, &sum, 4);
+
+    double now = mono_now();
+    if (w->len == 0) w->pending_since = now;
+    w->len += WAL_REC_HEADER + pl->len + WAL_REC_TRAILER;
+
+    if (w->cfg.group_window_ms == 0 || w->len >= w->cap ||
+        (now - w->pending_since) * 1000.0 >= (double)w->cfg.group_window_ms)
+        return wal_sync(w);
+    return 1;
+}
+
+int wal_reset(Wal* w) {
+    if (!w || !w->f) return 1;
+    /* Pendentes já estão no snapshot recém-gravado: podem ser descartados */
+    w->len = 0;
+    if (!file_truncate(w->f, WAL_FILE_HEADER) || !file_sync(w->f)) return 0;
+    w->durable_end = WAL_FILE_HEADER;
+    w->broken = 0;
+    return 1;
+}
+
+void wal_close(Wal* w) {
+    if (!w) return;
+    if (w->f) {
+        wal_sync(w);
+        fclose(w->f);
+    }
+    free(w->buf);
+    uint64_t lsn = w->next_lsn;
+    wal_init_disabled(w);
+    w->next_lsn = lsn;
+}
+
+int wal_log_register(Wal* w, const Patient* p) {
+    Payload pl;
+    pl.len = 0;
+    put_i32(&pl, p->id);
+    put_i32(&pl, p->age);
+    put_i32(&pl, p->priority);
+    put_bytes(&pl, &p->gender, 1);
+    put_str(&pl, p->name, sizeof p->name);
+    put_str(&pl, p->cpf, sizeof p->cpf);
+    put_str(&pl, p->condition, sizeof p->condition);
+    return append(w, WAL_REGISTER, &pl);
+}
+
+int wal_log_enqueue(Wal* w, const char* cpf) {
+    Payload pl;
+    pl.len = 0;
+    put_str(&pl, cpf, sizeof(((Patient*)0)->cpf));
+    return append(w, WAL_ENQUEUE, &pl);
+}
+
+int wal_log_dequeue(Wal* w, int level) {
+    Payload pl;
+    pl.len = 0;
+    /* Com envelhecimento a escolha depende do relógio: o replay repete o nível */
+    unsigned char lv = (unsigned char)level;
+    put_bytes(&pl, &lv, 1);
+    return append(w, WAL_DEQUEUE, &pl);
+}
+
+int wal_log_history_push(Wal* w, const HistoryRecord* rec) {
+    Payload pl;
+    pl.len = 0;
+    put_i64(&pl, rec->timestamp);
+    put_i32(&pl, (int32_t)rec->action);
+    put_bytes(&pl, &rec->level, 1);
+    put_str(&pl, rec->patient ? rec->patient->cpf : "", sizeof rec->patient->cpf);
+    /* enqueued_ns fica de fora: relógio monotônico não vale em outro processo */
+    return append(w, WAL_HISTORY_PUSH, &pl);
+}
+
+int wal_log_history_pop(Wal* w) {
+    Payload pl;
+    pl.len = 0;
+    return append(w, WAL_HISTORY_POP, &pl);
+}
+
+int wal_log_undo(Wal* w) {
+    Payload pl;
+    pl.len = 0;
+    return append(w, WAL_UNDO, &pl);
+}
+
+int wal_log_cancel(Wal* w, const char* cpf) {
+    Payload pl;
+    pl.len = 0;
+    put_str(&pl, cpf, sizeof(((Patient*)0)->cpf));
+    return append(w, WAL_CANCEL, &pl);
+}
+
+/* ---------- replay ---------- */
+
+static int apply(WalRecordType type, Cursor* c,
+                 PatientList* list, PatientQueue* queue, HistoryStack* history) {
+    switch (type) {
+        case WAL_REGISTER: {
+            Patient p;
+            int32_t id, age, prio;
+            memset(&p, 0, sizeof p);
+            if (!get_i32(c, &id) || !get_i32(c, &age) || !get_i32(c, &prio) ||
+                !get_bytes(c, &p.gender, 1) ||
+                !get_str(c, p.name, sizeof p.name) ||
+                !get_str(c, p.cpf, sizeof p.cpf) ||
+                !get_str(c, p.condition, sizeof p.condition))
+                return 0;
+            p.id = id; p.age = age; p.priority = prio;
+            /* duplicado => já estava no snapshot; fora isso, falta de memória */
+            return insert_patient(list, &p) || search_patient_by_CPF(list, p.cpf);
+        }
+        case WAL_ENQUEUE: {
+            char cpf[15];
+            if (!get_str(c, cpf, sizeof cpf)) return 0;
+            const Patient* p = search_patient_by_CPF(list, cpf);
+            return !p || enqueue(queue, p);
+        }
+        case WAL_DEQUEUE: {
+            unsigned char lv;
+            if (get_bytes(c, &lv, 1)) dequeue_level(queue, lv);
+            else                      dequeue(queue); /* registro antigo, sem nível */
+            return 1;
+        }
+        case WAL_HISTORY_PUSH: {
+            HistoryRecord rec;
+            int32_t action;
+            char cpf[15];
+            if (!get_i64(c, &rec.timestamp) || !get_i32(c, &action) ||
+                !get_bytes(c, &rec.level, 1) ||
+                !get_str(c, cpf, sizeof cpf))
+                return 0;
+            rec.action = (HistoryAction)action;
+            /* Chegada desconhecida (undo => chegada agora), como no snapshot e
+               na fila reaplicada; bytes a mais depois do CPF são ignorados */
+            rec.enqueued_ns = 0;
+            /* Handle refeito a partir do cadastro (o log guarda só a chave) */
+            rec.patient = search_patient_by_CPF(list, cpf);
+            return push_history(history, rec);
+        }
+        case WAL_HISTORY_POP:
+            pop_history(history, NULL);
+            return 1;
+        case WAL_UNDO:
+            return undo_last_service(history, queue, NULL) != UNDO_NOMEM;
+        case WAL_CANCEL: {
+            char cpf[15];
+            if (!get_str(c, cpf, sizeof cpf)) return 0;
+            queue_remove_cpf(queue, cpf);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int wal_replay(const char* path, uint64_t after_lsn,
+               PatientList* list, PatientQueue* queue, HistoryStack* history,
+               uint64_t* last_lsn, size_t* applied) {
+    if (last_lsn) *last_lsn = after_lsn;
+    if (applied) *applied = 0;
+
+    FILE* f = fopen(path, "r+b");
+    if (!f) return 1; /* sem WAL ainda: nada a reaplicar */
+
+    unsigned char hdr[WAL_FILE_HEADER];
+    size_t got = fread(hdr, 1, sizeof hdr, f);
+    if (got == 0) { fclose(f); return 1; } /* arquivo vazio */
+    uint32_t v, tag;
+    memcpy(&v, hdr + 8, 4);
+    memcpy(&tag, hdr + 12, 4);
+    if (got != sizeof hdr || memcmp(hdr, WAL_MAGIC, sizeof WAL_MAGIC) != 0 ||
+        v != WAL_VERSION || tag != WAL_ENDIAN_TAG) {
+        fclose(f);
+        return 0;
+    }
+
+    unsigned char rec[WAL_REC_HEADER + WAL_MAX_PAYLOAD + WAL_REC_TRAILER];
+    long good_end = WAL_FILE_HEADER;
+    uint64_t max_lsn = after_lsn;
+    size_t count = 0;
+    int torn = 0, failed = 0;
+
+    for (;;) {
+        got = fread(rec, 1, WAL_REC_HEADER, f);
+        if (got == 0) break;                       /* fim limpo */
+        uint32_t n;
+        memcpy(&n, rec, 4);
+        if (got != WAL_REC_HEADER || n > WAL_MAX_PAYLOAD ||
+            fread(rec + WAL_REC_HEADER, 1, n + WAL_REC_TRAILER, f) != n + WAL_REC_TRAILER) {
+            torn = 1;
+            break;
+        }
+        uint32_t sum;
+        memcpy(&sum, rec + WAL_REC_HEADER + n, 4);
+        if (sum != checksum(rec + 4, WAL_REC_HEADER - 4 + n)) { torn = 1; break; }
+
+        uint8_t t;
+        uint64_t lsn;
+        memcpy(&t, rec + 4, 1);
+        memcpy(&lsn, rec + 5, 8);
+        if (lsn > after_lsn) {
+            Cursor c = { rec + WAL_REC_HEADER, n };
+            /* Registro íntegro que não aplica não é cauda rasgada: cortar aqui
+               apagaria os registros válidos seguintes */
+            if (!apply((WalRecordType)t, &c, list, queue, history)) { failed = 1; break; }
+            count++;
+        }
+        if (lsn > max_lsn) max_lsn = lsn;
+        good_end += (long)(WAL_REC_HEADER + n + WAL_REC_TRAILER);
+    }
+
+    /* Cauda incompleta (crash no meio do write): corta para o próximo append */
+    int ok = !failed && (!torn || file_truncate(f, good_end));
+    fclose(f);
+    if (last_lsn) *last_lsn = max_lsn;
+    if (applied) *applied = count;
+    return ok;
+}
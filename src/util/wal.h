@@ -0,0 +1,104 @@
+#ifndef WAL_H
+#define WAL_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "ds/patient_list.h"
+#include "ds/patient_queue.h"
+#include "ds/history_stack.h"
+
+/*
+  Write-ahead log (WAL) das mutações de cadastro, fila e histórico.
+
+  Arquivo: cabeçalho fixo + registros binários compactos, só por append:
+    [u32 tamanho do payload][u8 tipo][u64 lsn][payload][u32 checksum]
+  Strings vão com prefixo de tamanho (u8), sem os bytes não usados dos
+  campos fixos do Patient.
+
+  Group commit: os registros ficam num buffer em memória e vão para o disco
+  (um write + um fsync) quando a janela de latência expira, quando o buffer
+  enche ou em wal_sync. Janela 0 => fsync a cada registro.
+
+  Falha no write/fsync: o arquivo volta ao fim do último sync bem-sucedido
+  (nada de registro pela metade no meio) e os pendentes ficam no buffer
+  para a próxima tentativa. Se o buffer encher sem conseguir gravar, o WAL
+  fica "quebrado": os próximos registros são recusados (o arquivo continua
+  um prefixo válido) até um checkpoint (wal_reset).
+*/
+
+typedef enum {
+    WAL_REGISTER = 1,    // insert_patient (payload: Patient compacto)
+    WAL_ENQUEUE = 2,     // enqueue        (payload: CPF)
+    WAL_DEQUEUE = 3,     // dequeue        (payload: nível atendido; vazio => ordem estrita)
+    WAL_HISTORY_PUSH = 4,// push_history   (payload: timestamp, ação, nível, CPF)
+    WAL_HISTORY_POP = 5, // pop_history    (sem payload)
+    WAL_UNDO = 6,        // pop_history + enqueue_front (sem payload)
+    WAL_CANCEL = 7       // queue_remove_cpf (payload: CPF)
+} WalRecordType;
+
+typedef struct {
+    unsigned group_window_ms;  // atraso máximo até o fsync (0 = fsync a cada registro)
+    size_t group_max_bytes;    // buffer pendente máximo antes de forçar o fsync
+} WalConfig;
+
+typedef struct {
+    FILE* f;              // NULL => WAL desligado (todas as funções viram no-op)
+    WalConfig cfg;
+    unsigned char* buf;   // registros pendentes (ainda não duráveis)
+    size_t len;
+    size_t cap;
+    uint64_t next_lsn;    // LSN do próximo registro
+    double pending_since; // instante (s) do registro pendente mais antigo
+    size_t syncs;         // fsyncs feitos (estatística)
+    long durable_end;     // fim do último registro já no disco
+    int broken;           // registro perdido: recusa novos até wal_reset
+} Wal;
+
+/* Configuração padrão: janela de 5 ms, 256 KiB de buffer. */
+WalConfig wal_default_config(void);
+
+/* Deixa o WAL desligado (f == NULL). */
+void wal_init_disabled(Wal* w);
+
+/* Abre (ou cria) path para append. next_lsn vem do replay/snapshot.
+   Returns: 1 ok, 0 erro de E/S ou memória. */
+int wal_open(Wal* w, const char* path, WalConfig cfg, uint64_t next_lsn);
+
+/* Força os pendentes para o disco (write + fsync). Returns: 1 ok, 0 erro
+   (pendentes mantidos no buffer; o arquivo volta a durable_end). */
+int wal_sync(Wal* w);
+
+/* Checkpoint: depois de um snapshot durável, esvazia o arquivo (e tira o
+   estado "quebrado": o snapshot já tem tudo). */
+int wal_reset(Wal* w);
+
+/* Sincroniza e fecha. */
+void wal_close(Wal* w);
+
+/* Registra uma mutação já aplicada em memória. Returns: 1 ok, 0 erro
+   (E/S no group commit ou WAL quebrado: a mutação pode não estar no log). */
+int wal_log_register(Wal* w, const Patient* p);
+int wal_log_enqueue(Wal* w, const char* cpf);
+int wal_log_dequeue(Wal* w, int level);
+int wal_log_history_push(Wal* w, const HistoryRecord* rec);
+int wal_log_history_pop(Wal* w);
+int wal_log_undo(Wal* w);
+int wal_log_cancel(Wal* w, const char* cpf);
+
+/*
+  Reaplica em memória os registros de path com lsn > after_lsn.
+  Um registro incompleto ou com checksum errado (crash no meio do write)
+  encerra o replay e é cortado do arquivo junto com o que vier depois.
+  Um registro íntegro que não dá para aplicar (tipo desconhecido, payload
+  malformado, falta de memória) interrompe o replay com erro, sem cortar.
+
+  Returns: 1 ok (inclusive arquivo inexistente), 0 erro de E/S/formato/aplicação.
+  *last_lsn recebe o maior LSN visto (ou after_lsn); *applied, quantos
+  registros foram aplicados (ambos opcionais).
+*/
+int wal_replay(const char* path, uint64_t after_lsn,
+               PatientList* list, PatientQueue* queue, HistoryStack* history,
+               uint64_t* last_lsn, size_t* applied);
+
+#endif /* WAL_H */
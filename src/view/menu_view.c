@@ -23,6 +23,7 @@ void show_main_menu(void) {
     puts("1) Cadastro de Pacientes (Lista)");
     puts("2) Fila de Atendimento   (Fila)");
     puts("3) Histórico             (Pilha)");
+    puts("4) Salvar estado         (Snapshot)");
     puts("9) Sair");
     puts(" ");
 }
@@ -32,7 +33,10 @@ void show_patient_menu(void) {
     puts("1) Inserir novo paciente");
     puts("2) Listar todos os pacientes");
     puts("3) Buscar paciente por CPF");
-    // puts("4) Remover paciente do sistema");
+    puts("4) Importar arquivo (CSV/JSONL)");
+    puts("5) Buscar por ID (ou faixa de IDs)");
+    puts("6) Buscar por nome (início do nome ou sobrenome)");
+    // puts("7) Remover paciente do sistema");
     puts("9) Voltar");
     puts(" ");
 }
@@ -42,7 +46,9 @@ void show_queue_menu(void) {
     puts("1) Adicionar paciente à fila");
     puts("2) Chamar próximo paciente");
     puts("3) Visualizar estado da fila de atendimento");
-    // puts("4) Remover paciente da fila de atendimento");
+    puts("4) Remover paciente da fila de atendimento");
+    puts("5) Consultar posição na fila");
+    puts("6) Tempos de espera (p50/p90/p99) e chegadas/atendimentos");
     puts("9) Voltar");
     puts(" ");
 }